@@ -129,6 +129,63 @@ static void bench_integrate(benchmark::State& state) {
 }
 
 
+// ------------------------- Set Intersection ---------------------------
+
+// The hand-rolled intersection size of two sorted sequences from the
+// triangle counting example, for comparison with set_intersection_size.
+// Runs in O(m log (1+n/m)) time where m is length of the smaller
+// and n length of the larger.
+template <typename Slice>
+long intersect_size(Slice a, Slice b) {
+  if (a.size() == 0 || b.size() == 0) return 0;
+  if (a.size() > b.size()) return intersect_size(b,a);
+  if (b.size() < 16 * a.size()) {
+    long count = 0;
+    auto ai = a.begin(); auto ae = a.end();
+    auto bi = b.begin(); auto be = b.end();
+    while (ai < ae && bi < be) {
+      if (*ai == *bi) ai++, bi++, count++;
+      else if (*ai < *bi) ai++;
+      else bi++;
+    }
+    return count;
+  }
+  long ma = a.size()/2;
+  auto mb = std::lower_bound(b.begin(), b.end(), a[ma]) - b.begin();
+  int match = (mb < b.size() && b[mb] == a[ma]);
+  return (match +
+          intersect_size(a.cut(0, ma), b.cut(0, mb)) +
+          intersect_size(a.cut(ma + 1, a.size()),
+                         b.cut(mb + match, b.size())));
+}
+
+// Sorted sequences of n and n/ratio distinct random keys, which share
+// about half of the keys of the smaller one
+static auto set_intersection_inputs(size_t n, size_t ratio) {
+  auto a = parlay::sort(parlay::remove_duplicates(parlay::tabulate(n, [&] (size_t i) {
+    return static_cast<long>(parlay::hash64(i) % (4 * n)); })));
+  auto b = parlay::sort(parlay::remove_duplicates(parlay::tabulate(n / ratio, [&] (size_t i) {
+    return static_cast<long>(parlay::hash64(i % 2 == 0 ? i * ratio : n + i) % (4 * n)); })));
+  return std::make_pair(std::move(a), std::move(b));
+}
+
+static void bench_intersect_size(benchmark::State& state) {
+  auto [a, b] = set_intersection_inputs(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    intersect_size(parlay::make_slice(a), parlay::make_slice(b));
+  }
+}
+
+static void bench_set_intersection_size(benchmark::State& state) {
+  auto [a, b] = set_intersection_inputs(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    parlay::set_intersection_size(a, b);
+  }
+}
+
+
 // ------------------------- Registration -------------------------------
 
 #define BENCH(NAME, N) BENCHMARK(bench_ ## NAME)->UseRealTime()->Unit(benchmark::kMillisecond)->Arg(N);
@@ -138,3 +195,11 @@ BENCH(prime_sieve, 10000000);
 BENCH(mcss, 100000000);
 BENCH(integrate, 100000000);
 
+// Sets of 10^7 and 10^7/ratio elements, for ratios 1 and 1000
+#define BENCH_SET(NAME, N, RATIO) BENCHMARK(bench_ ## NAME)->UseRealTime()->Unit(benchmark::kMillisecond)->Args({N, RATIO});
+
+BENCH_SET(intersect_size, 10000000, 1);
+BENCH_SET(set_intersection_size, 10000000, 1);
+BENCH_SET(intersect_size, 10000000, 1000);
+BENCH_SET(set_intersection_size, 10000000, 1000);
+
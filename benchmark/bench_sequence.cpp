@@ -37,6 +37,23 @@ static void bench_grow_int64(benchmark::State& state) {
   }
 }
 
+// Grow a sequence to state.range(0) elements by repeatedly appending blocks
+// of 2^20 elements. Once the sequence is larger than the largest pool of the
+// allocator, growth can be performed without copying on platforms with mremap.
+static void bench_append_huge_int64(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t block_size = 1 << 20;
+  auto block = parlay::sequence<int64_t>(block_size, 1);
+  for (auto _ : state) {
+    parlay::sequence<int64_t> s;
+    while (s.size() < n) {
+      s.append(block);
+    }
+    benchmark::DoNotOptimize(s.data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * sizeof(int64_t));
+}
+
 // No annotation needed since this one should be detectable
 struct Relocatable {
   std::unique_ptr<int> x;
@@ -93,3 +110,10 @@ BENCH(short_subscript);
 BENCH(grow_int64);
 BENCH(grow_relocatable);
 BENCH(grow_nonrelocatable);
+
+// Up to 32 GiB. Sizes larger than the available memory will fail.
+BENCHMARK(bench_append_huge_int64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond)
+    ->RangeMultiplier(8)
+    ->Range(size_t{1} << 26, size_t{1} << 32);
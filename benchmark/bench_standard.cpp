@@ -4,14 +4,28 @@
 
 #include <benchmark/benchmark.h>
 
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include <parlay/bit_sequence.h>
+#include <parlay/compressed_sequence.h>
+#include <parlay/concurrent_vector.h>
+#include <parlay/file_allocator.h>
 #include <parlay/monoid.h>
 #include <parlay/portability.h>
 #include <parlay/primitives.h>
 #include <parlay/random.h>
+#include <parlay/soa_sequence.h>
 #include <parlay/io.h>
 
 #include "trigram_words.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
 using benchmark::Counter;
 
 // Use this macro to avoid accidentally timing the destructors
@@ -49,6 +63,36 @@ using benchmark::Counter;
   state.counters["    Elements/sec"] = Counter(state.iterations()*(n), Counter::kIsRate);                                            \
   state.counters["       Bytes/sec"] = Counter(state.iterations()*(n)*(sizeof(T)), Counter::kIsRate);
 
+// The number of bytes read plus written per second by a parallel memcpy
+// of a buffer much larger than the last-level cache, measured once, as a
+// reference for how close a memory-bound benchmark is to the hardware limit
+static double memory_bandwidth() {
+  static const double bandwidth = [] {
+    size_t n = size_t{1} << 28, block_size = size_t{1} << 20;
+    auto from = parlay::sequence<char>(n, 1), to = parlay::sequence<char>(n, 0);
+    double best = 0;
+    for (int r = 0; r < 3; r++) {
+      auto start = std::chrono::steady_clock::now();
+      parlay::parallel_for(0, n / block_size, [&] (size_t i) {
+        std::memcpy(to.data() + i * block_size, from.data() + i * block_size, block_size);
+      }, 1);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = (std::max)(best, 2.0 * n / elapsed.count());
+    }
+    return best;
+  }();
+  return bandwidth;
+}
+
+// Report the bandwidth used by the benchmark as a percentage of memory_bandwidth()
+//
+// Arguments:
+//  n:             The number of elements processed
+//  bytes:         The number of bytes read and written per element processed
+//
+#define REPORT_MEMORY_BANDWIDTH(n, bytes)                                                                                        \
+  state.counters["   % of memcpy bw"] = Counter(state.iterations()*(n)*(bytes) * 100.0 / memory_bandwidth(), Counter::kIsRate);
+
 
 template<typename T>
 static void bench_map(benchmark::State& state) {
@@ -85,6 +129,7 @@ static void bench_reduce_add(benchmark::State& state) {
   }
 
   REPORT_STATS(n, sizeof(T), 0);
+  REPORT_MEMORY_BANDWIDTH(n, sizeof(T));
 }
 
 template<typename T>
@@ -97,6 +142,66 @@ static void bench_scan_add(benchmark::State& state) {
   }
 
   REPORT_STATS(n, 3*sizeof(T), sizeof(T));
+  REPORT_MEMORY_BANDWIDTH(n, 3*sizeof(T));
+}
+
+// Offsets of segments with power-law distributed lengths, so that a few
+// huge segments are mixed with very many small ones
+static parlay::sequence<size_t> power_law_offsets(size_t n) {
+  auto lengths = parlay::tabulate(n, [] (size_t i) -> size_t {
+    double u = (parlay::hash64(i) % 1000000 + 1) / 1000000.0;
+    return static_cast<size_t>(1.0 / std::pow(u, 1.0 / 1.2));
+  });
+  auto offsets = parlay::scan_inclusive(lengths);
+  size_t m = std::lower_bound(offsets.begin(), offsets.end(), n) - offsets.begin();
+  auto result = parlay::sequence<size_t>::uninitialized(m + 2);
+  result[0] = 0;
+  parlay::parallel_for(0, m, [&] (size_t i) { result[i + 1] = offsets[i]; });
+  result[m + 1] = n;
+  return result;
+}
+
+template<typename T>
+static void bench_segmented_reduce(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::sequence<T>(n, 1);
+  auto offsets = power_law_offsets(n);
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::segmented_reduce(s, offsets));
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_segmented_scan(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::sequence<T>(n, 1);
+  auto offsets = power_law_offsets(n);
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::segmented_scan(s, offsets));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+template<typename T>
+static void bench_segmented_scan_flags(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::sequence<T>(n, 1);
+  auto offsets = power_law_offsets(n);
+  auto flags = parlay::sequence<bool>(n, false);
+  parlay::parallel_for(0, offsets.size() - 1, [&] (size_t k) {
+    if (offsets[k] < n) flags[offsets[k]] = true;
+  });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::segmented_scan(s, flags));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T) + 1, sizeof(T));
 }
 
 template<typename T>
@@ -112,6 +217,253 @@ static void bench_pack(benchmark::State& state) {
   REPORT_STATS(n, 14, 4);  // Why 14 and 4?
 }
 
+template<typename T>
+static void bench_pack_bits(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto flags = parlay::bit_sequence(parlay::delayed_tabulate(n, [] (size_t i) -> bool {return i%2;}));
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::pack(In, flags));
+  }
+
+  REPORT_STATS(n, sizeof(T) + 0.125, 0.5*sizeof(T));
+}
+
+template<typename T>
+static void bench_count_flags(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto flags = parlay::tabulate(n, [] (size_t i) -> bool {return parlay::hash64(i)%2;});
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto c = parlay::count(flags, true);
+  }
+
+  REPORT_STATS(n, 1, 0);
+}
+
+template<typename T>
+static void bench_count_bits(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto flags = parlay::bit_sequence(parlay::delayed_tabulate(n, [] (size_t i) -> bool {return parlay::hash64(i)%2;}));
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto c = parlay::count(flags, true);
+  }
+
+  REPORT_STATS(n, 0.125, 0);
+}
+
+// A deliberately expensive predicate that selects roughly 1% of its inputs,
+// for comparing ways of collecting the output of an irregular loop
+static bool expensive_selective_predicate(size_t i) {
+  uint64_t h = i;
+  for (int j = 0; j < 32; j++) h = parlay::hash64(h);
+  return h % 100 == 0;
+}
+
+template<typename T>
+static void bench_filter_expensive(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::filter(In, [](T x) { return expensive_selective_predicate(x); }));
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_map_maybe_expensive(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::map_maybe(In, [](T x) -> std::optional<T> {
+      if (expensive_selective_predicate(x)) return x;
+      return std::nullopt;
+    }));
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_concurrent_vector_expensive(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    parlay::concurrent_vector<T> out;
+    parlay::parallel_for(0, n, [&](size_t i) {
+      if (expensive_selective_predicate(In[i])) out.push_back(In[i]);
+    });
+    RUN_AND_CLEAR(out.finalize());
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+// Partition n random keys by a predicate that holds for half of them,
+// either in place, or by filtering into new sequences and copying back
+template<typename T>
+static void bench_partition(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+  auto out = in;
+  auto pred = [n] (T x) { return x < T(n / 2); };
+
+  for (auto _ : state) {
+    COPY_NO_TIME(out, in);
+    parlay::partition(out, pred);
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+template<typename T>
+static void bench_stable_partition(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+  auto out = in;
+  auto pred = [n] (T x) { return x < T(n / 2); };
+
+  for (auto _ : state) {
+    COPY_NO_TIME(out, in);
+    parlay::stable_partition(out, pred);
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+template<typename T>
+static void bench_partition_filter(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+  auto out = in;
+  auto pred = [n] (T x) { return x < T(n / 2); };
+
+  for (auto _ : state) {
+    COPY_NO_TIME(out, in);
+    auto yes = parlay::filter(out, pred);
+    auto no = parlay::filter(out, [&] (T x) { return !pred(x); });
+    parlay::copy(yes, out.cut(0, yes.size()));
+    parlay::copy(no, out.cut(yes.size(), n));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+// Reduce over one field of a sequence of (key, value) pairs, stored either as
+// an array of structs, or as a structure of arrays that only reads the values
+template<typename T>
+static void bench_reduce_field_aos(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::tabulate(n, [] (size_t i) { return std::make_pair(T(i), T(1)); });
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto sum = parlay::reduce(parlay::delayed_map(s, [](const auto& p) { return p.second; }));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_reduce_field_soa(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::soa_sequence<T, T>::from_tuples(
+    parlay::delayed_tabulate(n, [] (size_t i) { return std::make_pair(T(i), T(1)); }));
+
+  for (auto _ : state) {
+    [[maybe_unused]] auto sum = parlay::reduce(s.template column<1>());
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+// Sort a sequence of (key, value) pairs by key, stored either as an array
+// of structs, or as a structure of arrays that sorts the keys then gathers
+template<typename T>
+static void bench_sort_by_key_aos(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::tabulate(n, [] (size_t i) { return std::make_pair(T(parlay::hash64(i)), T(i)); });
+  auto less = [] (const auto& a, const auto& b) { return a.first < b.first; };
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::stable_sort(s, less));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), 2*sizeof(T));
+}
+
+template<typename T>
+static void bench_sort_by_key_soa(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto s = parlay::soa_sequence<T, T>::from_tuples(
+    parlay::delayed_tabulate(n, [] (size_t i) { return std::make_pair(T(parlay::hash64(i)), T(i)); }));
+  parlay::soa_sequence<T, T> s2;
+
+  for (auto _ : state) {
+    COPY_NO_TIME(s2, s);
+    s2.template sort_by<0>();
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), 2*sizeof(T));
+}
+
+// Decompress a sorted sequence with small gaps, which is stored
+// using about 1 byte per element rather than sizeof(T)
+template<typename T>
+static void bench_compressed_decode(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto c = parlay::compressed_sequence<T>(parlay::delayed_tabulate(n, [] (size_t i) -> T {
+    return T(32 * i + parlay::hash64(i) % 32);}));
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(c.to_sequence());
+  }
+
+  REPORT_STATS(n, double(c.size_in_bytes()) / n, sizeof(T));
+}
+
+// Sum a compressed sequence by decoding each block in place,
+// without materializing the decompressed sequence
+template<typename T>
+static void bench_compressed_for_each(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto c = parlay::compressed_sequence<T>(parlay::delayed_tabulate(n, [] (size_t i) -> T {
+    return T(32 * i + parlay::hash64(i) % 32);}));
+  auto sums = parlay::sequence<T>(c.num_blocks());
+
+  for (auto _ : state) {
+    parlay::parallel_for(0, c.num_blocks(), [&] (size_t b) {
+      T total = 0;
+      c.decode_block(b, [&] (size_t, T x) { total += x; });
+      sums[b] = total;
+    }, 1);
+  }
+
+  REPORT_STATS(n, double(c.size_in_bytes()) / n, 0);
+}
+
+// Large enough inputs are written with streaming stores
+template<typename T>
+static void bench_copy(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto in = parlay::tabulate(n, [] (size_t i) -> T { return i; });
+  auto out = parlay::sequence<T>(n);
+
+  for (auto _ : state) {
+    parlay::copy(in, out);
+  }
+
+  REPORT_STATS(n, sizeof(T), sizeof(T));
+}
+
 template<typename T>
 static void bench_gather(benchmark::State& state) {
   size_t n = state.range(0);
@@ -316,6 +668,65 @@ static void bench_integer_sort(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+// The peak resident memory of the process in bytes, or zero if unknown
+static double peak_memory_usage() {
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+  return static_cast<double>(usage.ru_maxrss);
+#else
+  return 1024.0 * static_cast<double>(usage.ru_maxrss);
+#endif
+#else
+  return 0;
+#endif
+}
+
+// Report how much the peak memory of the process grew while running the
+// benchmark, per byte of input. Since the peak never decreases, this is only
+// meaningful when the benchmark is run on its own (with --benchmark_filter).
+#define REPORT_PEAK_MEMORY(n, before)                                                                     \
+  state.counters["   Peak mem/input"] = Counter((peak_memory_usage() - (before)) / ((n) * sizeof(T)));
+
+template<typename T>
+static void bench_integer_sort_inplace(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i); });
+  auto out = in;
+  double memory_before = peak_memory_usage();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    parlay::copy(in, out);    // Unlike assignment, does not reallocate
+    state.ResumeTiming();
+    parlay::integer_sort_inplace(out);
+  }
+
+  REPORT_STATS(n, 0, 0);
+  REPORT_PEAK_MEMORY(n, memory_before);
+}
+
+template<typename T>
+static void bench_integer_sort_inplace_low_memory(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i); });
+  auto out = in;
+  double memory_before = peak_memory_usage();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    parlay::copy(in, out);    // Unlike assignment, does not reallocate
+    state.ResumeTiming();
+    parlay::integer_sort_inplace(out, parlay::sort_mode::low_memory);
+  }
+
+  REPORT_STATS(n, 0, 0);
+  REPORT_PEAK_MEMORY(n, memory_before);
+}
+
 template<typename T>
 static void bench_sort(benchmark::State& state) {
   size_t n = state.range(0);
@@ -364,6 +775,210 @@ static void bench_sort_inplace(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+// Inputs for comparing sorting algorithms: uniformly random keys, keys from a
+// Zipf distribution (with exponent 1), which has many duplicates, and sorted
+// keys with 1% of them replaced by random keys
+enum sort_input { uniform_input, zipf_input, nearly_sorted_input };
+
+template<typename T>
+static parlay::sequence<T> make_sort_input(size_t n, sort_input input) {
+  parlay::random r(0);
+  return parlay::tabulate(n, [&] (size_t i) -> T {
+    switch (input) {
+      case zipf_input: {
+        double u = static_cast<double>(r.ith_rand(i) % 1000000007) / 1000000007.0;
+        return static_cast<T>(std::exp(u * std::log(static_cast<double>(n))));
+      }
+      case nearly_sorted_input: return (r.ith_rand(i) % 100 == 0) ? r.ith_rand(n + i) % n : i;
+      default: return r.ith_rand(i) % n;
+    }
+  });
+}
+
+template<typename T>
+static void sort_inplace_benchmark(benchmark::State& state, parlay::sort_mode mode) {
+  size_t n = state.range(0);
+  auto input = static_cast<sort_input>(state.range(1));
+  auto in = make_sort_input<T>(n, input);
+  auto out = in;
+  double memory_before = peak_memory_usage();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    parlay::copy(in, out);
+    state.ResumeTiming();
+    parlay::internal::sample_sort_inplace(parlay::make_slice(out), std::less<T>(), mode);
+  }
+
+  state.SetLabel(input == uniform_input ? "uniform" : input == zipf_input ? "zipf" : "nearly sorted");
+  REPORT_STATS(n, 0, 0);
+  REPORT_PEAK_MEMORY(n, memory_before);
+}
+
+template<typename T>
+static void bench_sort_inplace_standard(benchmark::State& state) {
+  sort_inplace_benchmark<T>(state, parlay::sort_mode::standard);
+}
+
+template<typename T>
+static void bench_sort_inplace_low_memory(benchmark::State& state) {
+  sort_inplace_benchmark<T>(state, parlay::sort_mode::low_memory);
+}
+
+// Keys that parlay::sort sorts by radix sort rather than by comparisons:
+// uniformly random floating point numbers of both signs, and pairs of ints
+using int_pair = std::pair<int, int>;
+
+template<typename T>
+static parlay::sequence<T> make_radix_sort_input(size_t n) {
+  parlay::random r(0);
+  return parlay::tabulate(n, [&] (size_t i) -> T {
+    if constexpr (std::is_same_v<T, int_pair>) {
+      return {static_cast<int>(r.ith_rand(i) % n) - static_cast<int>(n / 2), static_cast<int>(r.ith_rand(n + i) % n)};
+    }
+    else {
+      return static_cast<T>(static_cast<double>(r.ith_rand(i) % n) - static_cast<double>(n / 2)) / static_cast<T>(3);
+    }
+  });
+}
+
+template<typename T>
+static void bench_sort_comparison(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto in = make_radix_sort_input<T>(n);
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::internal::sample_sort(parlay::make_slice(in), std::less<T>()));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_sort_radix(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto in = make_radix_sort_input<T>(n);
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::sort(in));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+// String keys: the words of a large random text generated by the trigram
+// model, which are short and have many duplicates, and URL-like keys, which
+// share long prefixes
+enum string_sort_input { words_input, urls_input };
+
+static parlay::sequence<parlay::chars> make_string_sort_input(size_t n, string_sort_input input) {
+  if (input == words_input) {
+    ngram_table table;
+    auto text = table.string(6 * n, 0);
+    return parlay::tokens(text, [] (char c) { return c == '_'; });
+  }
+  parlay::random r(0);
+  return parlay::tabulate(n, [&] (size_t i) {
+    auto url = "https://www.site" + std::to_string(r.ith_rand(i) % 1000) + ".com/articles/" +
+               std::to_string(r.ith_rand(n + i) % 100) + "/page" + std::to_string(r.ith_rand(2 * n + i) % n);
+    return parlay::chars(url.begin(), url.end());
+  });
+}
+
+template<typename T>
+static void string_sort_benchmark(benchmark::State& state, bool radix) {
+  auto input = static_cast<string_sort_input>(state.range(1));
+  auto in = make_string_sort_input(state.range(0), input);
+  size_t n = in.size();
+
+  for (auto _ : state) {
+    if (radix) { RUN_AND_CLEAR(parlay::string_sort(in)); }
+    else { RUN_AND_CLEAR(parlay::sort(in)); }
+  }
+
+  state.SetLabel(input == words_input ? "words" : "urls");
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_sort_strings_comparison(benchmark::State& state) {
+  string_sort_benchmark<T>(state, false);
+}
+
+template<typename T>
+static void bench_sort_strings_radix(benchmark::State& state) {
+  string_sort_benchmark<T>(state, true);
+}
+
+// Sort a sequence whose storage is backed by a temporary file. For inputs
+// larger than main memory, set the file allocator's directory (via TMPDIR)
+// to a disk with enough space.
+// The k = state.range(1) largest of n random scores, which should
+// take far less time than sorting all of them (see bench_sort)
+template<typename T>
+static void bench_top_k(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t k = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::top_k(in, k, std::greater<T>()));
+  }
+
+  state.SetLabel("k = " + std::to_string(k));
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_partial_sort(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t k = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+  auto out = in;
+
+  for (auto _ : state) {
+    COPY_NO_TIME(out, in);
+    parlay::partial_sort(out, k);
+  }
+
+  state.SetLabel("k = " + std::to_string(k));
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+// The 99 percentiles of n random keys
+template<typename T>
+static void bench_multi_select(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % n; });
+  auto ranks = parlay::tabulate(99, [&] (size_t i) { return (i + 1) * n / 100; });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::multi_select(in, ranks));
+  }
+
+  REPORT_STATS(n, sizeof(T), 0);
+}
+
+template<typename T>
+static void bench_sort_inplace_file_backed(benchmark::State& state) {
+  using sequence_type = parlay::sequence<T, parlay::file_allocator<T>>;
+  size_t n = state.range(0);
+  parlay::random r(0);
+  sequence_type out(n);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    parlay::parallel_for(0, n, [&] (size_t i) { out[i] = r.ith_rand(i) % n; });
+    state.ResumeTiming();
+    parlay::sort_inplace(out);
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
 template<typename T>
 static void bench_merge(benchmark::State& state) {
   size_t n = state.range(0);
@@ -377,11 +992,68 @@ static void bench_merge(benchmark::State& state) {
   REPORT_STATS(n, 2*sizeof(T), sizeof(T));
 }
 
+// Merge k sorted sequences of random keys, either in one pass with a
+// multiway merge, or pairwise in a balanced tree of log k passes
+template<typename T>
+static void bench_multiway_merge(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t k = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(k, [&] (size_t j) {
+    return parlay::sort(parlay::tabulate(n/k, [&] (size_t i) -> T {return r.ith_rand(j*n/k + i)%n;}));
+  });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::multiway_merge(in));
+  }
+
+  state.SetLabel(std::to_string(k) + " sequences");
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+template<typename T>
+static void bench_pairwise_merge(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t k = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(k, [&] (size_t j) {
+    return parlay::sort(parlay::tabulate(n/k, [&] (size_t i) -> T {return r.ith_rand(j*n/k + i)%n;}));
+  });
+
+  auto merge_all = [&] (auto&& self, size_t s, size_t e) -> parlay::sequence<T> {
+    if (e - s == 1) return in[s];
+    parlay::sequence<T> a, b;
+    size_t m = (s + e) / 2;
+    parlay::par_do([&] { a = self(self, s, m); }, [&] { b = self(self, m, e); });
+    return parlay::merge(a, b);
+  };
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(merge_all(merge_all, 0, k));
+  }
+
+  state.SetLabel(std::to_string(k) + " sequences");
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
+// Inputs for adaptive sorting: random keys, sorted keys, reverse sorted
+// keys, and the concatenation of 16 sorted sequences of random keys
+enum presorted_input { random_order, sorted_order, reverse_order, k_runs_order };
+
 template<typename T>
 static void bench_merge_sort(benchmark::State& state) {
   size_t n = state.range(0);
+  auto input = static_cast<presorted_input>(state.range(1));
   parlay::random r(0);
   auto in = parlay::tabulate(n, [&] (size_t i) -> T {return r.ith_rand(i)%n;});
+  if (input == sorted_order) in = parlay::sort(in);
+  else if (input == reverse_order) in = parlay::sort(in, std::greater<T>());
+  else if (input == k_runs_order) {
+    size_t k = 16;
+    parlay::parallel_for(0, k, [&] (size_t j) {
+      parlay::sort_inplace(parlay::make_slice(in).cut(j * n / k, (j + 1) * n / k));
+    }, 1);
+  }
   auto out = in;
 
   while (state.KeepRunningBatch(10)) {
@@ -391,6 +1063,8 @@ static void bench_merge_sort(benchmark::State& state) {
     }
   }
 
+  state.SetLabel(input == random_order ? "random" : input == sorted_order ? "sorted" :
+                 input == reverse_order ? "reverse sorted" : "16 runs");
   REPORT_STATS(n, 0, 0);
 }
 
@@ -641,8 +1315,31 @@ static void bench_group_by_index_256(benchmark::State& state) {
 BENCH(map, long, 100000000/PSIZE_FACTOR);
 BENCH(tabulate, long, 100000000/PSIZE_FACTOR);
 BENCH(reduce_add, long, 100000000/PSIZE_FACTOR);
+BENCH(reduce_add, float, 100000000/PSIZE_FACTOR);
+BENCH(reduce_add, double, 100000000/PSIZE_FACTOR);
 BENCH(scan_add, long, 100000000/PSIZE_FACTOR);
+BENCH(scan_add, int, 100000000/PSIZE_FACTOR);
+BENCH(scan_add, double, 100000000/PSIZE_FACTOR);
+BENCH(segmented_reduce, long, 100000000/PSIZE_FACTOR);
+BENCH(segmented_scan, long, 100000000/PSIZE_FACTOR);
+BENCH(segmented_scan_flags, long, 100000000/PSIZE_FACTOR);
 BENCH(pack, long, 100000000/PSIZE_FACTOR);
+BENCH(pack_bits, long, 100000000/PSIZE_FACTOR);
+BENCH(count_flags, bool, 100000000/PSIZE_FACTOR);
+BENCH(count_bits, bool, 100000000/PSIZE_FACTOR);
+BENCH(filter_expensive, long, 10000000/PSIZE_FACTOR);
+BENCH(map_maybe_expensive, long, 10000000/PSIZE_FACTOR);
+BENCH(concurrent_vector_expensive, long, 10000000/PSIZE_FACTOR);
+BENCH(partition, long, 100000000/PSIZE_FACTOR);
+BENCH(stable_partition, long, 100000000/PSIZE_FACTOR);
+BENCH(partition_filter, long, 100000000/PSIZE_FACTOR);
+BENCH(reduce_field_aos, long, 100000000/PSIZE_FACTOR);
+BENCH(reduce_field_soa, long, 100000000/PSIZE_FACTOR);
+BENCH(sort_by_key_aos, long, 10000000/PSIZE_FACTOR);
+BENCH(sort_by_key_soa, long, 10000000/PSIZE_FACTOR);
+BENCH(compressed_decode, unsigned long, 100000000/PSIZE_FACTOR);
+BENCH(compressed_for_each, unsigned long, 100000000/PSIZE_FACTOR);
+BENCH(copy, long, 100000000/PSIZE_FACTOR);
 BENCH(gather, long, 100000000/PSIZE_FACTOR);
 BENCH(scatter, long, 100000000/PSIZE_FACTOR);
 BENCH(scatter, int, 100000000/PSIZE_FACTOR);
@@ -652,13 +1349,44 @@ BENCH(count_sort, long, 100000000/PSIZE_FACTOR, 4);
 BENCH(count_sort, long, 100000000/PSIZE_FACTOR, 8);
 BENCH(integer_sort, unsigned int, 100000000/PSIZE_FACTOR);
 BENCH(integer_sort_pair, unsigned int, 100000000/PSIZE_FACTOR);
+BENCH(integer_sort_inplace, unsigned long, 100000000/PSIZE_FACTOR);
+BENCH(integer_sort_inplace_low_memory, unsigned long, 100000000/PSIZE_FACTOR);
 BENCH(sort, unsigned int, 100000000/PSIZE_FACTOR);
 BENCH(sort, long, 100000000/PSIZE_FACTOR);
 BENCH(sort, parlay::sequence<char>, 100000000/PSIZE_FACTOR);
 BENCH(sort_inplace, unsigned int, 100000000/PSIZE_FACTOR);
 BENCH(sort_inplace, long, 100000000/PSIZE_FACTOR);
+BENCH(sort_inplace_standard, long, 100000000/PSIZE_FACTOR, uniform_input);
+BENCH(sort_inplace_low_memory, long, 100000000/PSIZE_FACTOR, uniform_input);
+BENCH(sort_inplace_standard, long, 100000000/PSIZE_FACTOR, zipf_input);
+BENCH(sort_inplace_low_memory, long, 100000000/PSIZE_FACTOR, zipf_input);
+BENCH(sort_inplace_standard, long, 100000000/PSIZE_FACTOR, nearly_sorted_input);
+BENCH(sort_inplace_low_memory, long, 100000000/PSIZE_FACTOR, nearly_sorted_input);
+BENCH(sort_comparison, float, 100000000/PSIZE_FACTOR);
+BENCH(sort_radix, float, 100000000/PSIZE_FACTOR);
+BENCH(sort_comparison, double, 100000000/PSIZE_FACTOR);
+BENCH(sort_radix, double, 100000000/PSIZE_FACTOR);
+BENCH(sort_comparison, int_pair, 100000000/PSIZE_FACTOR);
+BENCH(sort_radix, int_pair, 100000000/PSIZE_FACTOR);
+BENCH(sort_strings_comparison, parlay::chars, 10000000/PSIZE_FACTOR, words_input);
+BENCH(sort_strings_radix, parlay::chars, 10000000/PSIZE_FACTOR, words_input);
+BENCH(sort_strings_comparison, parlay::chars, 10000000/PSIZE_FACTOR, urls_input);
+BENCH(sort_strings_radix, parlay::chars, 10000000/PSIZE_FACTOR, urls_input);
+BENCH(sort_inplace_file_backed, long, 100000000/PSIZE_FACTOR);
+BENCH(top_k, double, 100000000/PSIZE_FACTOR, 1000);
+BENCH(partial_sort, double, 100000000/PSIZE_FACTOR, 1000);
+BENCH(multi_select, double, 100000000/PSIZE_FACTOR);
 BENCH(merge, long, 100000000/PSIZE_FACTOR);
-BENCH(merge_sort, long, 100000000/PSIZE_FACTOR);
+BENCH(multiway_merge, long, 100000000/PSIZE_FACTOR, 2);
+BENCH(multiway_merge, long, 100000000/PSIZE_FACTOR, 16);
+BENCH(multiway_merge, long, 100000000/PSIZE_FACTOR, 256);
+BENCH(pairwise_merge, long, 100000000/PSIZE_FACTOR, 2);
+BENCH(pairwise_merge, long, 100000000/PSIZE_FACTOR, 16);
+BENCH(pairwise_merge, long, 100000000/PSIZE_FACTOR, 256);
+BENCH(merge_sort, long, 100000000/PSIZE_FACTOR, random_order);
+BENCH(merge_sort, long, 100000000/PSIZE_FACTOR, sorted_order);
+BENCH(merge_sort, long, 100000000/PSIZE_FACTOR, reverse_order);
+BENCH(merge_sort, long, 100000000/PSIZE_FACTOR, k_runs_order);
 BENCH(quicksort, long, 100000000/PSIZE_FACTOR);
 BENCH(random_shuffle, long, 100000000/PSIZE_FACTOR);
 BENCH(histogram, unsigned int, 100000000/PSIZE_FACTOR);
@@ -682,6 +1410,12 @@ BENCH(histogram_by_key, parlay::sequence<char>, 100000000/PSIZE_FACTOR);
 BENCH(remove_duplicates, parlay::sequence<char>, 100000000/PSIZE_FACTOR);
 BENCH(group_by_key, parlay::sequence<char>, 100000000/PSIZE_FACTOR);
 
+// Out-of-core sort of a dataset twice the size of main memory. Disabled by
+// default since it takes a long time and requires a lot of free disk space
+#if defined(PARLAY_BENCHMARK_OUT_OF_CORE)
+BENCH(sort_inplace_file_backed, long, static_cast<long>(2 * getMemorySize() / sizeof(long)));
+#endif
+
 #if defined(__GNUC__)
 BENCH(sort, __int128, 100000000/PSIZE_FACTOR);
 BENCH(sort_inplace, __int128, 100000000/PSIZE_FACTOR);
@@ -12,8 +12,8 @@
 // **************************************************************
 using vertex = int;
 using nested_seq = parlay::sequence<parlay::sequence<vertex>>;
-using graph = nested_seq;
 using utils = graph_utils<vertex>;
+using graph = utils::csr_graph;
 
 int main(int argc, char* argv[]) {
   auto usage = "Usage: BFS_ligra <n> || BFS_ligra <filename>";
@@ -24,12 +24,12 @@ int main(int argc, char* argv[]) {
     try { n = std::stol(argv[1]); }
     catch (...) {}
     if (n == 0) {
-      G = utils::read_symmetric_graph_from_file(argv[1]);
+      G = graph(utils::read_symmetric_graph_from_file(argv[1]));
       GT = G;
       n = G.size();
     } else {
-      G = utils::rmat_graph(n, 20*n);
-      GT = utils::transpose(G);
+      G = utils::rmat_csr_graph(n, 20*n);
+      GT = G.transpose();
     }
     utils::print_graph_stats(G);
     nested_seq result;
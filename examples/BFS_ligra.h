@@ -8,8 +8,8 @@
 
 // **************************************************************
 // Parallel Breadth First Search (Using the Ligra interface)
-// The graph is a sequence of sequences of vertex ids, representing
-// the outedges for each vertex.
+// The graph is a sequence of sequences of vertex ids, or a
+// parlay::csr_graph, representing the outedges for each vertex.
 // Requires the transpose graph (i.e the back edges).
 // Returns a sequence of sequences, with the ith element corresponding to
 // all vertices at distance i (i.e. the i-th frontier during the search).
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <string>
+#include <parlay/csr_graph.h>
 #include <parlay/primitives.h>
 #include <parlay/sequence.h>
 #include <parlay/io.h>
@@ -10,6 +11,7 @@ struct graph_utils {
   using edges = parlay::sequence<edge>;
   using vertices = parlay::sequence<vertex>;
   using graph = parlay::sequence<vertices>;
+  using csr_graph = parlay::csr_graph<vertex>;
 
   template <typename wtype>
   using weighted_vertices = parlay::sequence<std::pair<vertex,wtype>>;
@@ -138,6 +140,13 @@ struct graph_utils {
     return parlay::group_by_index(edges, 1 << logn);
   }
 
+  // same as rmat_graph, but in compressed sparse row format
+  static csr_graph rmat_csr_graph(long n, long m, double a=.5, double b=.15, double c=.15) {
+    int logn = round(log2(n));
+    auto edges = rmat_edges_(logn, m, a, b, c);
+    return csr_graph::from_edges(edges, 1 << logn);
+  }
+
   static graph rmat_symmetric_graph(long n, long m, double a=.5, double b=.15, double c=.15) {
     int logn = round(log2(n));
     auto edges = rmat_edges_(logn, m/2, a, b, c);
@@ -161,6 +170,16 @@ struct graph_utils {
     std::cout << "max degree   = " << max_degree << std::endl;
   }
 
+  static void print_graph_stats(const csr_graph& G) {
+    auto degrees = parlay::delayed::tabulate(G.size(), [&] (long u) {return G.degree(u);});
+    long max_degree = reduce(degrees, parlay::maximum<size_t>());
+    long bytes = G.get_offsets().size() * sizeof(size_t) + G.num_edges() * sizeof(vertex);
+    std::cout << "num vertices = " << G.size() << std::endl;
+    std::cout << "num edges    = " << G.num_edges() << std::endl;
+    std::cout << "max degree   = " << max_degree << std::endl;
+    std::cout << "memory (MB)  = " << bytes / 1000000 << std::endl;
+  }
+
   static void print_graph_stats(const edges& E, long n) {
     auto ET = parlay::delayed::map(E, [] (auto e) {return std::pair(e.second, e.first);});
     auto Ef = remove_duplicates(append(E, ET));
@@ -18,6 +18,7 @@
 #include "utilities.h"
 
 #include "internal/block_allocator.h"
+#include "internal/concurrency/epoch.h"
 #include "internal/memory_size.h"
 #include "internal/pool_allocator.h"
 
@@ -28,9 +29,10 @@ namespace parlay {
 // ----------------------------------------------------------------------------
 //                            internal pool allocator
 //
-// allocates pools of blocks with powers of two sizes. Used internally to provide
-// allocation for the container allocator, parlay::allocator<T>; and for the free
-// functions, parlay::p_malloc and parlay::p_free.
+// allocates pools of blocks with powers of two sizes for small blocks, and
+// finer-grained size classes for medium and large blocks. Used internally to
+// provide allocation for the container allocator, parlay::allocator<T>; and for
+// the free functions, parlay::p_malloc and parlay::p_free.
 // ----------------------------------------------------------------------------
 
 namespace internal {
@@ -38,23 +40,45 @@ namespace internal {
 // The size of the largest pool used by the memory allocator
 inline const size_t default_allocator_max_pool_size = getMemorySize() / 64;
 
+// The smallest bucket size at which the default allocator starts using more
+// than one size class per power of two
+inline constexpr size_t default_allocator_min_fine_size = size_t{1} << 18;
+
+// The number of size classes per power of two for bucket sizes at least
+// default_allocator_min_fine_size. Must be a power of two.
+inline constexpr size_t default_allocator_classes_per_doubling = 4;
+
 // these are bucket sizes used by the default allocator. They are powers
-// of two starting at 16 and going until SystemMemory / 64.
+// of two starting at 16 and going until default_allocator_min_fine_size,
+// after which each power of two is split into default_allocator_classes_per_doubling
+// evenly-spaced size classes, going until SystemMemory / 64. Allocations larger than
+// that are passed straight to the system allocator with their exact size.
 //
-// Note that them being powers of two is very important for correctness
-// of the high-level allocators defined here!
+// Note that the bucket sizes being multiples of large powers of two is very
+// important for correctness of the high-level allocators defined here!
 //  - being powers of two means that if a block is suitably aligned for an object
-//    of type T, the next block is guaranteed to also be suitably aligned for T
+//    of type T, the next block is guaranteed to also be suitably aligned for T.
+//    The fine-grained size classes are all multiples of 2^16, which is much more
+//    than the maximum alignment supported by the pool allocator.
 //  - p_malloc optimizes its header by only storing log(size) of the allocation,
-//    which works because that is enough information to know which pool it came from
+//    which works because it only ever requests power-of-two sizes, which are all
+//    exactly the size of one of the pools.
 //
 inline std::vector<size_t> default_allocator_sizes() {
   size_t log_min_size = 4;
   size_t log_max_size = log2_up(default_allocator_max_pool_size);
 
   std::vector<size_t> sizes;
-  for (size_t i = log_min_size; i <= log_max_size; i++)
-    sizes.push_back(size_t{1} << i);
+  for (size_t i = log_min_size; i < log_max_size; i++) {
+    size_t size = size_t{1} << i;
+    sizes.push_back(size);
+    if (size >= default_allocator_min_fine_size) {
+      size_t step = size / default_allocator_classes_per_doubling;
+      for (size_t j = 1; j < default_allocator_classes_per_doubling; j++)
+        sizes.push_back(size + j * step);
+    }
+  }
+  sizes.push_back(size_t{1} << log_max_size);
   return sizes;
 }
 
@@ -85,8 +109,8 @@ namespace internal {
 // Header used by p_malloc. Stores the requested size of the buffer and
 // the offset of the underlying buffer that we need to free later.
 struct p_malloc_header {
-  uint64_t log_size : 8;   // We can store the log of the size because the default
-  uint64_t offset : 48;    // allocator uses only powers of two pool sizes
+  uint64_t log_size : 8;   // We can store the log of the size because p_malloc only
+  uint64_t offset : 48;    // requests power-of-two sizes from the default allocator
 };
 static_assert(sizeof(p_malloc_header) <= 8);
 
@@ -112,9 +136,12 @@ inline size_t alloc_padding_size(size_t n) {  // in bytes
 inline void* p_malloc(size_t size, size_t align = alignof(std::max_align_t)) {
   assert(align > 0 && (align & (align - 1)) == 0 && "Requested alignment must be a power of two");
 
-  // allocates and tags with a header that contains the size and offset
+  // allocates and tags with a header that contains the size and offset. The
+  // allocation is rounded up to a power of two so that its size is determined
+  // by the log size stored in the header
   size_t pad_size = std::max<size_t>(internal::alloc_padding_size(size), align);
-  void* buffer = internal::get_default_allocator().allocate(size + pad_size);
+  size_t log_size = log2_up(size + pad_size);
+  void* buffer = internal::get_default_allocator().allocate(size_t{1} << log_size);
   void* offset_buffer = static_cast<void*>(static_cast<std::byte*>(buffer) + sizeof(internal::p_malloc_header));
   size_t space = size + pad_size - sizeof(internal::p_malloc_header);
   void* new_buffer = std::align(pad_size, size, offset_buffer, space);
@@ -122,7 +149,7 @@ inline void* p_malloc(size_t size, size_t align = alignof(std::max_align_t)) {
   size_t offset = (static_cast<std::byte*>(new_buffer) - static_cast<std::byte*>(buffer));
   assert(offset == (size + pad_size) - space);
   new (static_cast<std::byte*>(new_buffer) - sizeof(internal::p_malloc_header))
-      internal::p_malloc_header{log2_up(size + pad_size), offset};
+      internal::p_malloc_header{log_size, offset};
   return static_cast<void*>(new_buffer);
 }
 
@@ -179,6 +206,39 @@ struct allocator {
     }
   }
 
+  // Attempt to resize the buffer ptr, which holds storage for old_n objects, to hold
+  // new_n objects without copying it. Returns the (possibly moved) buffer on success,
+  // or nullptr if this is not possible, in which case ptr is unchanged. The contents
+  // are moved bitwise, so this is only suitable for trivially relocatable types.
+  //
+  // This is not part of the standard Allocator requirements. It is detected and
+  // used by parlay::sequence to grow very large buffers in place.
+  T* try_reallocate(T* ptr, size_t old_n, size_t new_n) {
+    if constexpr (alignof(T) > internal::pool_allocator::max_alignment) {
+      return nullptr;
+    }
+    else {
+      void* buffer = internal::get_default_allocator().try_reallocate(static_cast<void*>(ptr),
+          old_n * sizeof(T), new_n * sizeof(T));
+      return static_cast<T*>(buffer);
+    }
+  }
+
+  // Allocate storage for n objects whose bytes are all zero, if this can be done
+  // without writing to the storage, i.e., if it is freshly obtained from the OS.
+  // Returns nullptr otherwise. Deallocate the storage as usual by deallocate(ptr, n).
+  //
+  // This is not part of the standard Allocator requirements. It is detected and
+  // used by parlay::sequence to create very large zero-initialized sequences in O(1).
+  T* try_allocate_zeroed(size_t n) {
+    if constexpr (alignof(T) > internal::pool_allocator::max_alignment) {
+      return nullptr;
+    }
+    else {
+      return static_cast<T*>(internal::get_default_allocator().try_allocate_zeroed(n * sizeof(T)));
+    }
+  }
+
   constexpr allocator() { internal::get_default_allocator(); }
   template <class U> /* implicit */ constexpr allocator(const allocator<U>&) noexcept { }
 };
@@ -227,6 +287,11 @@ extern inline block_allocator& get_block_allocator() {
 // create(args...) -> T* : allocates storage for and constructs a T using args...
 // destroy(T*)           : destroys and deallocates a T obtained from create(...)
 //
+// retire(T*)            : destroys and deallocates a T obtained from create(...)
+//                         once no thread can be reading it. Readers must access
+//                         shared objects inside parlay::with_epoch(f), and the
+//                         object must be unreachable by new readers when retired.
+//
 // All members are static, so it is not required to create an instance of
 // type_allocator<T> to use it.
 //
@@ -237,6 +302,18 @@ class type_allocator {
     return internal::get_block_allocator<sizeof(T), alignof(T)>();
   }
 
+  struct retired_deleter {
+    void operator()(T* ptr) const { destroy(ptr); }
+  };
+
+  static internal::epoch_retire<T, retired_deleter>& get_retired() {
+    // Touch the block allocator to force its initialization before the
+    // retired lists, since retired objects are returned to it on destruction
+    get_allocator();
+    static internal::epoch_retire<T, retired_deleter> retired;
+    return retired;
+  }
+
 public:
 
   // Allocate uninitialized storage appropriate for storing an object of type T
@@ -267,17 +344,27 @@ public:
     free(ptr);
   }
 
+  // Destroy an object obtained by create(...) and deallocate its storage once
+  // every thread that might still be reading it inside with_epoch has finished.
+  // Safe to call concurrently with readers and with other calls to retire.
+  static void retire(T* ptr) {
+    assert(ptr != nullptr);
+    get_retired().retire(ptr);
+  }
+
+  // Returns the number of retired objects that have not yet been destroyed
+  static size_t num_retired() { return get_retired().size(); }
+
   // for backward compatibility -----------------------------------------------
   static constexpr inline size_t default_alloc_size = 0;
   static constexpr inline bool initialized = true;
 
   template <typename ... Args>
   static T* allocate(Args... args) { return create(std::forward<Args>(args)...); }
-  static void retire(T* ptr) { destroy(ptr); }
   static void init(size_t, size_t) {}
   static void init() {}
   static void reserve([[maybe_unused]] size_t n = default_alloc_size) { }
-  static void finish() { get_allocator().clear(); }
+  static void finish() { get_retired().clear(); get_allocator().clear(); }
   static size_t block_size () { return get_allocator().get_block_size(); }
   static size_t num_allocated_blocks() { return get_allocator().num_allocated_blocks(); }
   static size_t num_used_blocks() { return get_allocator().num_used_blocks(); }
@@ -285,6 +372,17 @@ public:
   static void print_stats() { get_allocator().print_stats(); }
 };
 
+// Runs f() inside a region in which objects retired via type_allocator<T>::retire,
+// for any type T, are protected from being destroyed. Concurrent data structures
+// should perform any reads of nodes that other threads might retire inside with_epoch.
+//
+// f should not fork parallel tasks, since they may run on other threads whose
+// reads are not protected. Calls to with_epoch may be nested.
+template<typename F>
+auto with_epoch(F&& f) -> decltype(f()) {
+  return internal::get_epoch_manager().protect(std::forward<F>(f));
+}
+
 
 }  // namespace parlay
 
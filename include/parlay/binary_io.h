@@ -0,0 +1,502 @@
+// Binary serialization of sequences of trivially copyable types, and of
+// nested sequences of them, such as adjacency lists. Loading a binary file
+// avoids parsing text with chars_from_file, tokens, and chars_to_long,
+// and is limited only by the speed of the disk.
+//
+// A binary file can be loaded either by reading it into a new sequence
+// (read_binary), or by mapping it into memory with parlay::file_map and
+// viewing its contents in place, without copying (map_binary). A view is
+// backed by the page cache, so the data is loaded lazily as it is accessed,
+// and the pages are shared between every process that maps the same file.
+//
+// Example:
+//
+//   parlay::write_binary(ids, "ids.bin");
+//   parlay::sequence<long> ids2 = parlay::read_binary<long>("ids.bin");
+//   auto view = parlay::map_binary<long>("ids.bin");     // zero copy
+//   long total = parlay::reduce(view);
+//
+//   parlay::write_binary(adjacency, "graph.bin");        // sequence<sequence<int>>
+//   auto G = parlay::map_binary_nested<int>("graph.bin");
+//   for (int v : G[u]) { ... }
+//
+// The file format consists of a 64-byte header, followed, for nested
+// sequences, by the n+1 offsets of the inner sequences as 64-bit integers,
+// followed by the elements, which start at a multiple of 64 bytes. Values
+// are stored in the native byte order, so files are only portable between
+// machines with the same byte order and type layouts. The header contains
+// a version number, the kind of sequence, and the size of the elements,
+// which are checked on loading, along with the sizes in the header and the
+// offsets of nested sequences, so that loading a corrupt or truncated file
+// throws rather than reading outside of it.
+//
+
+#ifndef PARLAY_BINARY_IO_H_
+#define PARLAY_BINARY_IO_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "monoid.h"
+#include "parallel.h"
+#include "portability.h"
+#include "sequence.h"
+#include "slice.h"
+
+#include "internal/file_map.h"
+#include "internal/sequence_ops.h"
+
+#if defined(PARLAY_POSIX_FILE_MAP)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#endif
+
+namespace parlay {
+namespace internal {
+
+inline constexpr char binary_magic[8] = {'P', 'A', 'R', 'L', 'A', 'Y', 'B', 'N'};
+inline constexpr uint32_t binary_version = 1;
+inline constexpr size_t binary_alignment = 64;
+
+enum class binary_kind : uint32_t {
+  flat = 0,      // A sequence<T>
+  nested = 1,    // A sequence<sequence<T>>
+};
+
+struct binary_header {
+  char magic[8];
+  uint32_t version;
+  binary_kind kind;
+  uint64_t element_size;
+  uint64_t num_sequences;     // The number of inner sequences of a nested sequence
+  uint64_t num_elements;      // The total number of elements
+  uint64_t elements_offset;   // The position in the file of the first element
+  uint64_t reserved[2];
+};
+
+static_assert(sizeof(binary_header) == binary_alignment);
+static_assert(std::is_trivially_copyable_v<binary_header>);
+
+inline binary_header make_binary_header(binary_kind kind, size_t element_size,
+                                        size_t num_sequences, size_t num_elements) {
+  binary_header h{};
+  std::memcpy(h.magic, binary_magic, sizeof(binary_magic));
+  h.version = binary_version;
+  h.kind = kind;
+  h.element_size = element_size;
+  h.num_sequences = num_sequences;
+  h.num_elements = num_elements;
+  size_t offsets_size = (kind == binary_kind::nested) ? (num_sequences + 1) * sizeof(uint64_t) : 0;
+  h.elements_offset = (sizeof(binary_header) + offsets_size + binary_alignment - 1) / binary_alignment * binary_alignment;
+  return h;
+}
+
+inline void check_binary_header(const binary_header& h, binary_kind kind, size_t element_size, size_t file_size) {
+  auto fail = [](const std::string& reason) {
+    throw_exception_or_terminate<std::runtime_error>("Invalid parlay binary file: " + reason);
+  };
+  if (std::memcmp(h.magic, binary_magic, sizeof(binary_magic)) != 0) fail("bad magic number");
+  if (h.version != binary_version) fail("unsupported version " + std::to_string(h.version));
+  if (h.kind != kind) fail(kind == binary_kind::nested ? "expected a nested sequence" : "expected a flat sequence");
+  if (h.element_size != element_size) fail("element size " + std::to_string(h.element_size) +
+                                           " does not match " + std::to_string(element_size));
+
+  // The sizes are compared by division, since a corrupt header could make
+  // their products overflow
+  if (h.elements_offset < sizeof(binary_header) || h.elements_offset > file_size ||
+      h.num_elements > (file_size - h.elements_offset) / element_size) fail("file is truncated");
+  if (h.elements_offset % binary_alignment != 0) fail("the elements are not aligned");
+  if (kind == binary_kind::nested &&
+      h.num_sequences >= (h.elements_offset - sizeof(binary_header)) / sizeof(uint64_t)) {
+    fail("the offsets overlap the elements");
+  }
+}
+
+// Checks that the offsets of the inner sequences of a nested sequence
+// start at zero, are non-decreasing, and end at the number of elements
+inline void check_binary_offsets(slice<const uint64_t*, const uint64_t*> offsets, size_t num_elements) {
+  size_t n = offsets.size() - 1;
+  auto ordered = delayed_seq<bool>(n, [&](size_t i) { return offsets[i] <= offsets[i + 1]; });
+  if (offsets[0] != 0 || offsets[n] != num_elements ||
+      !internal::reduce(make_slice(ordered), logical_and<bool>())) {
+    throw_exception_or_terminate<std::runtime_error>("Invalid parlay binary file: bad offsets");
+  }
+}
+
+// Files are read and written in parallel in blocks of this many bytes
+inline constexpr size_t binary_io_block_size = size_t{1} << 22;
+
+#if defined(PARLAY_POSIX_FILE_MAP)
+
+// An open file descriptor, which is closed on destruction
+class binary_file {
+ public:
+  binary_file(const std::string& filename, int flags) : fd(::open(filename.c_str(), flags, 0644)) {
+    if (fd == -1) throw_exception_or_terminate<std::runtime_error>("Could not open " + filename);
+  }
+  ~binary_file() { ::close(fd); }
+
+  binary_file(const binary_file&) = delete;
+  binary_file& operator=(const binary_file&) = delete;
+
+  [[nodiscard]] size_t size() const { return static_cast<size_t>(::lseek(fd, 0, SEEK_END)); }
+
+  // Write the n bytes at data to the given position in the file. Safe to
+  // call concurrently for disjoint ranges of the file.
+  void write(const char* data, size_t n, size_t position) const {
+    while (n > 0) {
+      auto written = ::pwrite(fd, data, n, static_cast<off_t>(position));
+      if (written <= 0) throw_exception_or_terminate<std::runtime_error>("Error writing binary file");
+      data += written; n -= written; position += written;
+    }
+  }
+
+  // Read n bytes from the given position in the file into data. Safe
+  // to call concurrently.
+  void read(char* data, size_t n, size_t position) const {
+    while (n > 0) {
+      auto count = ::pread(fd, data, n, static_cast<off_t>(position));
+      if (count <= 0) throw_exception_or_terminate<std::runtime_error>("Error reading binary file");
+      data += count; n -= count; position += count;
+    }
+  }
+
+  static binary_file for_writing(const std::string& filename) { return {filename, O_WRONLY | O_CREAT | O_TRUNC}; }
+  static binary_file for_reading(const std::string& filename) { return {filename, O_RDONLY}; }
+
+ private:
+  int fd;
+};
+
+#else  // No POSIX I/O. Use a stream, and read and write sequentially.
+
+class binary_file {
+ public:
+  binary_file(const std::string& filename, std::ios::openmode mode) : file(filename, mode | std::ios::binary) {
+    if (!file.is_open()) throw_exception_or_terminate<std::runtime_error>("Could not open " + filename);
+  }
+
+  [[nodiscard]] size_t size() {
+    file.seekg(0, std::ios::end);
+    return static_cast<size_t>(file.tellg());
+  }
+
+  void write(const char* data, size_t n, size_t position) {
+    file.seekp(static_cast<std::streamoff>(position));
+    file.write(data, static_cast<std::streamsize>(n));
+  }
+
+  void read(char* data, size_t n, size_t position) {
+    file.seekg(static_cast<std::streamoff>(position));
+    file.read(data, static_cast<std::streamsize>(n));
+  }
+
+  static binary_file for_writing(const std::string& filename) { return {filename, std::ios::out | std::ios::trunc}; }
+  static binary_file for_reading(const std::string& filename) { return {filename, std::ios::in}; }
+
+ private:
+  std::fstream file;
+};
+
+#endif  // PARLAY_POSIX_FILE_MAP
+
+// Write or read the n bytes at data to or from the given position in the
+// file, in parallel blocks if the file supports concurrent access
+template<typename Data>
+void binary_transfer(binary_file& file, Data* data, size_t n, size_t position) {
+  size_t n_blocks = (n + binary_io_block_size - 1) / binary_io_block_size;
+  auto transfer_block = [&](size_t b) {
+    size_t start = b * binary_io_block_size;
+    size_t len = (std::min)(binary_io_block_size, n - start);
+    if constexpr (std::is_const_v<Data>) file.write(data + start, len, position + start);
+    else file.read(data + start, len, position + start);
+  };
+#if defined(PARLAY_POSIX_FILE_MAP)
+  parallel_for(0, n_blocks, transfer_block, 1);
+#else
+  for (size_t b = 0; b < n_blocks; b++) transfer_block(b);
+#endif
+}
+
+template<typename T>
+binary_header read_binary_header(binary_file& file, binary_kind kind) {
+  binary_header h{};
+  size_t file_size = file.size();
+  if (file_size < sizeof(binary_header)) {
+    throw_exception_or_terminate<std::runtime_error>("Invalid parlay binary file: file is truncated");
+  }
+  file.read(reinterpret_cast<char*>(&h), sizeof(h), 0);
+  check_binary_header(h, kind, sizeof(T), file_size);
+  return h;
+}
+
+}  // namespace internal
+
+// ----------------------------------------------------------------------------
+//                                  Writing
+// ----------------------------------------------------------------------------
+
+// Writes a sequence of trivially copyable elements to a binary file
+template<typename T, typename Alloc>
+void write_binary(const sequence<T, Alloc>& s, const std::string& filename) {
+  static_assert(std::is_trivially_copyable_v<T>, "Only sequences of trivially copyable types can be written");
+  auto h = internal::make_binary_header(internal::binary_kind::flat, sizeof(T), 0, s.size());
+  auto file = internal::binary_file::for_writing(filename);
+  file.write(reinterpret_cast<const char*>(&h), sizeof(h), 0);
+  internal::binary_transfer(file, reinterpret_cast<const char*>(s.data()), s.size() * sizeof(T), h.elements_offset);
+}
+
+// Writes a nested sequence of trivially copyable elements to a binary file.
+// The inner sequences are gathered into contiguous blocks, which are written
+// in parallel.
+template<typename T, typename InnerAlloc, typename Alloc>
+void write_binary(const sequence<sequence<T, InnerAlloc>, Alloc>& s, const std::string& filename) {
+  static_assert(std::is_trivially_copyable_v<T>, "Only sequences of trivially copyable types can be written");
+  size_t n = s.size();
+  auto offsets = sequence<uint64_t>::from_function(n + 1, [&](size_t i) -> uint64_t {
+    return (i < n) ? s[i].size() : 0;
+  });
+  size_t m = internal::scan_inplace(make_slice(offsets), plus<uint64_t>());
+
+  auto h = internal::make_binary_header(internal::binary_kind::nested, sizeof(T), n, m);
+  auto file = internal::binary_file::for_writing(filename);
+  file.write(reinterpret_cast<const char*>(&h), sizeof(h), 0);
+  internal::binary_transfer(file, reinterpret_cast<const char*>(offsets.data()), (n + 1) * sizeof(uint64_t), sizeof(h));
+
+  // Each block of elements is copied into a buffer and then written with
+  // one call, since writing each inner sequence separately would take one
+  // system call per inner sequence
+  constexpr size_t elements_per_block = (std::max)(size_t{1}, internal::binary_io_block_size / sizeof(T));
+  size_t n_blocks = (m + elements_per_block - 1) / elements_per_block;
+  auto write_block = [&](size_t b) {
+    size_t start = b * elements_per_block;
+    size_t end = (std::min)(start + elements_per_block, m);
+    auto buffer = sequence<T>::uninitialized(end - start);
+    size_t i = std::upper_bound(offsets.begin(), offsets.end(), start) - offsets.begin() - 1;
+    for (size_t j = start; j < end; i++) {
+      size_t row_end = (std::min)(static_cast<size_t>(offsets[i + 1]), end);
+      if (row_end == j) continue;
+      std::memcpy(static_cast<void*>(buffer.data() + (j - start)), s[i].data() + (j - offsets[i]), (row_end - j) * sizeof(T));
+      j = row_end;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), (end - start) * sizeof(T), h.elements_offset + start * sizeof(T));
+  };
+#if defined(PARLAY_POSIX_FILE_MAP)
+  parallel_for(0, n_blocks, write_block, 1);
+#else
+  for (size_t b = 0; b < n_blocks; b++) write_block(b);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+//                                  Reading
+// ----------------------------------------------------------------------------
+
+// Reads a sequence written by write_binary into a new sequence, in parallel
+template<typename T>
+sequence<T> read_binary(const std::string& filename) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  auto file = internal::binary_file::for_reading(filename);
+  auto h = internal::read_binary_header<T>(file, internal::binary_kind::flat);
+  auto result = sequence<T>::uninitialized(h.num_elements);
+  internal::binary_transfer(file, reinterpret_cast<char*>(result.data()), h.num_elements * sizeof(T), h.elements_offset);
+  return result;
+}
+
+// Reads a nested sequence written by write_binary into a new nested sequence.
+// The elements are read in parallel blocks into a temporary buffer, and then
+// copied into the inner sequences.
+template<typename T>
+sequence<sequence<T>> read_binary_nested(const std::string& filename) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  auto file = internal::binary_file::for_reading(filename);
+  auto h = internal::read_binary_header<T>(file, internal::binary_kind::nested);
+  size_t n = h.num_sequences;
+  auto offsets = sequence<uint64_t>::uninitialized(n + 1);
+  internal::binary_transfer(file, reinterpret_cast<char*>(offsets.data()), (n + 1) * sizeof(uint64_t), sizeof(h));
+  const uint64_t* o = offsets.data();
+  internal::check_binary_offsets(make_slice(o, o + n + 1), h.num_elements);
+  auto elements = sequence<T>::uninitialized(h.num_elements);
+  internal::binary_transfer(file, reinterpret_cast<char*>(elements.data()), h.num_elements * sizeof(T), h.elements_offset);
+  return sequence<sequence<T>>::from_function(n, [&](size_t i) {
+    return sequence<T>(elements.begin() + offsets[i], elements.begin() + offsets[i + 1]);
+  });
+}
+
+// ----------------------------------------------------------------------------
+//                              Zero-copy views
+// ----------------------------------------------------------------------------
+
+// A read-only view of a sequence in a binary file, which is mapped into
+// memory. The view owns the mapping, so it remains valid until the view is
+// destroyed. It is a random access range of const T.
+template<typename T>
+class binary_view {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  using value_type = T;
+  using reference = const T&;
+  using const_reference = const T&;
+  using iterator = const T*;
+  using const_iterator = const T*;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  explicit binary_view(const std::string& filename) : file(filename), header() {
+    header = read_header(file, internal::binary_kind::flat);
+  }
+
+  [[nodiscard]] size_t size() const { return header.num_elements; }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  [[nodiscard]] const T* data() const { return elements(file, header); }
+  const T& operator[](size_t i) const { assert(i < size()); return data()[i]; }
+
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size(); }
+
+ private:
+  template<typename>
+  friend class binary_nested_view;
+
+  static internal::binary_header read_header(const file_map& f, internal::binary_kind kind) {
+    internal::binary_header h{};
+    if (f.size() < sizeof(h)) {
+      throw_exception_or_terminate<std::runtime_error>("Invalid parlay binary file: file is truncated");
+    }
+    std::memcpy(&h, &*f.begin(), sizeof(h));
+    internal::check_binary_header(h, kind, sizeof(T), f.size());
+    return h;
+  }
+
+  static const T* elements(const file_map& f, const internal::binary_header& h) {
+    return reinterpret_cast<const T*>(&*f.begin() + h.elements_offset);
+  }
+
+  file_map file;
+  internal::binary_header header;
+};
+
+// A read-only view of a nested sequence in a binary file, which is mapped
+// into memory. It is a random access range whose elements are slices of
+// the inner sequences.
+template<typename T>
+class binary_nested_view {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  using inner_type = slice<const T*, const T*>;
+
+  using value_type = inner_type;
+  using reference = inner_type;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  // Iterates over the inner sequences
+  class const_iterator {
+    friend class binary_nested_view;
+
+    const_iterator(const binary_nested_view* parent_, size_t i_) : parent(parent_), i(i_) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = inner_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = inner_type;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    inner_type operator*() const { return (*parent)[i]; }
+    inner_type operator[](difference_type p) const { return (*parent)[i + p]; }
+
+    const_iterator& operator++() { i++; return *this; }
+    const_iterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+    const_iterator& operator--() { i--; return *this; }
+    const_iterator operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    const_iterator& operator+=(difference_type diff) { i += diff; return *this; }
+    const_iterator& operator-=(difference_type diff) { i -= diff; return *this; }
+
+    const_iterator operator+(difference_type diff) const { return const_iterator{parent, i + diff}; }
+    const_iterator operator-(difference_type diff) const { return const_iterator{parent, i - diff}; }
+    friend const_iterator operator+(difference_type diff, const const_iterator& it) { return it + diff; }
+
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(i) - static_cast<difference_type>(other.i);
+    }
+
+    bool operator==(const const_iterator& other) const { return i == other.i; }
+    bool operator!=(const const_iterator& other) const { return i != other.i; }
+    bool operator<(const const_iterator& other) const { return i < other.i; }
+    bool operator<=(const const_iterator& other) const { return i <= other.i; }
+    bool operator>(const const_iterator& other) const { return i > other.i; }
+    bool operator>=(const const_iterator& other) const { return i >= other.i; }
+
+   private:
+    const binary_nested_view* parent{nullptr};
+    size_t i{0};
+  };
+
+  using iterator = const_iterator;
+
+  explicit binary_nested_view(const std::string& filename) : file(filename), header() {
+    header = binary_view<T>::read_header(file, internal::binary_kind::nested);
+    internal::check_binary_offsets(offsets(), header.num_elements);
+  }
+
+  [[nodiscard]] size_t size() const { return header.num_sequences; }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  // The total number of elements in all of the inner sequences
+  [[nodiscard]] size_t num_elements() const { return header.num_elements; }
+
+  // The n+1 offsets of the inner sequences into the elements
+  [[nodiscard]] slice<const uint64_t*, const uint64_t*> offsets() const {
+    auto p = reinterpret_cast<const uint64_t*>(&*file.begin() + sizeof(internal::binary_header));
+    return make_slice(p, p + size() + 1);
+  }
+
+  // All of the elements of the inner sequences, concatenated
+  [[nodiscard]] slice<const T*, const T*> elements() const {
+    auto p = binary_view<T>::elements(file, header);
+    return make_slice(p, p + num_elements());
+  }
+
+  inner_type operator[](size_t i) const {
+    assert(i < size());
+    auto o = offsets();
+    return elements().cut(o[i], o[i + 1]);
+  }
+
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, size()}; }
+
+ private:
+  file_map file;
+  internal::binary_header header;
+};
+
+// Map a sequence written by write_binary into memory, without copying
+template<typename T>
+binary_view<T> map_binary(const std::string& filename) { return binary_view<T>(filename); }
+
+// Map a nested sequence written by write_binary into memory, without copying
+template<typename T>
+binary_nested_view<T> map_binary_nested(const std::string& filename) { return binary_nested_view<T>(filename); }
+
+}  // namespace parlay
+
+#endif  // PARLAY_BINARY_IO_H_
@@ -0,0 +1,306 @@
+// A bit sequence is a sequence of booleans packed into 64-bit words, i.e.,
+// one bit per flag, rather than one byte per flag as in sequence<bool>.
+// It is intended for large sets of flags, such as the flags of a pack
+// or filter, or the frontier and visited sets of a graph traversal,
+// where reading and writing 8x less memory makes a big difference.
+//
+// Counting the set bits and packing by the set bits (pack and pack_index)
+// operate on whole words at a time using popcount, and visit only the set
+// bits using count-trailing-zeros, rather than testing every flag. The
+// overloads of parlay::count, parlay::pack, and parlay::pack_index for
+// bit sequences below use these fast versions.
+//
+// Reading bits and writing bits in different words is safe concurrently.
+// Since neighbouring flags share a word, concurrently writing bits that
+// might share a word must use atomic_set or atomic_reset.
+//
+// Example:
+//
+//   parlay::bit_sequence visited(n);
+//   parlay::parallel_for(0, m, [&](size_t i) {
+//     if (visited.atomic_set(target[i])) { /* first visit */ }
+//   });
+//   auto ids = parlay::pack_index(visited);
+//
+
+#ifndef PARLAY_BIT_SEQUENCE_H_
+#define PARLAY_BIT_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "delayed_sequence.h"
+#include "monoid.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+#include "utilities.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+class bit_sequence {
+
+ public:
+  using word_type = uint64_t;
+  static inline constexpr size_t bits_per_word = 64;
+
+  using value_type = bool;
+  using reference = bool;
+  using const_reference = bool;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  // Bit sequences are read-only ranges of bools. Use set and reset to modify them.
+  class const_iterator {
+    friend class bit_sequence;
+
+    const_iterator(const bit_sequence* parent_, size_t index_) : parent(parent_), index(index_) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using reference = bool;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    bool operator*() const { return parent->test(index); }
+    bool operator[](difference_type p) const { return parent->test(index + p); }
+
+    const_iterator& operator++() { index++; return *this; }
+    const_iterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+    const_iterator& operator--() { index--; return *this; }
+    const_iterator operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    const_iterator& operator+=(difference_type diff) { index += diff; return *this; }
+    const_iterator& operator-=(difference_type diff) { index -= diff; return *this; }
+
+    const_iterator operator+(difference_type diff) const { return const_iterator{parent, index + diff}; }
+    const_iterator operator-(difference_type diff) const { return const_iterator{parent, index - diff}; }
+    friend const_iterator operator+(difference_type diff, const const_iterator& it) { return it + diff; }
+
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+    }
+
+    bool operator==(const const_iterator& other) const { return index == other.index; }
+    bool operator!=(const const_iterator& other) const { return index != other.index; }
+    bool operator<(const const_iterator& other) const { return index < other.index; }
+    bool operator<=(const const_iterator& other) const { return index <= other.index; }
+    bool operator>(const const_iterator& other) const { return index > other.index; }
+    bool operator>=(const const_iterator& other) const { return index >= other.index; }
+
+   private:
+    const bit_sequence* parent{nullptr};
+    size_t index{0};
+  };
+
+  using iterator = const_iterator;
+
+  // ------------------------- Constructors -------------------------------
+
+  bit_sequence() : n(0), words() { }
+
+  // Create a bit sequence of n bits, all of which are set to v
+  explicit bit_sequence(size_t n_, bool v = false) : n(n_), words(num_words_for(n_), v ? ~word_type{0} : 0) {
+    clear_unused_bits();
+  }
+
+  // Create a bit sequence from a random-access range of values convertible to bool
+  template<typename R, std::enable_if_t<is_random_access_range_v<R> &&
+      !std::is_same_v<std::remove_cv_t<std::remove_reference_t<R>>, bit_sequence>, int> = 0>
+  explicit bit_sequence(const R& r) : n(parlay::size(r)), words() {
+    static_assert(std::is_convertible_v<range_reference_type_t<const R>, bool>);
+    auto it = std::begin(r);
+    words = sequence<word_type>::from_function(num_words_for(n), [&](size_t w) {
+      size_t start = w * bits_per_word;
+      size_t end = (std::min)(start + bits_per_word, n);
+      word_type x = 0;
+      for (size_t i = start; i < end; i++) {
+        x |= static_cast<word_type>(static_cast<bool>(it[i])) << (i - start);
+      }
+      return x;
+    });
+  }
+
+  // Unpack the bits into a sequence<bool>
+  [[nodiscard]] sequence<bool> to_sequence() const {
+    return sequence<bool>::from_function(n, [this](size_t i) { return test(i); });
+  }
+
+  // --------------------------- Accessors --------------------------------
+
+  [[nodiscard]] size_t size() const { return n; }
+
+  [[nodiscard]] bool empty() const { return n == 0; }
+
+  [[nodiscard]] size_t num_words() const { return words.size(); }
+
+  // The underlying words. Bit i is bit (i % 64) of word (i / 64), and
+  // the unused bits of the last word are always zero.
+  [[nodiscard]] const word_type* data() const { return words.data(); }
+
+  [[nodiscard]] bool test(size_t i) const {
+    assert(i < n);
+    return (words[i / bits_per_word] >> (i % bits_per_word)) & 1;
+  }
+
+  bool operator[](size_t i) const { return test(i); }
+
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, n}; }
+
+  // --------------------------- Modifiers --------------------------------
+
+  // Set or clear bit i. Not safe to call concurrently with a write to any
+  // other bit in the same word. Use atomic_set or atomic_reset for that.
+  void set(size_t i, bool v = true) {
+    assert(i < n);
+    word_type mask = word_type{1} << (i % bits_per_word);
+    if (v) words[i / bits_per_word] |= mask;
+    else words[i / bits_per_word] &= ~mask;
+  }
+
+  void reset(size_t i) { set(i, false); }
+
+  // Atomically set bit i. Returns true if the bit was previously clear, i.e.,
+  // exactly one of any number of concurrent calls for the same bit returns true.
+  bool atomic_set(size_t i) {
+    assert(i < n);
+    word_type mask = word_type{1} << (i % bits_per_word);
+    return (atomic_word(i / bits_per_word).fetch_or(mask) & mask) == 0;
+  }
+
+  // Atomically clear bit i. Returns true if the bit was previously set.
+  bool atomic_reset(size_t i) {
+    assert(i < n);
+    word_type mask = word_type{1} << (i % bits_per_word);
+    return (atomic_word(i / bits_per_word).fetch_and(~mask) & mask) != 0;
+  }
+
+  // Set every bit to v
+  void fill(bool v) {
+    word_type x = v ? ~word_type{0} : 0;
+    parallel_for(0, num_words(), [&](size_t w) { words[w] = x; });
+    clear_unused_bits();
+  }
+
+  // ------------------------ Bulk operations -----------------------------
+
+  // Returns the number of set bits
+  [[nodiscard]] size_t count() const {
+    return internal::reduce(internal::delayed_tabulate(num_words(), [this](size_t w) {
+      return parlay::popcount(words[w]);
+    }), plus<size_t>());
+  }
+
+  // Returns the indices of the set bits, in increasing order
+  template<typename IndexType = size_t>
+  [[nodiscard]] sequence<IndexType> pack_index() const {
+    return pack_impl<IndexType>([](size_t i) { return static_cast<IndexType>(i); });
+  }
+
+  // Returns the elements of r whose corresponding bit is set, in order
+  template<typename R>
+  [[nodiscard]] auto pack(const R& r) const {
+    static_assert(is_random_access_range_v<const R>);
+    assert(parlay::size(r) >= n);
+    using T = range_value_type_t<const R>;
+    return pack_impl<T>([it = std::begin(r)](size_t i) -> T { return it[i]; });
+  }
+
+ private:
+  // Blocks of words handled by each task of the bulk operations
+  static inline constexpr size_t words_per_block = 64;
+
+  static size_t num_words_for(size_t n_) { return (n_ + bits_per_word - 1) / bits_per_word; }
+
+  void clear_unused_bits() {
+    if (n % bits_per_word != 0) {
+      words[num_words() - 1] &= (word_type{1} << (n % bits_per_word)) - 1;
+    }
+  }
+
+  std::atomic<word_type>& atomic_word(size_t w) {
+    static_assert(sizeof(std::atomic<word_type>) == sizeof(word_type));
+    return *reinterpret_cast<std::atomic<word_type>*>(&words[w]);
+  }
+
+  // Writes f(i) for each set bit i into the output in order. Each block
+  // of words counts its set bits with popcount, the counts are scanned
+  // to find each block's output offset, and then each block visits just
+  // its set bits by repeatedly extracting the lowest one.
+  template<typename T, typename F>
+  sequence<T> pack_impl(F&& f) const {
+    size_t n_blocks = (num_words() + words_per_block - 1) / words_per_block;
+    auto offsets = sequence<size_t>::from_function(n_blocks, [&](size_t b) {
+      size_t total = 0;
+      size_t end = (std::min)((b + 1) * words_per_block, num_words());
+      for (size_t w = b * words_per_block; w < end; w++) total += parlay::popcount(words[w]);
+      return total;
+    });
+    size_t m = internal::scan_inplace(make_slice(offsets), plus<size_t>());
+
+    auto result = sequence<T>::uninitialized(m);
+    parallel_for(0, n_blocks, [&](size_t b) {
+      size_t k = offsets[b];
+      size_t end = (std::min)((b + 1) * words_per_block, num_words());
+      for (size_t w = b * words_per_block; w < end; w++) {
+        for (word_type x = words[w]; x != 0; x &= x - 1) {
+          assign_uninitialized(result[k++], f(w * bits_per_word + parlay::count_trailing_zeros(x)));
+        }
+      }
+    }, 1);
+    return result;
+  }
+
+  size_t n;
+  sequence<word_type> words;
+};
+
+static_assert(is_random_access_iterator_v<bit_sequence::const_iterator>);
+static_assert(is_random_access_range_v<bit_sequence>);
+
+// Overloads of parlay::count, parlay::pack, and parlay::pack_index that
+// operate on whole words of a bit sequence at a time. They are provided for
+// each value category so that they are preferred over the generic versions.
+
+inline size_t count(const bit_sequence& b, bool value) {
+  return value ? b.count() : b.size() - b.count();
+}
+
+inline size_t count(bit_sequence& b, bool value) { return count(std::as_const(b), value); }
+inline size_t count(bit_sequence&& b, bool value) { return count(std::as_const(b), value); }
+
+template<typename R>
+auto pack(R&& r, const bit_sequence& b) { return b.pack(r); }
+
+template<typename R>
+auto pack(R&& r, bit_sequence& b) { return b.pack(r); }
+
+template<typename R>
+auto pack(R&& r, bit_sequence&& b) { return b.pack(r); }
+
+template<typename IndexType = size_t>
+auto pack_index(const bit_sequence& b) { return b.template pack_index<IndexType>(); }
+
+template<typename IndexType = size_t>
+auto pack_index(bit_sequence& b) { return b.template pack_index<IndexType>(); }
+
+template<typename IndexType = size_t>
+auto pack_index(bit_sequence&& b) { return b.template pack_index<IndexType>(); }
+
+}  // namespace parlay
+
+#endif  // PARLAY_BIT_SEQUENCE_H_
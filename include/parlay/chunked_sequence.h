@@ -0,0 +1,320 @@
+// A chunked sequence (sometimes called a rope) is a sequence that is
+// stored as a sequence of separately allocated chunks, together with
+// an index containing the offset of the first element of each chunk.
+//
+// Unlike a parlay::sequence, appending a chunked sequence to another
+// or flattening a sequence of sequences into a chunked sequence does
+// not copy any elements. Instead it takes ownership of the chunks, so
+// the cost is proportional to the number of chunks, not to the number
+// of elements. This avoids holding two copies of the data in memory
+// at once when building large outputs out of many pieces.
+//
+// A chunked sequence is a random access range, so it can be passed to
+// any parallel primitive, e.g., reduce, scan, map, or pack. Random
+// access to an element costs a binary search over the chunk offsets,
+// but iterating forward from an element is as cheap as for a
+// contiguous sequence, so primitives that process their input in
+// blocks pay for the binary search only once per block.
+//
+// Example:
+//
+//   parlay::sequence<parlay::sequence<int>> buckets = ...;
+//   auto c = parlay::flatten_chunked(std::move(buckets));   // no copy
+//   c.append(parlay::sequence<int>{1,2,3});                 // no copy
+//   auto total = parlay::reduce(c);
+//   auto flat = c.to_sequence();                            // copy if needed
+//
+
+#ifndef PARLAY_CHUNKED_SEQUENCE_H_
+#define PARLAY_CHUNKED_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "alloc.h"
+#include "monoid.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "sequence.h"
+#include "slice.h"
+#include "type_traits.h"
+#include "utilities.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+template<typename T, typename Allocator = allocator<T>>
+class chunked_sequence {
+
+ public:
+  using chunk_type = sequence<T, Allocator>;
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  template<bool Const>
+  class iterator_t {
+    friend class chunked_sequence<T, Allocator>;
+    friend class iterator_t<true>;
+
+    using parent_type = maybe_const_t<Const, chunked_sequence<T, Allocator>>;
+
+    iterator_t(parent_type* parent_, size_t index_) : parent(parent_), index(index_),
+        chunk(parent_->find_chunk(index_)) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::add_lvalue_reference_t<maybe_const_t<Const, T>>;
+    using pointer = std::add_pointer_t<maybe_const_t<Const, T>>;
+
+    iterator_t() = default;
+
+    /* implicit */ iterator_t(const iterator_t<false>& other)  // cppcheck-suppress noExplicitConstructor    // NOLINT
+        : parent(other.parent), index(other.index), chunk(other.chunk) { }
+
+    reference operator*() const {
+      assert(index < parent->size());
+      return parent->chunks[chunk][index - parent->offsets[chunk]];
+    }
+
+    reference operator[](difference_type p) const { return *(*this + p); }
+
+    // Moving forwards or backwards within a chunk is just arithmetic. Only
+    // jumping outside the current chunk requires a binary search.
+    iterator_t& operator++() {
+      assert(index < parent->size());
+      index++;
+      while (chunk < parent->num_chunks() && index == parent->offsets[chunk + 1]) chunk++;
+      return *this;
+    }
+
+    iterator_t operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+
+    iterator_t& operator--() {
+      assert(index > 0);
+      index--;
+      while (index < parent->offsets[chunk]) chunk--;
+      return *this;
+    }
+
+    iterator_t operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    iterator_t& operator+=(difference_type diff) {
+      index = static_cast<size_t>(static_cast<difference_type>(index) + diff);
+      assert(index <= parent->size());
+      if (chunk >= parent->num_chunks() || index < parent->offsets[chunk] || index >= parent->offsets[chunk + 1]) {
+        chunk = parent->find_chunk(index);
+      }
+      return *this;
+    }
+
+    iterator_t& operator-=(difference_type diff) { return *this += (-diff); }
+
+    iterator_t operator+(difference_type diff) const {
+      auto result = *this;
+      result += diff;
+      return result;
+    }
+
+    friend iterator_t operator+(difference_type diff, const iterator_t& it) { return it + diff; }
+
+    iterator_t operator-(difference_type diff) const {
+      auto result = *this;
+      result -= diff;
+      return result;
+    }
+
+    difference_type operator-(const iterator_t& other) const {
+      return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+    }
+
+    bool operator==(const iterator_t& other) const { return index == other.index; }
+    bool operator!=(const iterator_t& other) const { return index != other.index; }
+    bool operator<(const iterator_t& other) const { return index < other.index; }
+    bool operator<=(const iterator_t& other) const { return index <= other.index; }
+    bool operator>(const iterator_t& other) const { return index > other.index; }
+    bool operator>=(const iterator_t& other) const { return index >= other.index; }
+
+   private:
+    parent_type* parent{nullptr};
+    size_t index{0};
+    size_t chunk{0};
+  };
+
+  using iterator = iterator_t<false>;
+  using const_iterator = iterator_t<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static_assert(is_random_access_iterator_v<iterator>);
+  static_assert(is_random_access_iterator_v<const_iterator>);
+
+  // Create an empty chunked sequence
+  chunked_sequence() : chunks(), offsets() { }
+
+  // Create a chunked sequence consisting of a single chunk
+  explicit chunked_sequence(chunk_type&& chunk) : chunked_sequence() {
+    append(std::move(chunk));
+  }
+
+  // Create a chunked sequence whose chunks are the given sequences. The
+  // sequences are moved, not copied, so this takes O(#chunks) work.
+  explicit chunked_sequence(sequence<chunk_type>&& chunks_)
+      : chunks(std::move(chunks_)), offsets() {
+    if (chunks.empty()) return;
+    offsets = sequence<size_t>::uninitialized(chunks.size() + 1);
+    parallel_for(0, chunks.size(), [&](size_t i) { offsets[i] = chunks[i].size(); });
+    offsets[chunks.size()] = 0;
+    internal::scan_inplace(make_slice(offsets), plus<size_t>());
+  }
+
+  [[nodiscard]] size_t size() const { return offsets.empty() ? 0 : offsets.back(); }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  // Returns the number of chunks, including any empty chunks
+  [[nodiscard]] size_t num_chunks() const { return chunks.size(); }
+
+  // Returns the i'th chunk and the index of its first element
+  [[nodiscard]] const chunk_type& get_chunk(size_t i) const { return chunks[i]; }
+  [[nodiscard]] size_t get_offset(size_t i) const { return offsets[i]; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  // Random access costs a binary search over the chunk offsets
+  T& operator[](size_t i) {
+    assert(i < size());
+    size_t c = find_chunk(i);
+    return chunks[c][i - offsets[c]];
+  }
+
+  const T& operator[](size_t i) const {
+    assert(i < size());
+    size_t c = find_chunk(i);
+    return chunks[c][i - offsets[c]];
+  }
+
+  // Append the given sequence as a new chunk at the end. Does not copy
+  // its elements, and takes amortized constant time.
+  void append(chunk_type&& chunk) {
+    if (chunk.empty()) return;
+    size_t n = chunk.size();
+    if (offsets.empty()) offsets.push_back(0);
+    chunks.push_back(std::move(chunk));
+    offsets.push_back(size() + n);
+  }
+
+  // Append the chunks of another chunked sequence to the end of this one.
+  // Does not copy any elements, and takes O(other.num_chunks()) time.
+  void append(chunked_sequence&& other) {
+    if (other.empty()) return;
+    if (empty()) {
+      *this = std::move(other);
+      return;
+    }
+    size_t n = size();
+    size_t k = other.num_chunks();
+    offsets.reserve(offsets.size() + k);
+    for (size_t i = 1; i <= k; i++) {
+      offsets.push_back(n + other.offsets[i]);
+    }
+    chunks.append(std::move(other.chunks));
+    other.clear();
+  }
+
+  void clear() {
+    chunks.clear();
+    offsets.clear();
+  }
+
+  // Copy the elements into a single contiguous sequence
+  [[nodiscard]] chunk_type to_sequence() const {
+    auto res = chunk_type::uninitialized(size());
+    parallel_for(0, num_chunks(), [&](size_t i) {
+      auto out = res.begin() + offsets[i];
+      const auto& c = chunks[i];
+      parallel_for(0, c.size(), [&](size_t j) {
+        assign_uninitialized(out[j], c[j]);
+      }, 1000);
+    }, 1);
+    return res;
+  }
+
+  // Move the elements into a single contiguous sequence, leaving this empty
+  [[nodiscard]] chunk_type flatten() && {
+    auto res = chunk_type::uninitialized(size());
+    parallel_for(0, num_chunks(), [&](size_t i) {
+      auto& c = chunks[i];
+      uninitialized_relocate(c.begin(), c.end(), res.begin() + offsets[i]);
+      clear_relocated(c);
+    }, 1);
+    clear();
+    return res;
+  }
+
+ private:
+  // Returns the index of the chunk that contains element i, or num_chunks()
+  // if i == size(). Chunks may be empty, so this is the last chunk whose
+  // offset is at most i, which is always a non-empty chunk if i < size().
+  size_t find_chunk(size_t i) const {
+    if (i >= size()) return num_chunks();
+    return static_cast<size_t>(std::upper_bound(offsets.begin(), offsets.end(), i) - offsets.begin()) - 1;
+  }
+
+  // offsets[i] is the index of the first element of chunk i, and offsets[num_chunks()]
+  // is the total size. Both are empty if there are no chunks, so that an empty chunked
+  // sequence, including a moved-from one, does not allocate.
+  sequence<chunk_type> chunks;
+  sequence<size_t> offsets;
+};
+
+// Flatten a sequence of sequences into a chunked sequence without copying
+// any of the elements. Takes O(r.size()) work, and O(log r.size()) span.
+template<typename T, typename Allocator>
+chunked_sequence<T, Allocator> flatten_chunked(sequence<sequence<T, Allocator>>&& r) {
+  return chunked_sequence<T, Allocator>(std::move(r));
+}
+
+// Concatenate two sequences into a chunked sequence without copying any
+// of the elements. Takes constant work.
+template<typename T, typename Allocator>
+chunked_sequence<T, Allocator> append_chunked(sequence<T, Allocator>&& s1, sequence<T, Allocator>&& s2) {
+  chunked_sequence<T, Allocator> result(std::move(s1));
+  result.append(std::move(s2));
+  return result;
+}
+
+// Concatenate two chunked sequences without copying any of the elements.
+// Takes O(s2.num_chunks()) work.
+template<typename T, typename Allocator>
+chunked_sequence<T, Allocator> append_chunked(chunked_sequence<T, Allocator>&& s1,
+                                              chunked_sequence<T, Allocator>&& s2) {
+  chunked_sequence<T, Allocator> result(std::move(s1));
+  result.append(std::move(s2));
+  return result;
+}
+
+}  // namespace parlay
+
+#endif  // PARLAY_CHUNKED_SEQUENCE_H_
@@ -0,0 +1,217 @@
+// A graph whose adjacency lists are stored compressed. The neighbors of
+// each vertex are sorted, and then encoded using a variable-length byte
+// code: the first neighbor as its (signed) difference from the vertex
+// itself, and every other neighbor as its difference from the previous
+// one. Graphs with locality, in which neighbors have nearby ids, then
+// take one or two bytes per edge rather than sizeof(Vertex).
+//
+// Like a csr_graph, a compressed_graph is a random access range over the
+// vertices, but since the neighbors must be decoded, G[u] returns them as
+// a new parlay::sequence. Use for_each_neighbor to visit the neighbors of
+// a vertex without allocating. Decoding is sequential within a vertex and
+// parallel across vertices.
+//
+// Example:
+//
+//   auto G = parlay::csr_graph<int>::from_edges(E, n);
+//   parlay::compressed_graph<int> C(G);
+//   C.for_each_neighbor(u, [&](int v) { ... });
+//
+
+#ifndef PARLAY_COMPRESSED_GRAPH_H_
+#define PARLAY_COMPRESSED_GRAPH_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "csr_graph.h"
+#include "monoid.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+
+#include "internal/sequence_ops.h"
+#include "internal/varint.h"
+
+namespace parlay {
+
+template<typename Vertex>
+class compressed_graph {
+  static_assert(std::is_integral_v<Vertex>, "Vertex ids must be integers");
+
+ public:
+  using vertex_type = Vertex;
+  using neighbors_type = sequence<Vertex>;
+
+  using value_type = neighbors_type;
+  using reference = neighbors_type;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  // Iterates over the (decoded) neighbor lists of the vertices
+  class const_iterator {
+    friend class compressed_graph;
+
+    const_iterator(const compressed_graph* parent_, size_t u_) : parent(parent_), u(u_) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = neighbors_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = neighbors_type;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    neighbors_type operator*() const { return parent->neighbors(u); }
+    neighbors_type operator[](difference_type p) const { return parent->neighbors(u + p); }
+
+    const_iterator& operator++() { u++; return *this; }
+    const_iterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+    const_iterator& operator--() { u--; return *this; }
+    const_iterator operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    const_iterator& operator+=(difference_type diff) { u += diff; return *this; }
+    const_iterator& operator-=(difference_type diff) { u -= diff; return *this; }
+
+    const_iterator operator+(difference_type diff) const { return const_iterator{parent, u + diff}; }
+    const_iterator operator-(difference_type diff) const { return const_iterator{parent, u - diff}; }
+    friend const_iterator operator+(difference_type diff, const const_iterator& it) { return it + diff; }
+
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(u) - static_cast<difference_type>(other.u);
+    }
+
+    bool operator==(const const_iterator& other) const { return u == other.u; }
+    bool operator!=(const const_iterator& other) const { return u != other.u; }
+    bool operator<(const const_iterator& other) const { return u < other.u; }
+    bool operator<=(const const_iterator& other) const { return u <= other.u; }
+    bool operator>(const const_iterator& other) const { return u > other.u; }
+    bool operator>=(const const_iterator& other) const { return u >= other.u; }
+
+   private:
+    const compressed_graph* parent{nullptr};
+    size_t u{0};
+  };
+
+  using iterator = const_iterator;
+
+  // ------------------------- Constructors -------------------------------
+
+  // Create an empty graph with no vertices
+  compressed_graph() : edge_offsets(1, 0), byte_offsets(1, 0), bytes() { }
+
+  // Compress a graph given as a random access range of neighbor lists, such
+  // as a csr_graph<Vertex> or a parlay::sequence<parlay::sequence<Vertex>>.
+  // The neighbors of each vertex are sorted. Takes O(m log m) work.
+  template<typename R, std::enable_if_t<is_random_access_range_v<R> &&
+      !std::is_same_v<std::remove_cv_t<std::remove_reference_t<R>>, compressed_graph>, int> = 0>
+  explicit compressed_graph(const R& G) : edge_offsets(), byte_offsets(), bytes() {
+    // Sort a contiguous copy of the adjacency lists, i.e., a CSR graph
+    csr_graph<Vertex> sorted(G);
+    sorted.sort_neighbors();
+    size_t n = sorted.num_vertices();
+    edge_offsets = sorted.get_offsets();
+    const auto& edges = sorted.get_edges();
+
+    byte_offsets = sequence<size_t>::from_function(n + 1, [&](size_t u) {
+      size_t total = 0;
+      if (u < n) encode_neighbors(u, edges, [&](uint64_t x) { total += internal::varint_size(x); });
+      return total;
+    });
+    size_t total_bytes = internal::scan_inplace(make_slice(byte_offsets), plus<size_t>());
+
+    bytes = sequence<uint8_t>::uninitialized(total_bytes);
+    parallel_for(0, n, [&](size_t u) {
+      uint8_t* out = bytes.data() + byte_offsets[u];
+      encode_neighbors(u, edges, [&](uint64_t x) { out = internal::varint_encode(x, out); });
+    });
+  }
+
+  // ---------------------------- Accessors -------------------------------
+
+  [[nodiscard]] size_t size() const { return num_vertices(); }
+
+  [[nodiscard]] bool empty() const { return num_vertices() == 0; }
+
+  [[nodiscard]] size_t num_vertices() const { return edge_offsets.size() - 1; }
+
+  [[nodiscard]] size_t num_edges() const { return edge_offsets[num_vertices()]; }
+
+  [[nodiscard]] size_t degree(size_t u) const {
+    assert(u < num_vertices());
+    return edge_offsets[u + 1] - edge_offsets[u];
+  }
+
+  // The total memory used by the encoded edges and the offsets
+  [[nodiscard]] size_t size_in_bytes() const {
+    return bytes.size() + (edge_offsets.size() + byte_offsets.size()) * sizeof(size_t);
+  }
+
+  // Sequentially applies f to each neighbor of u, in increasing order
+  template<typename F>
+  void for_each_neighbor(size_t u, F&& f) const {
+    assert(u < num_vertices());
+    size_t d = degree(u);
+    if (d == 0) return;
+    const uint8_t* in = bytes.data() + byte_offsets[u];
+    uint64_t x;
+    in = internal::varint_decode(in, x);
+    auto v = static_cast<Vertex>(static_cast<int64_t>(u) + internal::zigzag_decode(x));
+    f(v);
+    for (size_t j = 1; j < d; j++) {
+      in = internal::varint_decode(in, x);
+      v = static_cast<Vertex>(v + static_cast<Vertex>(x));
+      f(v);
+    }
+  }
+
+  // Returns the neighbors of u, in increasing order
+  [[nodiscard]] neighbors_type neighbors(size_t u) const {
+    auto result = neighbors_type::uninitialized(degree(u));
+    size_t j = 0;
+    for_each_neighbor(u, [&](Vertex v) { result[j++] = v; });
+    return result;
+  }
+
+  neighbors_type operator[](size_t u) const { return neighbors(u); }
+
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, num_vertices()}; }
+
+  // Decompress into a csr_graph
+  [[nodiscard]] csr_graph<Vertex> to_csr_graph() const {
+    auto edges = sequence<Vertex>::uninitialized(num_edges());
+    parallel_for(0, num_vertices(), [&](size_t u) {
+      size_t j = edge_offsets[u];
+      for_each_neighbor(u, [&](Vertex v) { edges[j++] = v; });
+    });
+    return csr_graph<Vertex>(edge_offsets, std::move(edges));
+  }
+
+ private:
+  // Calls emit on the value to be encoded for each sorted neighbor of u
+  template<typename Edges, typename F>
+  void encode_neighbors(size_t u, const Edges& edges, F&& emit) const {
+    size_t start = edge_offsets[u], end = edge_offsets[u + 1];
+    if (start == end) return;
+    emit(internal::zigzag_encode(static_cast<int64_t>(edges[start]) - static_cast<int64_t>(u)));
+    for (size_t i = start + 1; i < end; i++) {
+      emit(static_cast<uint64_t>(edges[i] - edges[i - 1]));
+    }
+  }
+
+  sequence<size_t> edge_offsets;   // The position of each vertex's first edge, and the total
+  sequence<size_t> byte_offsets;   // The position of each vertex's first encoded byte
+  sequence<uint8_t> bytes;         // The encoded edges
+};
+
+}  // namespace parlay
+
+#endif  // PARLAY_COMPRESSED_GRAPH_H_
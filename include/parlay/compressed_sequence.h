@@ -0,0 +1,202 @@
+// A compressed sequence stores a sorted (non-decreasing) sequence of
+// integers, such as a large set of ids, using far less memory than a
+// plain sequence. The elements are split into blocks of a fixed size.
+// For each block, the first element and the byte offset of the block
+// are stored in an index, and the differences between the remaining
+// consecutive elements are stored using a variable-length byte code,
+// so that small gaps take one byte rather than sizeof(T).
+//
+// Every block is encoded and decoded independently, so construction,
+// decompression (to_sequence), and traversal (for_each) are parallel
+// across blocks. Accessing a single element only decodes its block,
+// which takes O(block_size) time, and lower_bound does a binary search
+// over the index followed by a scan of one block.
+//
+// Example:
+//
+//   auto ids = parlay::sort(...);
+//   parlay::compressed_sequence<uint64_t> c(ids);
+//   uint64_t x = c[i];
+//   parlay::for_each(c, [&](uint64_t v) { ... });
+//   parlay::sequence<uint64_t> decoded = c.to_sequence();
+//
+
+#ifndef PARLAY_COMPRESSED_SEQUENCE_H_
+#define PARLAY_COMPRESSED_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "monoid.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+
+#include "internal/sequence_ops.h"
+#include "internal/varint.h"
+
+namespace parlay {
+
+template<typename T>
+class compressed_sequence {
+  static_assert(std::is_integral_v<T>, "compressed_sequence only holds integers");
+
+  using unsigned_type = std::make_unsigned_t<T>;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // The number of elements in each block
+  static inline constexpr size_t block_size = 128;
+
+  // ------------------------- Constructors -------------------------------
+
+  compressed_sequence() : n(0), firsts(), offsets(1, 0), bytes() { }
+
+  // Compress the given random access range, which must be sorted in
+  // non-decreasing order. Takes O(n) work and O(log n) span.
+  template<typename R, std::enable_if_t<is_random_access_range_v<R> &&
+      !std::is_same_v<std::remove_cv_t<std::remove_reference_t<R>>, compressed_sequence>, int> = 0>
+  explicit compressed_sequence(const R& r) : n(parlay::size(r)), firsts(), offsets(), bytes() {
+    auto it = std::begin(r);
+    size_t n_blocks = num_blocks();
+    firsts = sequence<T>::from_function(n_blocks, [&](size_t b) -> T { return it[b * block_size]; });
+
+    offsets = sequence<size_t>::from_function(n_blocks + 1, [&](size_t b) {
+      size_t total = 0;
+      if (b < n_blocks) {
+        for (size_t i = b * block_size + 1; i < block_end(b); i++) {
+          assert(!(it[i] < it[i - 1]) && "compressed_sequence requires a sorted input");
+          total += internal::varint_size(delta(it[i - 1], it[i]));
+        }
+      }
+      return total;
+    }, 1);
+    size_t total_bytes = internal::scan_inplace(make_slice(offsets), plus<size_t>());
+
+    bytes = sequence<uint8_t>::uninitialized(total_bytes);
+    parallel_for(0, n_blocks, [&](size_t b) {
+      uint8_t* out = bytes.data() + offsets[b];
+      for (size_t i = b * block_size + 1; i < block_end(b); i++) {
+        out = internal::varint_encode(delta(it[i - 1], it[i]), out);
+      }
+    }, 1);
+  }
+
+  // --------------------------- Accessors --------------------------------
+
+  [[nodiscard]] size_t size() const { return n; }
+
+  [[nodiscard]] bool empty() const { return n == 0; }
+
+  [[nodiscard]] size_t num_blocks() const { return (n + block_size - 1) / block_size; }
+
+  // The total memory used by the encoded elements and the block index
+  [[nodiscard]] size_t size_in_bytes() const {
+    return bytes.size() + firsts.size() * sizeof(T) + offsets.size() * sizeof(size_t);
+  }
+
+  // Returns the i'th element. Takes O(block_size) time.
+  T operator[](size_t i) const {
+    assert(i < n);
+    size_t b = i / block_size;
+    T result = firsts[b];
+    const uint8_t* in = bytes.data() + offsets[b];
+    for (size_t j = b * block_size; j < i; j++) in = next(in, result);
+    return result;
+  }
+
+  // Returns the index of the first element that is not less than x,
+  // or size() if there is no such element
+  [[nodiscard]] size_t lower_bound(const T& x) const {
+    // The answer is either in the last block whose first element is less
+    // than x, or it is the first element of the block after it
+    size_t b = std::lower_bound(firsts.begin(), firsts.end(), x) - firsts.begin();
+    if (b == 0) return 0;
+    b--;
+    size_t i = b * block_size;
+    T value = firsts[b];
+    const uint8_t* in = bytes.data() + offsets[b];
+    while (value < x && ++i < block_end(b)) in = next(in, value);
+    return i;
+  }
+
+  // --------------------------- Traversal --------------------------------
+
+  // Sequentially applies f(i, x) to each element x of block b, where i is
+  // the position of x in the sequence
+  template<typename F>
+  void decode_block(size_t b, F&& f) const {
+    assert(b < num_blocks());
+    T value = firsts[b];
+    const uint8_t* in = bytes.data() + offsets[b];
+    size_t end = block_end(b);
+    f(b * block_size, value);
+    for (size_t i = b * block_size + 1; i < end; i++) {
+      in = next(in, value);
+      f(i, value);
+    }
+  }
+
+  // Applies f to every element, in parallel across blocks
+  template<typename F>
+  void for_each(F&& f) const {
+    parallel_for(0, num_blocks(), [&](size_t b) {
+      decode_block(b, [&](size_t, T x) { f(x); });
+    }, 1);
+  }
+
+  // Decompress into a plain sequence
+  [[nodiscard]] sequence<T> to_sequence() const {
+    auto result = sequence<T>::uninitialized(n);
+    parallel_for(0, num_blocks(), [&](size_t b) {
+      decode_block(b, [&](size_t i, T x) { result[i] = x; });
+    }, 1);
+    return result;
+  }
+
+ private:
+  size_t block_end(size_t b) const { return (std::min)((b + 1) * block_size, n); }
+
+  static uint64_t delta(T prev, T cur) {
+    return static_cast<uint64_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(cur) -
+                                                            static_cast<unsigned_type>(prev)));
+  }
+
+  // Decode the next gap from in and add it to value
+  static const uint8_t* next(const uint8_t* in, T& value) {
+    uint64_t d;
+    in = internal::varint_decode(in, d);
+    value = static_cast<T>(static_cast<unsigned_type>(value) + static_cast<unsigned_type>(d));
+    return in;
+  }
+
+  size_t n;
+  sequence<T> firsts;         // The first element of each block
+  sequence<size_t> offsets;   // The byte offset of each block's gaps, and the total
+  sequence<uint8_t> bytes;    // The encoded gaps
+};
+
+// Overloads of parlay::for_each for compressed sequences, which decode
+// each block sequentially. They are provided for each value category so
+// that they are preferred over the generic version for ranges.
+
+template<typename T, typename F>
+void for_each(const compressed_sequence<T>& c, F&& f) { c.for_each(std::forward<F>(f)); }
+
+template<typename T, typename F>
+void for_each(compressed_sequence<T>& c, F&& f) { c.for_each(std::forward<F>(f)); }
+
+template<typename T, typename F>
+void for_each(compressed_sequence<T>&& c, F&& f) { c.for_each(std::forward<F>(f)); }
+
+}  // namespace parlay
+
+#endif  // PARLAY_COMPRESSED_SEQUENCE_H_
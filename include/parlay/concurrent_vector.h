@@ -0,0 +1,182 @@
+// A concurrent vector is an append-only buffer that many tasks can push
+// elements into in parallel, which can then be finalized into a single
+// contiguous parlay::sequence. This is useful for building the output of
+// loops in which each iteration produces an irregular number of results,
+// since it avoids the separate count, scan, and pack passes of filter or
+// map_maybe, and so only evaluates the (possibly expensive) condition once.
+//
+// Each worker appends to its own buffer, so push_back does not require any
+// synchronization. The order of the elements in the result is therefore
+// not deterministic. If the order matters, use filter or pack instead.
+//
+// A worker that waits for forked work can run another task of the same
+// loop, which may push onto the same buffer, so a buffer must never be
+// modified across a fork. Each buffer is therefore a list of blocks, which
+// are allocated with doubling capacities and never relocated, and elements
+// are constructed before they are added, so pushing an element never forks.
+//
+// Example:
+//
+//   parlay::concurrent_vector<int> out;
+//   parlay::parallel_for(0, n, [&](size_t i) {
+//     if (expensive_test(i)) out.push_back(i);
+//   });
+//   parlay::sequence<int> result = out.finalize();
+//
+// A concurrent vector must only be used within the scheduler instance
+// in which it was created, since it is built on parlay::WorkerSpecific.
+//
+
+#ifndef PARLAY_CONCURRENT_VECTOR_H_
+#define PARLAY_CONCURRENT_VECTOR_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "alloc.h"
+#include "chunked_sequence.h"
+#include "monoid.h"
+#include "parallel.h"
+#include "relocation.h"
+#include "sequence.h"
+#include "slice.h"
+#include "worker_specific.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+template<typename T, typename Allocator = allocator<T>>
+class concurrent_vector {
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using sequence_type = sequence<T, Allocator>;
+
+  concurrent_vector() = default;
+
+  concurrent_vector(const concurrent_vector&) = delete;
+  concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+  // Append an element to the calling worker's buffer. Safe to call concurrently
+  // from any number of tasks, but not concurrently with finalize, size, or clear.
+  void push_back(const T& x) { emplace_back(x); }
+  void push_back(T&& x) { emplace_back(std::move(x)); }
+
+  // The element is constructed before it is added to the buffer, since
+  // its constructor might fork
+  template<typename... Args>
+  void emplace_back(Args&&... args) {
+    T x(std::forward<Args>(args)...);
+    auto& b = *buffers;
+    if (b.current.size() == b.current.capacity()) {
+      size_t new_capacity = (std::max)(initial_block_size, 2 * b.current.capacity());
+      if (!b.current.empty()) b.blocks.push_back(std::move(b.current));
+      b.current = sequence_type();
+      b.current.reserve(new_capacity);    // Nothing to relocate, so does not fork
+    }
+    b.current.push_back(std::move(x));
+    b.size++;
+  }
+
+  // Append a range of elements to the calling worker's buffer. The elements
+  // are contiguous in the result. They are copied (or moved, if r is an
+  // rvalue sequence) into a new block before it is added to the buffer.
+  template<typename R>
+  void append(R&& r) {
+    sequence_type block;
+    block.assign(std::forward<R>(r));
+    if (block.empty()) return;
+    auto& b = *buffers;
+    b.size += block.size();
+    b.blocks.push_back(std::move(block));
+  }
+
+  // Returns the total number of elements in all of the buffers
+  [[nodiscard]] size_t size() const {
+    size_t total = 0;
+    for (const auto& b : buffers) total += b.size;
+    return total;
+  }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  // Move the elements of every buffer into a single contiguous sequence,
+  // leaving the concurrent vector empty. Takes O(n) work and O(log n) span.
+  [[nodiscard]] sequence_type finalize() {
+    auto blocks = all_blocks();
+    size_t n_blocks = blocks.size();
+    auto offsets = sequence<size_t>::from_function(n_blocks + 1, [&](size_t i) {
+      return i < n_blocks ? blocks[i]->size() : 0;
+    });
+    size_t n = internal::scan_inplace(make_slice(offsets), plus<size_t>());
+
+    auto result = sequence_type::uninitialized(n);
+    parallel_for(0, n_blocks, [&](size_t i) {
+      auto& b = *blocks[i];
+      auto out = result.begin() + offsets[i];
+      size_t n_pieces = (b.size() + relocate_block_size - 1) / relocate_block_size;
+      parallel_for(0, n_pieces, [&](size_t j) {
+        size_t start = j * relocate_block_size;
+        size_t end = (std::min)(start + relocate_block_size, b.size());
+        uninitialized_relocate(b.begin() + start, b.begin() + end, out + start);
+      }, 1);
+      clear_relocated(b);
+    }, 1);
+    clear();
+    return result;
+  }
+
+  // Move the blocks into a chunked sequence, without copying any of the elements,
+  // leaving the concurrent vector empty. Takes O(num_workers() log n) work.
+  [[nodiscard]] chunked_sequence<T, Allocator> finalize_chunked() {
+    chunked_sequence<T, Allocator> result;
+    for (auto* b : all_blocks()) result.append(std::move(*b));
+    clear();
+    return result;
+  }
+
+  // Destroy every element in every buffer
+  void clear() {
+    for (auto& b : buffers) {
+      b.blocks.clear();
+      b.current.clear();
+      b.size = 0;
+    }
+  }
+
+ private:
+  static inline constexpr size_t relocate_block_size = 2048;
+  static inline constexpr size_t initial_block_size = 64;
+
+  // The blocks of a worker are kept in a std::vector, whose growth moves
+  // them one at a time without forking, which needs a noexcept move
+  static_assert(std::is_nothrow_move_constructible_v<sequence_type>);
+
+  struct buffer {
+    std::vector<sequence_type> blocks;    // Full blocks, and appended ranges
+    sequence_type current;                // The block that push_back fills
+    size_t size = 0;
+  };
+
+  // The non-empty blocks of every buffer
+  std::vector<sequence_type*> all_blocks() {
+    std::vector<sequence_type*> result;
+    for (auto& b : buffers) {
+      for (auto& block : b.blocks) result.push_back(&block);
+      if (!b.current.empty()) result.push_back(&b.current);
+    }
+    return result;
+  }
+
+  WorkerSpecific<buffer> buffers;
+};
+
+}  // namespace parlay
+
+#endif  // PARLAY_CONCURRENT_VECTOR_H_
@@ -0,0 +1,261 @@
+// A graph in compressed sparse row (CSR) format. The out-neighbors of
+// every vertex are stored contiguously in a single array of edges, and
+// an array of n+1 offsets gives the position of each vertex's first
+// out-edge. Compared to a sequence of sequences of neighbors, this uses
+// two allocations in total rather than one per vertex, needs only one
+// offset per vertex rather than a whole sequence header, and stores the
+// neighbors of consecutive vertices next to each other in memory.
+//
+// A csr_graph is a random access range whose elements are the (read-only)
+// neighbor lists of each vertex, so code written for graphs represented
+// as parlay::sequence<parlay::sequence<vertex>>, e.g., G.size(), G[u],
+// and parlay::map(G, ...), also works on a csr_graph.
+//
+// The Weight parameter is optional. If it is given, each edge is stored
+// as a std::pair<Vertex, Weight> of its target and weight.
+//
+// Example:
+//
+//   parlay::sequence<std::pair<int,int>> E = ...;
+//   auto G = parlay::csr_graph<int>::from_edges(E, n);
+//   auto GT = G.transpose();
+//   for (int v : G[u]) { ... }
+//
+
+#ifndef PARLAY_CSR_GRAPH_H_
+#define PARLAY_CSR_GRAPH_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "delayed_sequence.h"
+#include "monoid.h"
+#include "primitives.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+#include "utilities.h"
+
+#include "internal/integer_sort.h"
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+template<typename Vertex, typename Weight = void>
+class csr_graph {
+  static_assert(std::is_integral_v<Vertex>, "Vertex ids must be integers");
+
+ public:
+  using vertex_type = Vertex;
+  using weight_type = Weight;
+  using edge_type = std::conditional_t<std::is_void_v<Weight>, Vertex, std::pair<Vertex, Weight>>;
+  using neighbors_type = slice<const edge_type*, const edge_type*>;
+
+  using value_type = neighbors_type;
+  using reference = neighbors_type;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  // Iterates over the neighbor lists of the vertices
+  class const_iterator {
+    friend class csr_graph;
+
+    const_iterator(const csr_graph* parent_, size_t u_) : parent(parent_), u(u_) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = neighbors_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = neighbors_type;
+    using pointer = void;
+
+    const_iterator() = default;
+
+    neighbors_type operator*() const { return parent->neighbors(u); }
+    neighbors_type operator[](difference_type p) const { return parent->neighbors(u + p); }
+
+    const_iterator& operator++() { u++; return *this; }
+    const_iterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+    const_iterator& operator--() { u--; return *this; }
+    const_iterator operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    const_iterator& operator+=(difference_type diff) { u += diff; return *this; }
+    const_iterator& operator-=(difference_type diff) { u -= diff; return *this; }
+
+    const_iterator operator+(difference_type diff) const { return const_iterator{parent, u + diff}; }
+    const_iterator operator-(difference_type diff) const { return const_iterator{parent, u - diff}; }
+    friend const_iterator operator+(difference_type diff, const const_iterator& it) { return it + diff; }
+
+    difference_type operator-(const const_iterator& other) const {
+      return static_cast<difference_type>(u) - static_cast<difference_type>(other.u);
+    }
+
+    bool operator==(const const_iterator& other) const { return u == other.u; }
+    bool operator!=(const const_iterator& other) const { return u != other.u; }
+    bool operator<(const const_iterator& other) const { return u < other.u; }
+    bool operator<=(const const_iterator& other) const { return u <= other.u; }
+    bool operator>(const const_iterator& other) const { return u > other.u; }
+    bool operator>=(const const_iterator& other) const { return u >= other.u; }
+
+   private:
+    const csr_graph* parent{nullptr};
+    size_t u{0};
+  };
+
+  using iterator = const_iterator;
+
+  // ------------------------- Constructors -------------------------------
+
+  // Create an empty graph with no vertices
+  csr_graph() : offsets(1, 0), edges() { }
+
+  // Create a graph from its offsets (of size n+1, with offsets[n] == m)
+  // and edges (of size m), which are taken by value to allow moving
+  csr_graph(sequence<size_t> offsets_, sequence<edge_type> edges_)
+      : offsets(std::move(offsets_)), edges(std::move(edges_)) {
+    assert(offsets.size() >= 1);
+    assert(offsets[offsets.size() - 1] == edges.size());
+  }
+
+  // Create a graph from a random access range of neighbor lists, e.g.,
+  // a parlay::sequence<parlay::sequence<edge_type>>
+  template<typename R, std::enable_if_t<is_random_access_range_v<R> &&
+      !std::is_same_v<std::remove_cv_t<std::remove_reference_t<R>>, csr_graph>, int> = 0>
+  explicit csr_graph(const R& G) : offsets(), edges() {
+    static_assert(is_random_access_range_v<range_reference_type_t<const R>>);
+    size_t n = parlay::size(G);
+    auto it = std::begin(G);
+    offsets = sequence<size_t>::from_function(n + 1, [&](size_t u) {
+      return (u < n) ? parlay::size(it[u]) : size_t{0};
+    });
+    size_t m = internal::scan_inplace(make_slice(offsets), plus<size_t>());
+    edges = sequence<edge_type>::uninitialized(m);
+    parallel_for(0, n, [&](size_t u) {
+      auto&& nghs = it[u];
+      auto out = edges.begin() + offsets[u];
+      auto in = std::begin(nghs);
+      parallel_for(0, parlay::size(nghs), [&](size_t j) {
+        assign_uninitialized(out[j], in[j]);
+      }, 1000);
+    });
+  }
+
+  // Build a graph on n vertices from a random access range of edges. For an
+  // unweighted graph, each edge is a pair (u, v). For a weighted graph, each
+  // edge is a tuple (u, v, w). Each vertex's edges are kept in the order that
+  // they appear in the input. Uses a parallel integer sort on the sources,
+  // which takes O(m + n) work.
+  template<typename R>
+  static csr_graph from_edges(const R& E, size_t n) {
+    static_assert(is_random_access_range_v<const R>);
+    size_t m = parlay::size(E);
+    if (m == 0) return csr_graph(sequence<size_t>(n + 1, 0), sequence<edge_type>());
+
+    auto get_source = [](const auto& e) { return static_cast<size_t>(std::get<0>(e)); };
+    auto [sorted, counts] = internal::integer_sort_with_counts(make_slice(E), get_source, n);
+
+    counts.push_back(0);
+    internal::scan_inplace(make_slice(counts), plus<size_t>());
+    auto out_edges = sequence<edge_type>::from_function(m, [&](size_t i) { return make_edge(sorted[i]); });
+    return csr_graph(std::move(counts), std::move(out_edges));
+  }
+
+  // ---------------------------- Accessors -------------------------------
+
+  [[nodiscard]] size_t size() const { return num_vertices(); }
+
+  [[nodiscard]] bool empty() const { return num_vertices() == 0; }
+
+  [[nodiscard]] size_t num_vertices() const { return offsets.size() - 1; }
+
+  [[nodiscard]] size_t num_edges() const { return edges.size(); }
+
+  [[nodiscard]] size_t degree(size_t u) const {
+    assert(u < num_vertices());
+    return offsets[u + 1] - offsets[u];
+  }
+
+  [[nodiscard]] neighbors_type neighbors(size_t u) const {
+    assert(u < num_vertices());
+    return make_slice(edges.data() + offsets[u], edges.data() + offsets[u + 1]);
+  }
+
+  neighbors_type operator[](size_t u) const { return neighbors(u); }
+
+  const_iterator begin() const { return const_iterator{this, 0}; }
+  const_iterator end() const { return const_iterator{this, num_vertices()}; }
+
+  // The underlying arrays. The edges of vertex u are at positions
+  // [offsets[u], offsets[u+1]) of the edge array.
+  [[nodiscard]] const sequence<size_t>& get_offsets() const { return offsets; }
+  [[nodiscard]] const sequence<edge_type>& get_edges() const { return edges; }
+
+  // Returns the target vertex of an edge
+  static Vertex target(const edge_type& e) {
+    if constexpr (std::is_void_v<Weight>) return e;
+    else return e.first;
+  }
+
+  // ---------------------------- Operations ------------------------------
+
+  // Returns the graph with every edge reversed. The in-neighbors of each
+  // vertex are listed in increasing order of their source vertex.
+  [[nodiscard]] csr_graph transpose() const {
+    auto sources = sources_of_edges();
+    auto reversed = internal::delayed_tabulate(num_edges(), [&](size_t i) {
+      if constexpr (std::is_void_v<Weight>) return std::make_pair(edges[i], sources[i]);
+      else return std::make_tuple(edges[i].first, sources[i], edges[i].second);
+    });
+    return from_edges(reversed, num_vertices());
+  }
+
+  // Sort the neighbors of every vertex by their target
+  void sort_neighbors() {
+    parallel_for(0, num_vertices(), [&](size_t u) {
+      auto nghs = edges.cut(offsets[u], offsets[u + 1]);
+      if constexpr (std::is_void_v<Weight>) sort_inplace(nghs);
+      else sort_inplace(nghs, [](const auto& a, const auto& b) { return a.first < b.first; });
+    }, 1);
+  }
+
+  // Returns the sequence of edges as (u, v) pairs, or (u, v, w) tuples
+  // for a weighted graph, in order of their source vertex
+  [[nodiscard]] auto to_edges() const {
+    auto sources = sources_of_edges();
+    return internal::tabulate(num_edges(), [&](size_t i) {
+      if constexpr (std::is_void_v<Weight>) return std::make_pair(sources[i], edges[i]);
+      else return std::make_tuple(sources[i], edges[i].first, edges[i].second);
+    });
+  }
+
+ private:
+  template<typename E>
+  static edge_type make_edge(const E& e) {
+    if constexpr (std::is_void_v<Weight>) return static_cast<Vertex>(std::get<1>(e));
+    else return edge_type(static_cast<Vertex>(std::get<1>(e)), std::get<2>(e));
+  }
+
+  // The source vertex of each edge
+  sequence<Vertex> sources_of_edges() const {
+    auto sources = sequence<Vertex>::uninitialized(num_edges());
+    parallel_for(0, num_vertices(), [&](size_t u) {
+      parallel_for(offsets[u], offsets[u + 1], [&](size_t i) {
+        sources[i] = static_cast<Vertex>(u);
+      }, 2048);
+    });
+    return sources;
+  }
+
+  sequence<size_t> offsets;
+  sequence<edge_type> edges;
+};
+
+}  // namespace parlay
+
+#endif  // PARLAY_CSR_GRAPH_H_
@@ -0,0 +1,165 @@
+// An allocator that backs its storage with memory-mapped temporary files,
+// so that containers can hold datasets that are larger than main memory,
+// with the operating system paging their contents in and out as required.
+//
+// Usage:
+//    parlay::sequence<int, parlay::file_allocator<int>> s(n);
+//
+// Each allocation creates its own unlinked temporary file in the directory
+// given by parlay::set_file_allocator_directory (by default, the directory
+// named by the TMPDIR environment variable, or /tmp). The file is removed
+// automatically when the allocation is freed, or when the program exits.
+//
+// Since every allocation creates a new file, this allocator is only suitable
+// for large buffers, e.g., for flat sequences of trivial types. It should not
+// be used for many small allocations, e.g., for sequences of sequences.
+//
+// On platforms that do not support memory-mapped files, the allocator falls
+// back to allocating from parlay::allocator, i.e., from main memory.
+
+#ifndef PARLAY_FILE_ALLOCATOR_H_
+#define PARLAY_FILE_ALLOCATOR_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "alloc.h"
+
+#include "internal/file_map.h"   // for PARLAY_POSIX_FILE_MAP
+
+#if defined(PARLAY_POSIX_FILE_MAP)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#endif
+
+namespace parlay {
+
+// Hints given to the operating system about the access pattern of a
+// file-backed allocation, which control how aggressively it reads ahead.
+enum class file_access {
+  normal,        // No particular access pattern
+  sequential,    // Accessed mostly in order, e.g., by scan, map, or copy
+  random,        // Accessed mostly in random order, e.g., by gather or hashing
+};
+
+namespace internal {
+
+inline std::string& file_allocator_directory() {
+  static std::string directory = []() -> std::string {
+    const char* tmpdir = std::getenv("TMPDIR");
+    return (tmpdir != nullptr && *tmpdir != '\0') ? tmpdir : "/tmp";
+  }();
+  return directory;
+}
+
+#if defined(PARLAY_POSIX_FILE_MAP)
+
+// Map a new unlinked temporary file of n bytes into memory
+inline void* map_temporary_file(size_t n, file_access access) {
+  std::string name = file_allocator_directory() + "/parlay-XXXXXX";
+  int fd = ::mkstemp(name.data());
+  if (fd == -1) throw std::bad_alloc();
+
+  // Unlink immediately so that the file is removed once it is unmapped,
+  // even if the program does not exit cleanly
+  ::unlink(name.c_str());
+
+  if (::ftruncate(fd, static_cast<off_t>(n)) == -1) {
+    ::close(fd);
+    throw std::bad_alloc();
+  }
+
+  void* p = ::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::bad_alloc();
+
+  if (access == file_access::sequential) {
+    ::posix_madvise(p, n, POSIX_MADV_SEQUENTIAL);
+  }
+  else if (access == file_access::random) {
+    ::posix_madvise(p, n, POSIX_MADV_RANDOM);
+  }
+  return p;
+}
+
+inline void unmap_temporary_file(void* p, size_t n) {
+  [[maybe_unused]] int result = ::munmap(p, n);
+  assert(result == 0);
+}
+
+#endif  // PARLAY_POSIX_FILE_MAP
+
+}  // namespace internal
+
+// Set the directory in which file_allocator creates its temporary files.
+// Only affects subsequent allocations. Not safe to call concurrently with
+// allocations by file_allocator.
+inline void set_file_allocator_directory(std::string directory) {
+  internal::file_allocator_directory() = std::move(directory);
+}
+
+// Returns the directory in which file_allocator creates its temporary files
+inline const std::string& get_file_allocator_directory() {
+  return internal::file_allocator_directory();
+}
+
+// A container allocator for arrays of type T whose storage is backed by
+// memory-mapped temporary files. The Access parameter gives a hint to the
+// operating system about how the storage will be accessed.
+//
+// Matches the c++ Allocator specification (minimally), and is stateless,
+// so it can be used as the allocator of a parlay::sequence, e.g.:
+//    parlay::sequence<int, parlay::file_allocator<int, parlay::file_access::sequential>>
+//
+template<typename T, file_access Access = file_access::normal>
+struct file_allocator {
+  using value_type = T;
+
+  template<typename U>
+  struct rebind { using other = file_allocator<U, Access>; };
+
+  T* allocate(size_t n) {
+#if defined(PARLAY_POSIX_FILE_MAP)
+    static_assert(alignof(T) <= 4096, "file_allocator only guarantees page alignment");
+    if (n > (std::numeric_limits<size_t>::max)() / sizeof(T)) throw std::bad_alloc();
+    return static_cast<T*>(internal::map_temporary_file(bytes(n), Access));
+#else
+    return allocator<T>{}.allocate(n);
+#endif
+  }
+
+  void deallocate(T* ptr, size_t n) {
+#if defined(PARLAY_POSIX_FILE_MAP)
+    internal::unmap_temporary_file(static_cast<void*>(ptr), bytes(n));
+#else
+    allocator<T>{}.deallocate(ptr, n);
+#endif
+  }
+
+  constexpr file_allocator() = default;
+  template<class U> /* implicit */ constexpr file_allocator(const file_allocator<U, Access>&) noexcept { }
+
+ private:
+  // Zero-length mappings are not permitted, so always map at least one byte
+  static size_t bytes(size_t n) { return (n == 0) ? 1 : n * sizeof(T); }
+};
+
+static_assert(std::is_trivially_copyable_v<file_allocator<int>>);
+
+template<class T, class U, file_access Access>
+bool operator==(const file_allocator<T, Access>&, const file_allocator<U, Access>&) { return true; }
+template<class T, class U, file_access Access>
+bool operator!=(const file_allocator<T, Access>&, const file_allocator<U, Access>&) { return false; }
+
+}  // namespace parlay
+
+#endif  // PARLAY_FILE_ALLOCATOR_H_
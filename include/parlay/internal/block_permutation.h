@@ -0,0 +1,301 @@
+
+#ifndef PARLAY_INTERNAL_BLOCK_PERMUTATION_H_
+#define PARLAY_INTERNAL_BLOCK_PERMUTATION_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include "sequence_ops.h"
+#include "uninitialized_sequence.h"
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../range.h"
+#include "../relocation.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../type_traits.h"
+#include "../utilities.h"
+
+namespace parlay {
+
+// The algorithm used by the in-place sorts
+enum class sort_mode {
+  standard,     // The default algorithm of the sort
+  low_memory,   // An unstable sort that permutes the input in place, using only
+                // a few small blocks of extra memory per worker and bucket
+};
+
+namespace internal {
+
+// In-place distribution of a sequence into buckets, as used by the in-place
+// super scalar sample sort (IPS4o) and radix sort (IPS2Ra) of Axtmann, Witt,
+// Ferizovic and Sanders, "Engineering In-place (Shared-memory) Sorting
+// Algorithms". The elements are moved in blocks, and only O(P * buckets)
+// blocks of extra memory are used for P tasks. There are four phases:
+//
+//  1. Classification: The input is split into one stripe per task. Each task
+//     moves the elements of its stripe into a small buffer per bucket, and
+//     whenever a buffer fills up, writes it back as a full block to the part
+//     of its stripe that it has already read.
+//  2. Compaction: The full blocks are moved to the front of the input, so
+//     that the region of blocks reserved for each bucket consists of full
+//     blocks that are yet to be placed, followed by empty blocks.
+//  3. Block permutation: Each task repeatedly picks up an unplaced block and
+//     swaps it into the next block of the region of its bucket, until it
+//     reaches an empty block.
+//  4. Cleanup: The regions are aligned to blocks rather than to the bucket
+//     boundaries, so the elements of a region that spill over into the next
+//     bucket are moved back, and the gaps are filled from the buffers.
+
+// Blocks are the unit in which elements are moved between the buffers and
+// the input. They should be large enough to amortize the synchronization in
+// the block permutation, but small enough that the buffers fit in cache.
+template<typename T>
+inline constexpr size_t inplace_block_size = (std::max)(size_t{1}, size_t{2048} / sizeof(T));
+
+// Relocates n objects sequentially. Used for moving blocks, which are too
+// small to be worth relocating in parallel.
+template<typename InIterator, typename OutIterator>
+void seq_uninitialized_relocate_n(InIterator in, size_t n, OutIterator out) {
+  using T = iterator_value_type_t<OutIterator>;
+  if constexpr (is_trivially_relocatable_v<T> && std::is_same_v<iterator_value_type_t<InIterator>, T> &&
+                is_contiguous_iterator_v<InIterator> && is_contiguous_iterator_v<OutIterator>) {
+    std::memcpy(static_cast<void*>(std::addressof(*out)), static_cast<void*>(std::addressof(*in)), n * sizeof(T));
+  }
+  else {
+    for (size_t i = 0; i < n; i++) {
+      relocate_or_move_and_destroy(in[i], out[i]);
+    }
+  }
+}
+
+// The shared state of the region of a bucket during the block permutation.
+// The blocks [write, read) of the region hold full blocks that are yet to be
+// placed, and the blocks after read are empty, or are being read by one of
+// the tasks counted by reading.
+struct block_permutation_region {
+  std::atomic<bool> locked{false};
+  size_t write{0};
+  size_t read{0};
+  std::atomic<size_t> reading{0};
+  char padding[32];     // Avoid false sharing between the regions
+
+  template<typename F>
+  static void spin_until(F&& done) {
+    for (size_t spins = 0; !done(); spins++) {
+      if (spins >= 64) std::this_thread::yield();
+    }
+  }
+
+  void lock() {
+    spin_until([&]() { return !locked.exchange(true, std::memory_order_acquire); });
+  }
+
+  void unlock() { locked.store(false, std::memory_order_release); }
+};
+
+// Distributes A into num_buckets buckets in place, and returns the offsets
+// of the buckets. classify(first, m, buckets) must write the bucket of each
+// of the m elements starting at the iterator first to buckets[0, m), where
+// first is either an iterator of A or a pointer to a buffer.
+template <typename Iterator, typename Classifier>
+sequence<size_t> inplace_distribute(slice<Iterator, Iterator> A,
+                                    Classifier const &classify,
+                                    size_t num_buckets) {
+  using T = typename slice<Iterator, Iterator>::value_type;
+  constexpr size_t B = inplace_block_size<T>;
+  size_t n = A.size();
+  size_t k = num_buckets;
+  size_t num_full = n / B;                 // The number of block positions that lie within A
+  size_t num_regions = (n + B - 1) / B;    // Including the partial block at the end, if any
+
+  // Enough stripes to occupy every worker, each large enough to amortize its buffers
+  size_t num_stripes = (std::max)(size_t{1}, (std::min)(num_workers(), n / (4 * k * B)));
+  auto stripe_start = [&](size_t i) { return i * num_full / num_stripes; };
+
+  // ------------------------------- Classification -------------------------------
+  auto buffers = uninitialized_sequence<T>(num_stripes * k * B);
+  sequence<size_t> fill(num_stripes * k, 0);         // The number of elements in each buffer
+  sequence<size_t> full(num_stripes * k, 0);         // The number of full blocks written
+  sequence<size_t> stripe_end(num_stripes);          // The end of the full blocks of each stripe
+  parallel_for(0, num_stripes, [&](size_t i) {
+    T* buffer = buffers.begin() + i * k * B;
+    size_t* f = fill.begin() + i * k;
+    size_t start = stripe_start(i) * B;
+    size_t end = (i + 1 == num_stripes) ? n : stripe_start(i + 1) * B;
+    size_t write = start;
+    // Elements are classified in batches, so that the classifier can work on
+    // several of them at once
+    constexpr size_t batch_size = 16;
+    size_t batch[batch_size];
+    for (size_t j = start; j < end; j += batch_size) {
+      size_t m = (std::min)(batch_size, end - j);
+      classify(A.begin() + j, m, batch);
+      for (size_t l = 0; l < m; l++) {
+        size_t b = batch[l];
+        relocate_or_move_and_destroy(A[j + l], buffer[b * B + f[b]]);
+        if (++f[b] == B) {
+          seq_uninitialized_relocate_n(buffer + b * B, B, A.begin() + write);
+          write += B;
+          f[b] = 0;
+          full[i * k + b]++;
+        }
+      }
+    }
+    stripe_end[i] = write / B;
+  }, 1);
+
+  // Bucket b consists of the elements [offsets[b], offsets[b+1]), and its
+  // full blocks are placed in the region of blocks that starts at the first
+  // block boundary at or after offsets[b]
+  auto counts = sequence<size_t>::from_function(k, [&](size_t b) {
+    size_t c = 0;
+    for (size_t i = 0; i < num_stripes; i++) c += full[i * k + b] * B + fill[i * k + b];
+    return c;
+  });
+  auto offsets = sequence<size_t>::uninitialized(k + 1);
+  size_t total = scan_serial(make_slice(counts), make_slice(offsets).cut(0, k), plus<size_t>(), 0, no_flag, true);
+  assert(total == n);
+  offsets[k] = total;
+  auto region_start = [&](size_t b) { return (offsets[b] + B - 1) / B; };
+
+  // --------------------------------- Compaction ---------------------------------
+  // Move the full blocks that lie after the first num_blocks positions into
+  // the empty positions among them
+  size_t num_blocks = 0;
+  for (size_t i = 0; i < num_stripes; i++) num_blocks += stripe_end[i] - stripe_start(i);
+  auto sources = sequence<size_t>::from_function(num_stripes, [&](size_t i) {
+    return stripe_end[i] - (std::min)(stripe_end[i], (std::max)(stripe_start(i), num_blocks)); });
+  auto holes = sequence<size_t>::from_function(num_stripes, [&](size_t i) {
+    return (std::max)(stripe_end[i], (std::min)(stripe_start(i + 1), num_blocks)) - stripe_end[i]; });
+  size_t num_moves = scan_inplace(make_slice(sources), plus<size_t>());
+  [[maybe_unused]] size_t num_holes = scan_inplace(make_slice(holes), plus<size_t>());
+  assert(num_moves == num_holes);
+  parallel_for(0, num_moves, [&](size_t j) {
+    size_t i = (std::upper_bound(sources.begin(), sources.end(), j) - sources.begin()) - 1;
+    size_t from = (std::max)(stripe_start(i), num_blocks) + (j - sources[i]);
+    size_t h = (std::upper_bound(holes.begin(), holes.end(), j) - holes.begin()) - 1;
+    size_t to = stripe_end[h] + (j - holes[h]);
+    seq_uninitialized_relocate_n(A.begin() + from * B, B, A.begin() + to * B);
+  });
+
+  // ------------------------------ Block permutation ------------------------------
+  auto regions = sequence<block_permutation_region>(k);
+  for (size_t b = 0; b < k; b++) {
+    size_t start = region_start(b), end = (b + 1 == k) ? num_regions : region_start(b + 1);
+    regions[b].write = start;
+    regions[b].read = (std::min)(end, (std::max)(start, num_blocks));
+  }
+
+  // A block that would extend past the end of A is written to the overflow buffer
+  auto overflow = uninitialized_sequence<T>(B);
+  bool overflow_used = false;
+  auto swap_buffers = uninitialized_sequence<T>(num_stripes * 2 * B);
+  parallel_for(0, num_stripes, [&](size_t i) {
+    T* swap[2] = {swap_buffers.begin() + 2 * i * B, swap_buffers.begin() + (2 * i + 1) * B};
+    size_t b = i * k / num_stripes;
+    for (size_t exhausted = 0; exhausted < k; ) {
+      // Pick up an unplaced block from the region of bucket b
+      auto& r = regions[b];
+      r.lock();
+      bool found = r.read > r.write;
+      size_t pos = found ? --r.read : 0;
+      if (found) r.reading.fetch_add(1, std::memory_order_relaxed);
+      r.unlock();
+      if (!found) {
+        b = (b + 1 == k) ? 0 : b + 1;
+        exhausted++;
+        continue;
+      }
+      seq_uninitialized_relocate_n(A.begin() + pos * B, B, swap[0]);
+      r.reading.fetch_sub(1, std::memory_order_release);
+
+      // Swap it into its region until reaching an empty block
+      for (int cur = 0; ; cur = 1 - cur) {
+        size_t b_cur;
+        classify(swap[cur], 1, &b_cur);
+        auto& d = regions[b_cur];
+        d.lock();
+        size_t dest = d.write++;
+        bool occupied = dest < d.read;
+        d.unlock();
+        if (occupied) {
+          seq_uninitialized_relocate_n(A.begin() + dest * B, B, swap[1 - cur]);
+          seq_uninitialized_relocate_n(swap[cur], B, A.begin() + dest * B);
+        }
+        else {
+          if (dest >= num_full) {
+            seq_uninitialized_relocate_n(swap[cur], B, overflow.begin());
+            overflow_used = true;
+          }
+          else {
+            // The block may still be being read by the task that picked it up
+            block_permutation_region::spin_until([&]() { return d.reading.load(std::memory_order_acquire) == 0; });
+            seq_uninitialized_relocate_n(swap[cur], B, A.begin() + dest * B);
+          }
+          break;
+        }
+      }
+    }
+  }, 1);
+
+  // ---------------------------------- Cleanup ----------------------------------
+  // The elements of the overflow block that lie within A are put in place,
+  // and the rest spill over like those of any other block
+  size_t overflow_start = num_full * B;
+  if (overflow_used) {
+    seq_uninitialized_relocate_n(overflow.begin(), n - overflow_start, A.begin() + overflow_start);
+  }
+
+  // The full blocks of bucket b are now [region_start(b), regions[b].write).
+  // If they extend past the end of the bucket, the excess spills into the
+  // start of the following buckets, and must be saved before those are filled.
+  auto spills = uninitialized_sequence<T>(k * B);
+  auto spill_size = sequence<size_t>::from_function(k, [&](size_t b) {
+    size_t blocks_end = regions[b].write * B;
+    if (regions[b].write == region_start(b) || blocks_end <= offsets[b + 1]) return size_t{0};
+    size_t in_range = (std::min)(blocks_end, n) - offsets[b + 1];
+    seq_uninitialized_relocate_n(A.begin() + offsets[b + 1], in_range, spills.begin() + b * B);
+    if (blocks_end > n) {
+      seq_uninitialized_relocate_n(overflow.begin() + (n - overflow_start), blocks_end - n,
+                                   spills.begin() + b * B + in_range);
+    }
+    return blocks_end - offsets[b + 1];
+  }, 1);
+
+  // Fill the gaps before and after the full blocks of each bucket from its
+  // spilled elements and the buffers of every stripe
+  parallel_for(0, k, [&](size_t b) {
+    bool has_blocks = regions[b].write > region_start(b);
+    size_t head_end = has_blocks ? region_start(b) * B : offsets[b + 1];
+    size_t tail_start = has_blocks ? (std::min)(regions[b].write * B, offsets[b + 1]) : offsets[b + 1];
+    size_t pos = offsets[b];
+    auto put = [&](T* from, size_t m) {
+      while (m > 0) {
+        if (pos == head_end) pos = tail_start;
+        size_t len = (std::min)(m, (pos < head_end ? head_end : offsets[b + 1]) - pos);
+        seq_uninitialized_relocate_n(from, len, A.begin() + pos);
+        from += len; pos += len; m -= len;
+      }
+    };
+    put(spills.begin() + b * B, spill_size[b]);
+    for (size_t i = 0; i < num_stripes; i++) {
+      put(buffers.begin() + (i * k + b) * B, fill[i * k + b]);
+    }
+  }, 1);
+
+  return offsets;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_BLOCK_PERMUTATION_H_
@@ -0,0 +1,208 @@
+
+#ifndef PARLAY_INTERNAL_CONCURRENCY_EPOCH_H
+#define PARLAY_INTERNAL_CONCURRENCY_EPOCH_H
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../portability.h"
+#include "../../thread_specific.h"
+
+namespace parlay {
+namespace internal {
+
+// Epoch-based memory reclamation.
+//
+// Threads that read shared objects which might be concurrently retired by
+// another thread must do so inside a protected region, i.e., inside
+// protect(f). A retired object is tagged with the epoch in which it was
+// retired, and is only destroyed once the global epoch has advanced twice
+// since then, which guarantees that every thread that could have obtained
+// a reference to it has since left its protected region.
+//
+// The global epoch is shared by all types, so a single protected region
+// protects reads of objects of every type. The retired objects themselves
+// are kept in per-type lists (see epoch_retire below) so that they can be
+// destroyed before the allocators that own their storage.
+class epoch_manager {
+
+  static inline constexpr size_t quiescent = std::numeric_limits<size_t>::max();
+
+  struct ThreadData {
+    std::atomic<size_t> announcement{quiescent};
+    size_t depth{0};                              // cppcheck-suppress unusedStructMember
+  };
+
+ public:
+  epoch_manager() : current_epoch(0), data() {}
+
+  epoch_manager(const epoch_manager&) = delete;
+  epoch_manager& operator=(const epoch_manager&) = delete;
+
+  // Runs f() inside a protected region. Objects retired concurrently with
+  // the execution of f are not destroyed until f returns. Protected regions
+  // may be nested. f should not fork parallel tasks, since the forked tasks
+  // may run on different threads that are not protected.
+  template<typename F>
+  auto protect(F&& f) -> decltype(f()) {
+    struct unannounce_on_exit {
+      epoch_manager& manager;
+      ~unannounce_on_exit() { manager.unannounce(); }
+    } guard{*this};
+    announce();
+    return f();
+  }
+
+  // Returns the current global epoch
+  [[nodiscard]] size_t get_current() const noexcept {
+    return current_epoch.load(std::memory_order_seq_cst);
+  }
+
+  // Advances the global epoch if every thread that is currently inside a
+  // protected region has announced the current epoch. Returns the (possibly
+  // new) value of the global epoch.
+  size_t try_advance() {
+    size_t e = get_current();
+    bool all_current = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    data.for_each([&](auto&& local_data) {
+      size_t a = local_data.announcement.load(std::memory_order_seq_cst);
+      if (a != quiescent && a != e) all_current = false;
+    });
+    if (all_current) current_epoch.compare_exchange_strong(e, e + 1);
+    return get_current();
+  }
+
+  // Returns true if an object retired during epoch e can no longer be
+  // referenced by any thread in a protected region when the global epoch is current
+  static constexpr bool is_safe(size_t e, size_t current) noexcept {
+    return e + 2 <= current;
+  }
+
+ private:
+  void announce() {
+    if (data->depth++ == 0) {
+      std::atomic<size_t>& slot = data->announcement;
+      size_t e;
+      do {
+        e = current_epoch.load(std::memory_order_seq_cst);
+        slot.store(e, std::memory_order_seq_cst);
+      } while (current_epoch.load(std::memory_order_seq_cst) != e);
+    }
+  }
+
+  void unannounce() {
+    assert(data->depth > 0);
+    if (--data->depth == 0) {
+      data->announcement.store(quiescent, std::memory_order_release);
+    }
+  }
+
+  std::atomic<size_t> current_epoch;
+  ThreadSpecific<ThreadData> data;
+};
+
+extern inline epoch_manager& get_epoch_manager() {
+  static epoch_manager manager;
+  return manager;
+}
+
+// Per-thread lists of retired objects of type T awaiting destruction by
+// the Deleter once the epoch manager determines that it is safe to do so.
+//
+// Objects are freed in batches. Each thread attempts to advance the global
+// epoch and destroy its own safe objects once it has retired enough objects
+// to amortize the cost of scanning every thread's announcement.
+template<typename T, typename Deleter = std::default_delete<T>>
+class epoch_retire {
+
+  struct RetiredList {
+    std::vector<std::pair<T*, size_t>> retired;   // (object, epoch in which it was retired)
+    size_t amortized_work{0};                     // cppcheck-suppress unusedStructMember
+    bool in_progress{false};                      // cppcheck-suppress unusedStructMember
+  };
+
+ public:
+  explicit epoch_retire(Deleter deleter_ = {}) : data(), deleter(std::move(deleter_)) {
+    // Touch the epoch manager to force its initialization before this
+    // object, since it must outlive this object.
+    get_epoch_manager();
+  }
+
+  epoch_retire(const epoch_retire&) = delete;
+  epoch_retire& operator=(const epoch_retire&) = delete;
+
+  // Defer the destruction of p until no thread can hold a reference to it
+  template<typename U>
+  void retire(U p) {
+    static_assert(std::is_convertible_v<U, T*>, "retire must take a type that is convertible to T*");
+    data->retired.emplace_back(static_cast<T*>(p), get_epoch_manager().get_current());
+    work_toward_frees();
+  }
+
+  // Immediately destroy every retired object, regardless of whether they
+  // are safe to destroy. Not safe to call concurrently with any other operation.
+  void clear() {
+    // Destroying a retired object might cause something else to be retired
+    // (e.g., cleaning up a linked list), so loop until everything is gone
+    bool retired = true;
+    while (retired) {
+      retired = false;
+      data.for_each([&](auto&& local_data) {
+        if (!local_data.retired.empty()) {
+          retired = true;
+          auto batch = std::exchange(local_data.retired, {});
+          for (auto [p, e] : batch) deleter(p);
+        }
+      });
+    }
+  }
+
+  // Returns the number of objects that have been retired but not yet destroyed
+  [[nodiscard]] size_t size() {
+    size_t total = 0;
+    data.for_each([&](auto&& local_data) { total += local_data.retired.size(); });
+    return total;
+  }
+
+  ~epoch_retire() {
+    clear();
+  }
+
+ private:
+  void work_toward_frees() {
+    RetiredList& local = *data;
+    auto threshold = std::max<size_t>(64, 2 * num_thread_ids());
+    if (local.in_progress || ++local.amortized_work < threshold) return;
+    local.amortized_work = 0;
+    local.in_progress = true;
+
+    // Move the safe prefix of the list out before destroying anything, since a
+    // deleter may retire more objects and hence modify the list. Objects are
+    // retired in order of non-decreasing epoch, so the safe ones form a prefix.
+    size_t current = get_epoch_manager().try_advance();
+    auto safe_end = std::find_if(local.retired.begin(), local.retired.end(),
+        [&](const auto& r) { return !epoch_manager::is_safe(r.second, current); });
+    std::vector<std::pair<T*, size_t>> batch(local.retired.begin(), safe_end);
+    local.retired.erase(local.retired.begin(), safe_end);
+
+    for (auto [p, e] : batch) deleter(p);
+    local.in_progress = false;
+  }
+
+  ThreadSpecific<RetiredList> data;
+  PARLAY_NO_UNIQUE_ADDR Deleter deleter;
+};
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_CONCURRENCY_EPOCH_H
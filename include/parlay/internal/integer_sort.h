@@ -11,6 +11,7 @@
 #include <type_traits>
 #include <utility>
 
+#include "block_permutation.h"
 #include "counting_sort.h"
 #include "sequence_ops.h"
 #include "uninitialized_sequence.h"
@@ -336,10 +337,55 @@ sequence<size_t> integer_sort_(slice<InIterator, InIterator> In,
     In, Out, Tmp, g, bits, num_buckets);
 }
 
+// ----------------------------------------------------------------------------
+//                      In-place parallel radix sort
+// ----------------------------------------------------------------------------
+//
+// An unstable top-down radix sort that permutes the input in place, in the
+// style of IPS2Ra (Axtmann, Witt, Ferizovic, Sanders, "Engineering In-place
+// (Shared-memory) Sorting Algorithms"). Each level distributes the input into
+// 2^radix buckets by the block permutation of block_permutation.h, and the
+// buckets are then sorted recursively. Apart from the base case, which uses
+// the sequential radix sort on a small temporary buffer, the extra memory used
+// by a level is O(P * 2^radix) blocks for P tasks.
+
+template <typename Iterator, typename Get_Key>
+void integer_sort_inplace_r(slice<Iterator, Iterator> A, Get_Key const &g, size_t key_bits) {
+  using T = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  if (key_bits == 0 || n <= 1) return;
+  if (n < PARLAY_INTEGER_SORT_BASE_CASE_SIZE) {
+    auto Tmp = uninitialized_sequence<T>(n);
+    seq_radix_sort_(A, make_slice(Tmp), g, key_bits, true);
+    return;
+  }
+  size_t bits = (std::min)(radix, key_bits);
+  size_t shift_bits = key_bits - bits;
+  size_t num_buckets = size_t{1} << bits;
+  size_t mask = num_buckets - 1;
+  auto classify = [&](auto first, size_t m, size_t* buckets) {
+    for (size_t j = 0; j < m; j++) buckets[j] = static_cast<size_t>((g(first[j]) >> shift_bits) & mask);
+  };
+  auto offsets = inplace_distribute(A, classify, num_buckets);
+  parallel_for(0, num_buckets, [&](size_t b) {
+    integer_sort_inplace_r(A.cut(offsets[b], offsets[b + 1]), g, shift_bits);
+  }, 1);
+}
+
 template <typename Iterator, typename Get_Key>
 void integer_sort_inplace(slice<Iterator, Iterator> In,
-                          Get_Key const &g, size_t bits = 0) {
+                          Get_Key const &g, size_t bits = 0,
+                          sort_mode mode = sort_mode::standard) {
   using value_type = typename slice<Iterator, Iterator>::value_type;
+  if (mode == sort_mode::low_memory) {
+    if (bits == 0) {
+      auto get_key = [&](size_t i) { return static_cast<size_t>(g(In[i])); };
+      auto keys = delayed_seq<size_t>(In.size(), get_key);
+      bits = log2_up(internal::reduce(make_slice(keys), maximum<size_t>()) + 1);
+    }
+    integer_sort_inplace_r(In, g, bits);
+    return;
+  }
   auto Tmp = internal::uninitialized_sequence<value_type>(In.size());
   integer_sort_<std::true_type, uninitialized_relocate_tag>(In, make_slice(Tmp), In, g, bits, 0);
 }
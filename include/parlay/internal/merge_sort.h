@@ -1,9 +1,18 @@
 #ifndef PARLAY_MERGE_SORT_H_
 #define PARLAY_MERGE_SORT_H_
 
+#include <cstddef>
+
+#include <algorithm>
+
 #include "merge.h"
 #include "quicksort.h"  // needed for insertion_sort
+#include "sequence_ops.h"
 
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../relocation.h"
+#include "../sequence.h"
 #include "../utilities.h"
 #include "uninitialized_sequence.h"
 
@@ -49,16 +58,164 @@ void merge_sort_(slice<InIterator, InIterator> In,
   }
 }
 
+// Adaptive merge sort
+//
+// Sorted and nearly sorted inputs are common, e.g., when a small sorted batch
+// is appended to a large sorted sequence, so the input is first split into
+// runs that are already sorted, and only the runs are merged. A run is a
+// maximal non-decreasing or non-increasing sequence of elements, and the
+// latter are reversed, after which each group of equal elements in them is
+// reversed back to keep the sort stable. Runs shorter than MERGE_SORT_MIN_RUN
+// are extended to that length by insertion sort, so that random inputs cost
+// about the same as the plain recursive merge sort. The runs are then merged
+// pairwise in a balanced tree, which takes O(n log r) work for an input with
+// r runs, and O(n) work for sorted and reverse sorted inputs.
+
+// Minimum length of a run, and minimum size of the
+// blocks in which runs are found in parallel
+constexpr size_t MERGE_SORT_MIN_RUN = 32;
+constexpr size_t MERGE_SORT_RUN_BLOCK = 4096;
+
+// Reverses the non-increasing elements [s, e) of In, and then reverses
+// back each group of equal elements among them, so that they are sorted
+// and equal elements are in their original order
+template <typename Iterator, typename BinaryOp>
+void reverse_run(slice<Iterator, Iterator> In, size_t s, size_t e, const BinaryOp& f) {
+  std::reverse(In.begin() + s, In.begin() + e);
+  for (size_t i = s; i < e;) {
+    size_t j = i + 1;
+    while (j < e && !f(In[j - 1], In[j])) j++;
+    if (j - i > 1) std::reverse(In.begin() + i, In.begin() + j);
+    i = j;
+  }
+}
+
+// Merges the consecutive sorted runs of In that begin at the given positions,
+// where base is the position of the start of In. As in merge_sort_, if
+// inplace is true then the output is placed in In and Out is temp space.
+template <typename InIterator, typename OutIterator, typename BinaryOp>
+void merge_runs_(slice<InIterator, InIterator> In,
+                 slice<OutIterator, OutIterator> Out,
+                 slice<size_t*, size_t*> starts,
+                 size_t base,
+                 const BinaryOp& f,
+                 bool inplace) {
+  size_t n = In.size();
+  size_t r = starts.size();
+  if (r == 1) {
+    if (!inplace) {
+      parlay::uninitialized_relocate(In.begin(), In.end(), Out.begin());
+    }
+  }
+  else {
+    size_t k = r / 2;
+    size_t m = starts[k] - base;
+    par_do_if(
+      n > 64,
+      [&]() { merge_runs_(In.cut(0, m), Out.cut(0, m), starts.cut(0, k), base, f, !inplace); },
+      [&]() { merge_runs_(In.cut(m, n), Out.cut(m, n), starts.cut(k, r), base + m, f, !inplace); },
+    true);
+
+    if (inplace) {
+      merge_into<uninitialized_relocate_tag>(Out.cut(0, m), Out.cut(m, n), In, f);
+    }
+    else {
+      merge_into<uninitialized_relocate_tag>(In.cut(0, m), In.cut(m, n), Out, f);
+    }
+  }
+}
+
+// Sorts each run of the block [s, e) of In, and returns the start of each.
+// Non-increasing runs are reversed, and short runs are extended.
+template <typename Iterator, typename BinaryOp>
+sequence<size_t> find_runs(slice<Iterator, Iterator> In, size_t s, size_t e, const BinaryOp& f) {
+  sequence<size_t> starts;
+  size_t i = s;
+  while (i < e) {
+    size_t j = i + 1;
+    if (j < e && f(In[j], In[i])) {
+      while (j + 1 < e && !f(In[j], In[j + 1])) j++;
+      j++;
+      reverse_run(In, i, j, f);
+    }
+    else {
+      while (j < e && !f(In[j], In[j - 1])) j++;
+    }
+    if (j - i < MERGE_SORT_MIN_RUN) {
+      j = (std::min)(i + MERGE_SORT_MIN_RUN, e);
+      insertion_sort(In.begin() + i, j - i, f);
+    }
+    starts.push_back(i);
+    i = j;
+  }
+  return starts;
+}
+
 template <typename Iterator, typename BinaryOp>
 void merge_sort_inplace(slice<Iterator, Iterator> In, const BinaryOp& f) {
   using value_type = typename slice<Iterator, Iterator>::value_type;
   size_t n = In.size();
   if (n <= MERGE_SORT_BASE) {
     insertion_sort(In.begin(), In.size(), f);
+    return;
   }
-  else {
+
+  size_t num_blocks = (std::min)(num_workers() * 8, (n + MERGE_SORT_RUN_BLOCK - 1) / MERGE_SORT_RUN_BLOCK);
+  size_t block_size = (n + num_blocks - 1) / num_blocks;
+  num_blocks = (n + block_size - 1) / block_size;
+
+  // A non-increasing input is a single run, which is found by checking
+  // each block (and the boundary after it) in parallel. It is reversed in
+  // parallel, and then each block reverses back the groups of equal
+  // elements that begin in it, as in reverse_run.
+  auto increasing = sequence<bool>::from_function(num_blocks, [&](size_t b) {
+    size_t e = (std::min)(n, (b + 1) * block_size + 1);
+    for (size_t i = b * block_size + 1; i < e; i++)
+      if (f(In[i - 1], In[i])) return true;
+    return false;
+  }, 1);
+  if (std::none_of(increasing.begin(), increasing.end(), [](bool x) { return x; })) {
+    parallel_for(0, n / 2, [&](size_t i) {
+      using std::swap;
+      swap(In[i], In[n - i - 1]);
+    });
+    auto first_group = sequence<size_t>::from_function(num_blocks, [&](size_t b) {
+      size_t i = b * block_size, e = (std::min)(n, (b + 1) * block_size);
+      while (i > 0 && i < e && !f(In[i - 1], In[i])) i++;
+      return i;
+    }, 1);
+    parallel_for(0, num_blocks, [&](size_t b) {
+      size_t e = (std::min)(n, (b + 1) * block_size);
+      for (size_t i = first_group[b]; i < e;) {
+        size_t j = i + 1;
+        while (j < n && !f(In[j - 1], In[j])) j++;
+        if (j - i > 1) std::reverse(In.begin() + i, In.begin() + j);
+        i = j;
+      }
+    }, 1);
+    return;
+  }
+
+  // Find the runs of each block, and then keep the starts of those that are
+  // out of order with the run before them, since the others continue it
+  auto block_starts = sequence<sequence<size_t>>::from_function(num_blocks, [&](size_t b) {
+    return find_runs(In, b * block_size, (std::min)(n, (b + 1) * block_size), f);
+  }, 1);
+  auto offsets = sequence<size_t>::from_function(num_blocks, [&](size_t b) {
+    auto& bs = block_starts[b];
+    auto end = std::remove_if(bs.begin(), bs.end(), [&](size_t i) { return i > 0 && !f(In[i], In[i - 1]); });
+    bs.resize(end - bs.begin());
+    return bs.size();
+  }, 1);
+  size_t num_runs = scan_inplace(make_slice(offsets), plus<size_t>());
+  auto starts = sequence<size_t>::uninitialized(num_runs);
+  parallel_for(0, num_blocks, [&](size_t b) {
+    std::copy(block_starts[b].begin(), block_starts[b].end(), starts.begin() + offsets[b]);
+  }, 1);
+
+  if (starts.size() > 1) {
     auto B = uninitialized_sequence<value_type>(n);
-    merge_sort_(In, make_slice(B), f, true);
+    merge_runs_(In, make_slice(B), make_slice(starts), 0, f, true);
   }
 }
 
@@ -0,0 +1,207 @@
+#ifndef PARLAY_INTERNAL_MULTIWAY_MERGE_H_
+#define PARLAY_INTERNAL_MULTIWAY_MERGE_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <utility>
+
+#include "binary_search.h"
+#include "merge.h"
+#include "sequence_ops.h"
+
+#include "../delayed_sequence.h"
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// A multiway merge merges k sorted sequences in a single pass over the data.
+// The output is split into equal parts by multi-sequence selection, which
+// finds, for each part, the position in each input at which the part begins.
+// Each part is then merged sequentially with a tournament tree of losers,
+// which takes O(log k) comparisons per element.
+//
+// The merge is stable: equal elements are output in the order of the input
+// sequences that they come from, and of their positions within those.
+
+// The elements of the inputs are totally ordered by (value, sequence, position)
+template <typename Slices, typename BinaryOp>
+bool multiway_precedes(const Slices& In, const BinaryOp& f, size_t a, size_t i, size_t b, size_t j) {
+  if (f(In[a][i], In[b][j])) return true;
+  if (f(In[b][j], In[a][i])) return false;
+  return a < b || (a == b && i < j);
+}
+
+// Returns the positions in each input at which the first r elements of
+// the merged output end. In each round, the midpoints of the remaining
+// ranges of candidate positions are ordered, and their median, weighted by
+// the sizes of the ranges, is located in every input by binary search. This
+// at least halves the ranges that hold half of the remaining candidates.
+template <typename Slices, typename BinaryOp>
+sequence<size_t> multiway_select(const Slices& In, size_t r, const BinaryOp& f) {
+  size_t k = In.size();
+  auto lo = sequence<size_t>(k, 0);
+  auto hi = sequence<size_t>::from_function(k, [&](size_t j) { return In[j].size(); }, 1024);
+  auto pos = sequence<size_t>::uninitialized(k);
+  auto active = sequence<size_t>::uninitialized(k);
+  while (true) {
+    size_t num_active = 0, total = 0;
+    for (size_t j = 0; j < k; j++) {
+      if (hi[j] > lo[j]) {
+        active[num_active++] = j;
+        total += hi[j] - lo[j];
+      }
+    }
+    if (num_active == 0) return lo;
+
+    auto mid = [&](size_t j) { return lo[j] + (hi[j] - lo[j]) / 2; };
+    std::sort(active.begin(), active.begin() + num_active, [&](size_t a, size_t b) {
+      return multiway_precedes(In, f, a, mid(a), b, mid(b));
+    });
+    size_t s = active[0];
+    for (size_t i = 0, weight = 0; i < num_active; i++) {
+      s = active[i];
+      weight += hi[s] - lo[s];
+      if (2 * weight >= total) break;
+    }
+    size_t m = mid(s);
+    const auto& pivot = In[s][m];
+
+    // The number of elements of each input that precede the pivot
+    size_t rank = 0;
+    for (size_t j = 0; j < k; j++) {
+      auto range = In[j].cut(lo[j], hi[j]);
+      if (j < s) pos[j] = lo[j] + binary_search(range, [&](const auto& x) { return !f(pivot, x); });
+      else if (j > s) pos[j] = lo[j] + binary_search(range, [&](const auto& x) { return f(x, pivot); });
+      else pos[j] = m;
+      rank += pos[j];
+    }
+
+    if (rank < r) {
+      for (size_t j = 0; j < k; j++) lo[j] = pos[j];
+      lo[s] = m + 1;
+    }
+    else {
+      for (size_t j = 0; j < k; j++) hi[j] = pos[j];
+    }
+  }
+}
+
+// Sequentially merges the inputs into Out with a tournament tree, whose
+// internal nodes hold the input that lost the match played there, and
+// whose root is preceded by the overall winner
+template <typename assignment_tag, typename Slices, typename OutIterator, typename BinaryOp>
+void seq_multiway_merge(const Slices& In, slice<OutIterator, OutIterator> Out, const BinaryOp& f) {
+  size_t k = In.size();
+  if (k == 1) {
+    for (size_t i = 0; i < Out.size(); i++) assign_dispatch(Out[i], In[0][i], assignment_tag{});
+    return;
+  }
+  if (k == 2) {
+    seq_merge<assignment_tag>(In[0], In[1], Out, f);
+    return;
+  }
+
+  // The leaves beyond the k inputs are empty inputs. An input beats another
+  // if its next element comes first, where ties go to the earlier input, and
+  // empty inputs lose to all others. The current position and the end of
+  // input j are kept together in heads[2j] and heads[2j+1].
+  size_t leaves = 1;
+  while (leaves < k) leaves *= 2;
+  using iterator = decltype(In[0].begin());
+  auto heads = sequence<iterator>::from_function(2 * leaves, [&](size_t j) {
+    if (j >= 2 * k) return In[0].end();
+    return j % 2 == 0 ? In[j / 2].begin() : In[j / 2].end();
+  });
+  iterator* cur = heads.begin();
+  auto beats = [&](size_t a, size_t b) {
+    if (cur[2 * a] == cur[2 * a + 1]) return false;
+    if (cur[2 * b] == cur[2 * b + 1]) return true;
+    return a < b ? !f(*cur[2 * b], *cur[2 * a]) : f(*cur[2 * a], *cur[2 * b]);
+  };
+
+  auto tree = sequence<size_t>::uninitialized(3 * leaves);
+  size_t* loser = tree.begin();
+  size_t* winner = tree.begin() + leaves;
+  for (size_t i = 0; i < leaves; i++) winner[leaves + i] = i;
+  for (size_t node = leaves - 1; node >= 1; node--) {
+    size_t a = winner[2 * node], b = winner[2 * node + 1];
+    bool a_wins = beats(a, b);
+    winner[node] = a_wins ? a : b;
+    loser[node] = a_wins ? b : a;
+  }
+
+  // Replay the matches on the path from the winner's leaf to the root,
+  // keeping the position of the current winner's next element at hand
+  size_t w = winner[1];
+  for (size_t i = 0; i < Out.size(); i++) {
+    assign_dispatch(Out[i], *cur[2 * w], assignment_tag{});
+    iterator wi = ++cur[2 * w];
+    bool w_empty = (wi == cur[2 * w + 1]);
+    for (size_t node = (leaves + w) / 2; node >= 1; node /= 2) {
+      size_t l = loser[node];
+      iterator li = cur[2 * l];
+      if (li == cur[2 * l + 1]) continue;
+      if (w_empty || (l < w ? !f(*wi, *li) : f(*li, *wi))) {
+        loser[node] = w;
+        w = l;
+        wi = li;
+        w_empty = false;
+      }
+    }
+  }
+}
+
+// Merges the inputs, a sequence of k sorted slices, into Out, whose size must
+// be the total size of the inputs. Values are transferred as per the type of
+// assignment_tag, as in merge_into.
+template <typename assignment_tag, typename Iterator, typename OutIterator, typename BinaryOp>
+void multiway_merge_into(const sequence<slice<Iterator, Iterator>>& In,
+                         slice<OutIterator, OutIterator> Out,
+                         const BinaryOp& f) {
+  size_t k = In.size();
+  size_t n = Out.size();
+  if (k == 0) return;
+
+  // Each part must be large enough to pay for the k binary searches in
+  // each round of selecting its start
+  size_t num_parts = (std::min)(8 * num_workers(), n / ((std::max)(_merge_base, 64 * k)));
+  if (num_parts <= 1) {
+    seq_multiway_merge<assignment_tag>(In, Out, f);
+    return;
+  }
+
+  auto splits = sequence<sequence<size_t>>::from_function(num_parts + 1, [&](size_t p) {
+    if (p == 0) return sequence<size_t>(k, 0);
+    if (p == num_parts) return sequence<size_t>::from_function(k, [&](size_t j) { return In[j].size(); });
+    return multiway_select(In, p * n / num_parts, f);
+  }, 1);
+
+  parallel_for(0, num_parts, [&](size_t p) {
+    auto part = sequence<slice<Iterator, Iterator>>::from_function(k, [&](size_t j) {
+      return In[j].cut(splits[p][j], splits[p + 1][j]);
+    });
+    size_t start = p * n / num_parts, end = (p + 1) * n / num_parts;
+    seq_multiway_merge<assignment_tag>(part, Out.cut(start, end), f);
+  }, 1);
+}
+
+// Merges the inputs, a sequence of k sorted slices, into a new sequence
+template <typename Iterator, typename BinaryOp>
+auto multiway_merge(const sequence<slice<Iterator, Iterator>>& In, const BinaryOp& f) {
+  using T = typename slice<Iterator, Iterator>::value_type;
+  auto sizes = delayed_seq<size_t>(In.size(), [&](size_t j) { return In[j].size(); });
+  auto R = sequence<T>::uninitialized(internal::reduce(make_slice(sizes), plus<size_t>()));
+  multiway_merge_into<uninitialized_copy_tag>(In, make_slice(R), f);
+  return R;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_MULTIWAY_MERGE_H_
@@ -0,0 +1,163 @@
+#ifndef PARLAY_INTERNAL_PARTITION_H_
+#define PARLAY_INTERNAL_PARTITION_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "sequence_ops.h"
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// In-place partitioning moves the elements for which a predicate is true
+// to the front of a sequence without a second buffer for its elements,
+// using O(n / PARTITION_BLOCK_SIZE) extra space.
+//
+// The unstable version counts the true elements of each block, which gives
+// the split point m. The false elements before m and the true elements after
+// it are then out of place, and there are equally many of each. The i'th out
+// of place element before m is swapped with the i'th after m, in parallel
+// chunks of consecutive ranks, each of which finds where its ranks begin
+// from the counts of the blocks. This does O(n) work and moves only
+// elements that are out of place.
+//
+// The stable version partitions the two halves in parallel, and then brings
+// the true elements of the second half before the false elements of the
+// first by rotating the range between them with three parallel reversals.
+// This does O(n log n) work, so the unstable version should be preferred
+// when the order of the elements within each part does not matter.
+
+// the following parameters can be tuned
+constexpr size_t PARTITION_BLOCK_SIZE = 4096;
+constexpr size_t STABLE_PARTITION_BASE = 1 << 14;
+
+// Returns the position in A of its r'th out of place element, where
+// offsets are the ranks of the first out of place element of each block,
+// and [start, end) is the range in which elements with the given value of
+// the predicate are out of place
+template <typename Iterator, typename UnaryPred>
+size_t partition_find_rank(slice<Iterator, Iterator> A, const sequence<size_t>& offsets,
+                           size_t start, size_t end, bool out_of_place, size_t r,
+                           const UnaryPred& pred) {
+  size_t b = std::upper_bound(offsets.begin(), offsets.end(), r) - offsets.begin() - 1;
+  size_t i = (std::max)(start, b * PARTITION_BLOCK_SIZE);
+  for (size_t skip = r - offsets[b]; ; i++) {
+    assert(i < end);
+    if (static_cast<bool>(pred(A[i])) == out_of_place && skip-- == 0) return i;
+  }
+}
+
+template <typename Iterator, typename UnaryPred>
+size_t partition_inplace(slice<Iterator, Iterator> A, const UnaryPred& pred) {
+  size_t n = A.size();
+  if (n <= PARTITION_BLOCK_SIZE) {
+    return std::partition(A.begin(), A.end(), [&](auto&& x) -> bool { return pred(x); }) - A.begin();
+  }
+
+  size_t num_blocks = (n + PARTITION_BLOCK_SIZE - 1) / PARTITION_BLOCK_SIZE;
+  auto block_start = [&](size_t b) { return b * PARTITION_BLOCK_SIZE; };
+  auto block_end = [&](size_t b) { return (std::min)(n, (b + 1) * PARTITION_BLOCK_SIZE); };
+  auto count_true = [&](size_t s, size_t e) {
+    size_t c = 0;
+    for (size_t i = s; i < e; i++) c += static_cast<bool>(pred(A[i]));
+    return c;
+  };
+  auto counts = sequence<size_t>::from_function(num_blocks, [&](size_t b) {
+    return count_true(block_start(b), block_end(b));
+  }, 1);
+  size_t m = internal::reduce(make_slice(counts), plus<size_t>());
+
+  // The number of false elements of each block before m, and of true
+  // elements after m. Only the block that contains m needs recounting.
+  size_t mb = m / PARTITION_BLOCK_SIZE;
+  size_t true_before_m = (mb < num_blocks) ? count_true(block_start(mb), m) : 0;
+  auto front = sequence<size_t>::from_function(num_blocks, [&](size_t b) -> size_t {
+    if (b < mb) return block_end(b) - block_start(b) - counts[b];
+    if (b == mb) return m - block_start(b) - true_before_m;
+    return 0;
+  });
+  auto back = sequence<size_t>::from_function(num_blocks, [&](size_t b) -> size_t {
+    if (b < mb) return 0;
+    if (b == mb) return counts[b] - true_before_m;
+    return counts[b];
+  });
+  size_t total = scan_inplace(make_slice(front), plus<size_t>());
+  [[maybe_unused]] size_t total_back = scan_inplace(make_slice(back), plus<size_t>());
+  assert(total == total_back);
+
+  // The positions at which the chunks start are all found before any
+  // swaps, since finding them reads elements that other chunks swap
+  size_t num_chunks = (total + PARTITION_BLOCK_SIZE - 1) / PARTITION_BLOCK_SIZE;
+  auto chunk_rank = [&](size_t c) { return c * total / num_chunks; };
+  auto starts = sequence<std::pair<size_t, size_t>>::from_function(num_chunks, [&](size_t c) {
+    return std::make_pair(partition_find_rank(A, front, 0, m, false, chunk_rank(c), pred),
+                          partition_find_rank(A, back, m, n, true, chunk_rank(c), pred));
+  }, 1);
+  parallel_for(0, num_chunks, [&](size_t c) {
+    auto [i, j] = starts[c];
+    for (size_t r = chunk_rank(c); r < chunk_rank(c + 1); r++, i++, j++) {
+      while (pred(A[i])) i++;
+      while (!pred(A[j])) j++;
+      using std::swap;
+      swap(A[i], A[j]);
+    }
+  }, 1);
+  return m;
+}
+
+template <typename Iterator>
+void parallel_rotate(slice<Iterator, Iterator> A, size_t k) {
+  auto reverse = [](slice<Iterator, Iterator> B) {
+    size_t n = B.size();
+    parallel_for(0, n / 2, [&](size_t i) {
+      using std::swap;
+      swap(B[i], B[n - i - 1]);
+    });
+  };
+  reverse(A.cut(0, k));
+  reverse(A.cut(k, A.size()));
+  reverse(A);
+}
+
+template <typename Iterator, typename UnaryPred>
+size_t stable_partition_inplace(slice<Iterator, Iterator> A, const UnaryPred& pred) {
+  size_t n = A.size();
+  if (n <= STABLE_PARTITION_BASE) {
+    return std::stable_partition(A.begin(), A.end(), [&](auto&& x) -> bool { return pred(x); }) - A.begin();
+  }
+  size_t h = n / 2;
+  size_t l = 0, r = 0;
+  par_do([&]() { l = stable_partition_inplace(A.cut(0, h), pred); },
+         [&]() { r = stable_partition_inplace(A.cut(h, n), pred); });
+
+  // A is now [true, false | true, false], so the middle two are swapped
+  if (l < h && r > 0) parallel_rotate(A.cut(l, h + r), h - l);
+  return l + r;
+}
+
+// Partitions A into the elements for which f is 0, then 1, then 2, and
+// returns the ends of the first two parts
+template <typename Iterator, typename F>
+std::pair<size_t, size_t> partition3_inplace(slice<Iterator, Iterator> A, const F& f, bool stable) {
+  auto is = [&](int k) { return [&f, k](auto&& x) { return static_cast<int>(f(x)) == k; }; };
+  auto part = [&](auto B, const auto& pred) {
+    return stable ? stable_partition_inplace(B, pred) : partition_inplace(B, pred);
+  };
+  size_t m1 = part(A, is(0));
+  size_t m2 = m1 + part(A.cut(m1, A.size()), is(1));
+  return {m1, m2};
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_PARTITION_H_
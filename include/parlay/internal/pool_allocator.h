@@ -22,6 +22,10 @@
 
 #include "concurrency/hazptr_stack.h"
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 // IWYU pragma: no_include <array>
 
 namespace parlay {
@@ -38,7 +42,12 @@ namespace internal {
 // thread local list of elements from each pool using the block_allocator.
 // For large blocks there is only one pool shared by all threads. For
 // blocks larger than the maximum pool size, allocation and deallocation
-// is performed directly by operator new.
+// is performed directly using the exact requested size. On Linux, these
+// huge blocks are mapped directly from the OS so that they can be resized
+// without copying by try_reallocate. Elsewhere, they use operator new.
+//
+// The pool sizes need not be powers of two. Large pools are located by
+// binary search, so it is cheap to use many finely-spaced large pools.
 struct pool_allocator {
 
   // Maximum alignment guaranteed by the allocator
@@ -58,18 +67,25 @@ struct pool_allocator {
   std::unique_ptr<internal::hazptr_stack<void*>[]> large_buckets;
   unique_array<block_allocator> small_allocators;
 
+  // Returns the index of the smallest large bucket whose size is at least n
+  size_t find_large_bucket(size_t n) const {
+    assert(n > max_small && n <= max_size);
+    return std::lower_bound(sizes.get() + num_small, sizes.get() + num_buckets, n) - sizes.get();
+  }
+
   void* allocate_large(size_t n) {
 
-    size_t bucket = num_small;
-    size_t alloc_size;
     large_used += n;
+    if (n > max_size) return allocate_huge(n);
 
-    if (n <= max_size) {
-      while (n > sizes[bucket]) bucket++;
-      std::optional<void*> r = large_buckets[bucket-num_small].pop();
-      if (r) return *r;
-      alloc_size = sizes[bucket];
-    } else alloc_size = n;
+    size_t bucket = find_large_bucket(n);
+    std::optional<void*> r = large_buckets[bucket-num_small].pop();
+    if (r) return *r;
+    size_t alloc_size = sizes[bucket];
+
+    // Account for the size of the pool rather than the requested size so
+    // that the statistics reflect the space lost to internal fragmentation
+    large_allocated += alloc_size;
 
     // Alloc size must be a multiple of the alignment
     // Round up to the next multiple.
@@ -78,19 +94,40 @@ struct pool_allocator {
     }
 
     void* a = ::operator new(alloc_size, std::align_val_t{max_alignment});
+    return a;
+  }
 
+  void* allocate_huge(size_t n) {
+    assert(n > max_size);
+#if defined(__linux__)
+    void* a = ::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (a == MAP_FAILED) throw std::bad_alloc();
+#else
+    // Alloc size must be a multiple of the alignment
+    size_t alloc_size = (n + max_alignment - 1) / max_alignment * max_alignment;
+    void* a = ::operator new(alloc_size, std::align_val_t{max_alignment});
+#endif
     large_allocated += n;
     return a;
   }
 
+  void deallocate_huge(void* ptr, size_t n) {
+    assert(n > max_size);
+#if defined(__linux__)
+    [[maybe_unused]] int result = ::munmap(ptr, n);
+    assert(result == 0);
+#else
+    ::operator delete(ptr, std::align_val_t{max_alignment});
+#endif
+    large_allocated -= n;
+  }
+
   void deallocate_large(void* ptr, size_t n) {
     large_used -= n;
     if (n > max_size) {
-      ::operator delete(ptr, std::align_val_t{max_alignment});
-      large_allocated -= n;
+      deallocate_huge(ptr, n);
     } else {
-      size_t bucket = num_small;
-      while (n > sizes[bucket]) bucket++;
+      size_t bucket = find_large_bucket(n);
       large_buckets[bucket-num_small].push(ptr);
     }
   }
@@ -123,7 +160,7 @@ struct pool_allocator {
 
 #ifndef NDEBUG
     size_t prev_bucket_size = 0;
-    for (size_t i = 0; i < num_small; i++) {
+    for (size_t i = 0; i < num_buckets; i++) {
       size_t bucket_size = sizes[i];
       assert(bucket_size >= 8);
       assert(bucket_size > prev_bucket_size);
@@ -148,6 +185,46 @@ struct pool_allocator {
     }
   }
 
+  // Attempt to resize a block of size old_n, obtained from allocate(old_n), to
+  // size new_n without copying it. On success, returns a pointer to the new block,
+  // whose first min(old_n, new_n) bytes are bitwise identical to the old block,
+  // which is no longer valid. On failure, returns nullptr and leaves the old block
+  // untouched, in which case the caller must allocate, copy and deallocate itself.
+  //
+  // This is only possible for blocks larger than the largest pool, and only on
+  // platforms that support mremap, where the OS moves the pages of the block
+  // rather than copying its contents.
+  void* try_reallocate([[maybe_unused]] void* ptr, [[maybe_unused]] size_t old_n, [[maybe_unused]] size_t new_n) {
+#if defined(__linux__)
+    if (old_n > max_size && new_n > max_size) {
+      void* a = ::mremap(ptr, old_n, new_n, MREMAP_MAYMOVE);
+      if (a != MAP_FAILED) {
+        large_used += new_n;
+        large_used -= old_n;
+        large_allocated += new_n;
+        large_allocated -= old_n;
+        return a;
+      }
+    }
+#endif
+    return nullptr;
+  }
+
+  // Allocate a block of size n whose contents are all zero, if this can be done
+  // without writing to it. This is possible for blocks larger than the largest
+  // pool on platforms where they are freshly mapped from the OS, whose pages are
+  // zeroed lazily when first touched. Otherwise, returns nullptr. A block obtained
+  // by this function is deallocated as usual by deallocate(ptr, n).
+  void* try_allocate_zeroed([[maybe_unused]] size_t n) {
+#if defined(__linux__)
+    if (n > max_size) {
+      large_used += n;
+      return allocate_huge(n);
+    }
+#endif
+    return nullptr;
+  }
+
   // allocate, touch, and free to make sure space for small blocks is paged in
   [[deprecated]] void reserve(size_t) { }
 
@@ -0,0 +1,208 @@
+
+#ifndef PARLAY_INTERNAL_RADIX_KEY_H_
+#define PARLAY_INTERNAL_RADIX_KEY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "integer_sort.h"
+#include "sequence_ops.h"
+
+#include "../delayed_sequence.h"
+#include "../monoid.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../type_traits.h"
+
+namespace parlay {
+namespace internal {
+
+// The smallest unsigned integer type with at least the given number of bytes
+template<size_t Bytes>
+using unsigned_of_size_t =
+    std::conditional_t<Bytes <= 1, uint8_t,
+    std::conditional_t<Bytes <= 2, uint16_t,
+    std::conditional_t<Bytes <= 4, uint32_t, uint64_t>>>;
+
+// radix_key_traits<T> provides, for the types T that have one, a member type
+// "type", an unsigned integer type, and a static function key(x) that maps
+// each value of T to a value of that type such that x < y if and only if
+// key(x) < key(y). This allows values of T to be sorted by radix sort.
+template<typename T, typename = void>
+struct radix_key_traits {
+  static constexpr bool value = false;
+};
+
+// Unsigned integers are their own keys. Keys are at most 64 bits, so wider
+// integers such as __int128, which are integral in gnu++ modes, have none.
+template<typename T>
+struct radix_key_traits<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> &&
+                                            !std::is_same_v<T, bool> && sizeof(T) <= 8>> {
+  static constexpr bool value = true;
+  using type = T;
+  static type key(T x) { return x; }
+};
+
+// Signed integers in two's complement are ordered as unsigned
+// integers once their sign bit is flipped
+template<typename T>
+struct radix_key_traits<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T> &&
+                                            sizeof(T) <= 8>> {
+  static constexpr bool value = true;
+  using type = std::make_unsigned_t<T>;
+  static type key(T x) {
+    return static_cast<type>(static_cast<type>(x) ^ (type{1} << (std::numeric_limits<type>::digits - 1)));
+  }
+};
+
+// IEEE-754 floating point numbers are ordered by their bits as sign-magnitude
+// integers, so flipping the sign bit of positive numbers and every bit of
+// negative numbers orders them as unsigned integers. -0.0 is mapped to 0.0
+// first, since they compare equal and so must have equal keys for the keys
+// of pairs and tuples to be ordered correctly. Negative NaNs are placed
+// before -infinity and positive NaNs after infinity.
+template<typename T>
+struct radix_key_traits<T, std::enable_if_t<std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 &&
+                                            (sizeof(T) == 4 || sizeof(T) == 8)>> {
+  static constexpr bool value = true;
+  using type = unsigned_of_size_t<sizeof(T)>;
+  static type key(T x) {
+    if (x == T{0}) x = T{0};
+    type bits;
+    std::memcpy(&bits, &x, sizeof(T));
+    constexpr size_t sign_shift = std::numeric_limits<type>::digits - 1;
+    type mask = static_cast<type>(-static_cast<type>(bits >> sign_shift)) | (type{1} << sign_shift);
+    return bits ^ mask;
+  }
+};
+
+template<typename... Ts>
+inline constexpr bool all_have_radix_keys_v = (radix_key_traits<Ts>::value && ...);
+
+template<typename... Ts>
+inline constexpr size_t total_radix_key_bytes_v = (sizeof(typename radix_key_traits<Ts>::type) + ...);
+
+// Pairs and tuples are ordered lexicographically, as are the concatenations
+// of the keys of their elements. They have keys when these fit in 64 bits.
+template<typename... Ts>
+struct tuple_radix_key_traits {
+  static constexpr bool value = true;
+  using type = unsigned_of_size_t<total_radix_key_bytes_v<Ts...>>;
+
+  // Appends the key of an element, of the given number of bits, to the key k
+  template<size_t Bits>
+  static uint64_t append(uint64_t k, uint64_t element_key) {
+    if constexpr (Bits >= 64) return element_key;
+    else return (k << Bits) | element_key;
+  }
+
+  template<typename Tuple, size_t... Is>
+  static type key(const Tuple& x, std::index_sequence<Is...>) {
+    uint64_t k = 0;
+    ((k = append<std::numeric_limits<typename radix_key_traits<Ts>::type>::digits>(
+        k, radix_key_traits<Ts>::key(std::get<Is>(x)))), ...);
+    return static_cast<type>(k);
+  }
+};
+
+template<typename T1, typename T2>
+struct radix_key_traits<std::pair<T1, T2>, std::enable_if_t<all_have_radix_keys_v<T1, T2> &&
+                                                            total_radix_key_bytes_v<T1, T2> <= 8>>
+    : tuple_radix_key_traits<T1, T2> {
+  static auto key(const std::pair<T1, T2>& x) {
+    return tuple_radix_key_traits<T1, T2>::key(x, std::index_sequence_for<T1, T2>{});
+  }
+};
+
+template<typename... Ts>
+struct radix_key_traits<std::tuple<Ts...>, std::enable_if_t<sizeof...(Ts) >= 1 && all_have_radix_keys_v<Ts...> &&
+                                                            total_radix_key_bytes_v<Ts...> <= 8>>
+    : tuple_radix_key_traits<Ts...> {
+  static auto key(const std::tuple<Ts...>& x) {
+    return tuple_radix_key_traits<Ts...>::key(x, std::index_sequence_for<Ts...>{});
+  }
+};
+
+}  // namespace internal
+
+// Whether the values of type T have radix keys, i.e., can be mapped to unsigned
+// integers by an order-preserving function. This is the case for integers,
+// floats and doubles, and pairs and tuples of these that fit in 64 bits.
+template<typename T>
+inline constexpr bool has_radix_key_v = internal::radix_key_traits<remove_cvref_t<T>>::value;
+
+// The type of the radix key of T
+template<typename T>
+using radix_key_type_t = typename internal::radix_key_traits<remove_cvref_t<T>>::type;
+
+// A function object that maps a value to its radix key, so that, for example,
+// integer_sort(A, radix_key{}) sorts a sequence of doubles or of pairs of ints.
+struct radix_key {
+  template<typename T, typename = std::enable_if_t<has_radix_key_v<T>>>
+  radix_key_type_t<T> operator()(const T& x) const {
+    return internal::radix_key_traits<remove_cvref_t<T>>::key(x);
+  }
+};
+
+namespace internal {
+
+// Sorting by the given comparison can instead be done by a radix sort on the
+// radix keys of the elements when the comparison is the default one
+template<typename T, typename Compare>
+inline constexpr bool is_radix_sortable_v = has_radix_key_v<T> &&
+    (std::is_same_v<remove_cvref_t<Compare>, std::less<>> ||
+     std::is_same_v<remove_cvref_t<Compare>, std::less<remove_cvref_t<T>>>);
+
+// Below this size, the comparison sort is faster
+#ifdef DEBUG
+constexpr size_t PARLAY_RADIX_SORT_THRESHOLD = 256;
+#else
+constexpr size_t PARLAY_RADIX_SORT_THRESHOLD = 4096;
+#endif
+
+// Returns the smallest key of the input, and the number of bits needed for
+// the keys once this is subtracted. The radix sort then only needs to look
+// at the bits that differ between keys, such as the low bits of a sequence
+// of small signed integers, whose high bits are all set once flipped.
+template<typename Iterator>
+std::pair<uint64_t, size_t> radix_key_range(slice<Iterator, Iterator> A) {
+  static_assert(sizeof(radix_key_type_t<typename slice<Iterator, Iterator>::value_type>) <= sizeof(uint64_t));
+  auto keys = delayed_seq<std::pair<uint64_t, uint64_t>>(A.size(), [&](size_t i) {
+    uint64_t k = radix_key{}(A[i]);
+    return std::make_pair(k, k);
+  });
+  auto minmax = make_monoid([](const auto& a, const auto& b) {
+    return std::make_pair((std::min)(a.first, b.first), (std::max)(a.second, b.second));
+  }, std::make_pair((std::numeric_limits<uint64_t>::max)(), uint64_t{0}));
+  auto [lo, hi] = internal::reduce(make_slice(keys), minmax);
+  size_t bits = 1;
+  while (bits < 64 && ((hi - lo) >> bits) != 0) bits++;
+  return {lo, bits};
+}
+
+// Returns a sorted copy of the input, whose elements must have radix keys
+template<typename Iterator>
+auto radix_sort(slice<Iterator, Iterator> A) {
+  auto [lo, bits] = radix_key_range(A);
+  return integer_sort(A, [lo = lo](const auto& x) { return static_cast<uint64_t>(radix_key{}(x)) - lo; }, bits);
+}
+
+// Sorts the input in place. The elements must have radix keys.
+template<typename Iterator>
+void radix_sort_inplace(slice<Iterator, Iterator> A, sort_mode mode = sort_mode::standard) {
+  auto [lo, bits] = radix_key_range(A);
+  integer_sort_inplace(A, [lo = lo](const auto& x) { return static_cast<uint64_t>(radix_key{}(x)) - lo; }, bits, mode);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_RADIX_KEY_H_
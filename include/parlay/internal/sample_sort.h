@@ -15,6 +15,7 @@
 #include <limits>
 #include <type_traits>
 
+#include "block_permutation.h"
 #include "bucket_sort.h"
 #include "quicksort.h"
 #include "sequence_ops.h"
@@ -199,6 +200,110 @@ void sample_sort_inplace_(slice<InIterator, InIterator> In,
   }
 }
 
+// In-place super scalar sample sort (IPS4o), from Axtmann, Witt, Ferizovic and
+// Sanders, "Engineering In-place (Shared-memory) Sorting Algorithms". Each level
+// draws a sample of splitters, classifies the elements by a branchless search
+// in a complete binary tree of the splitters, and distributes them into buckets
+// in place with the block permutation of block_permutation.h. If the sample
+// contains duplicates, then elements equal to a splitter are put in a bucket of
+// their own, which needs no further sorting, so that inputs with many
+// duplicates are sorted quickly. The extra memory used by a level is O(P * k)
+// blocks for P tasks and k buckets. Since the splitters are copies of elements,
+// this requires a copyable type.
+
+// The largest number of buckets, not counting buckets for equal elements
+constexpr const size_t IPS4O_MAX_BUCKETS = 256;
+
+// Classifies elements by the splitters they lie between. The splitters are
+// stored in a complete binary search tree in breadth-first (Eytzinger) order,
+// padded to a power of two minus one by repeating the largest. The bucket of
+// an element x is the number of splitters less than x, and with equal buckets,
+// buckets 2b and 2b+1 hold the elements less than and equal to splitter b.
+template <typename T, typename Compare>
+struct sample_sort_classifier {
+  sequence<T> splitters;   // The distinct splitters, in order
+  sequence<T> tree;        // The padded splitters in tree order, starting at tree[1]
+  size_t log_k;
+  bool equal_buckets;
+  const Compare& less;
+
+  sample_sort_classifier(sequence<T> splitters_, bool equal_buckets_, const Compare& less_)
+      : splitters(std::move(splitters_)), log_k(log2_up(splitters.size() + 1)),
+        equal_buckets(equal_buckets_), less(less_) {
+    size_t m = splitters.size(), k = size_t{1} << log_k;
+    tree = sequence<T>::from_function(k, [&](size_t i) -> T {
+      if (i == 0) return splitters[0];
+      // Node i at depth d is the (2(i - 2^d) + 1) * 2^(log_k - 1 - d)-th splitter
+      size_t d = log2_up(i + 1) - 1;
+      size_t rank = (2 * (i - (size_t{1} << d)) + 1) * (size_t{1} << (log_k - 1 - d)) - 1;
+      return splitters[(std::min)(rank, m - 1)];
+    });
+  }
+
+  size_t num_buckets() const { return equal_buckets ? 2 * splitters.size() + 1 : splitters.size() + 1; }
+
+  // Whether the elements of the given bucket are all equal
+  bool is_equal_bucket(size_t b) const { return equal_buckets && (b & 1); }
+
+  // The tree is searched for every element of the batch one level at a time,
+  // so that the searches are independent and can overlap
+  template<typename It>
+  void operator()(It first, size_t count, size_t* buckets) const {
+    size_t m = splitters.size(), k = size_t{1} << log_k;
+    for (size_t j = 0; j < count; j++) buckets[j] = 1;
+    for (size_t l = 0; l < log_k; l++) {
+      for (size_t j = 0; j < count; j++) {
+        buckets[j] = 2 * buckets[j] + static_cast<size_t>(less(tree[buckets[j]], first[j]));
+      }
+    }
+    for (size_t j = 0; j < count; j++) {
+      size_t b = (std::min)(buckets[j] - k, m);
+      if (equal_buckets) b = 2 * b + static_cast<size_t>(b < m && !less(first[j], splitters[b]));
+      buckets[j] = b;
+    }
+  }
+};
+
+template <typename Iterator, typename Compare>
+void ips4o_sort_(slice<Iterator, Iterator> A, const Compare& less) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  if (n < QUICKSORT_THRESHOLD) {
+    seq_sort_inplace(A, less, false);
+    return;
+  }
+
+  // Draw the sample by swapping random elements to the front, and sort it
+  size_t log_k = (std::min)(log2_up(IPS4O_MAX_BUCKETS), (std::max)(size_t{1}, log2_up(n / QUICKSORT_THRESHOLD)));
+  size_t k = size_t{1} << log_k;
+  size_t over_sample = (std::max)(size_t{1}, static_cast<size_t>(0.2 * static_cast<double>(log2_up(n))));
+  size_t sample_size = k * over_sample;
+  for (size_t i = 0; i < sample_size; i++) {
+    size_t j = i + hash64(n + i) % (n - i);
+    using std::swap;
+    swap(A[i], A[j]);
+  }
+  seq_sort_inplace(A.cut(0, sample_size), less, false);
+
+  // Take evenly spaced splitters. Use equal buckets if there are duplicates,
+  // or if there is only one splitter, since otherwise every element could
+  // end up in the same bucket.
+  sequence<value_type> splitters;
+  bool equal_buckets = false;
+  for (size_t i = 1; i < k; i++) {
+    const value_type& s = A[i * over_sample - 1];
+    if (splitters.empty() || less(splitters.back(), s)) splitters.push_back(s);
+    else equal_buckets = true;
+  }
+  equal_buckets = equal_buckets || splitters.size() == 1;
+  sample_sort_classifier<value_type, Compare> classify(std::move(splitters), equal_buckets, less);
+
+  auto offsets = inplace_distribute(A, classify, classify.num_buckets());
+  parallel_for(0, classify.num_buckets(), [&](size_t b) {
+    if (!classify.is_equal_bucket(b)) ips4o_sort_(A.cut(offsets[b], offsets[b + 1]), less);
+  }, 1);
+}
+
 // Copying version of sample sort. This one makes copies of the input
 // elements when sorting them into the output. Roughly (\sqrt{n})
 // additional copies are also made to copy the pivots. This one can
@@ -290,7 +395,15 @@ auto sample_sort(slice<Iterator, Iterator> A,
 
 template <class Iterator, typename Compare>
 void sample_sort_inplace(slice<Iterator, Iterator> A,
-                         const Compare& less) {
+                         const Compare& less,
+                         sort_mode mode = sort_mode::standard) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  if constexpr (std::is_copy_constructible_v<value_type>) {
+    if (mode == sort_mode::low_memory) {
+      ips4o_sort_(A, less);
+      return;
+    }
+  }
   if (A.size() < (std::numeric_limits<unsigned int>::max)()) {
     sample_sort_inplace_<unsigned int>(A, A, less);
   }
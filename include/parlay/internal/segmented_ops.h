@@ -0,0 +1,237 @@
+
+#ifndef PARLAY_INTERNAL_SEGMENTED_OPS_H_
+#define PARLAY_INTERNAL_SEGMENTED_OPS_H_
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../range.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+#include "sequence_ops.h"
+
+namespace parlay {
+namespace internal {
+
+// Segmented reductions and scans reduce or scan each of a sequence of
+// contiguous segments of the input independently. The work is split into
+// blocks of elements, rather than by segment, so that the load stays
+// balanced when a few huge segments are mixed with many small ones. Each
+// block handles the parts of the segments that overlap it. A segment that
+// begins in an earlier block continues with a value that is carried into
+// the block, and these carries are computed by a sequential scan over the
+// totals of the last (partial) segment of each block.
+//
+// The segments are described by either of the following, which provide
+// the same interface to the algorithms below.
+
+// Segment k consists of the positions [offsets[k], offsets[k+1]). There
+// are offsets.size() - 1 segments, some of which may be empty.
+template<typename Offsets>
+struct offset_segments {
+  Offsets offsets;
+  size_t n;
+
+  offset_segments(Offsets offsets_, size_t n_) : offsets(std::move(offsets_)), n(n_) {
+    assert(offsets.size() >= 1 && "There must be one more offset than segments");
+    assert(offset(0) == 0 && offset(offsets.size() - 1) == n &&
+           "The offsets must start at zero and end at the size of the input");
+  }
+
+  size_t num_segments() const { return offsets.size() - 1; }
+
+  size_t offset(size_t k) const { return static_cast<size_t>(offsets[k]); }
+
+  // The (non-empty) segment containing position i
+  size_t segment_of(size_t i) const {
+    auto it = std::upper_bound(offsets.begin(), offsets.end(), i,
+                               [](size_t x, const auto& o) { return x < static_cast<size_t>(o); });
+    return (it - offsets.begin()) - 1;
+  }
+
+  // The start of the last run of the block [s, e), i.e., of the part of the
+  // block in the same segment as position e - 1, and whether it starts that segment
+  std::pair<size_t, bool> last_run(size_t s, size_t e) const {
+    size_t start = offset(segment_of(e - 1));
+    return {(std::max)(s, start), start >= s};
+  }
+
+  // Calls f(k, start, end, starts_segment, ends_segment) on each maximal
+  // run [start, end) of positions in the block [s, e) in the same segment k
+  template<typename F>
+  void for_each_run(size_t, size_t s, size_t e, F&& f) const {
+    size_t k = segment_of(s), start = s, end = offset(k + 1);
+    bool starts = (s == offset(k));
+    while (end < e) {
+      f(k, start, end, starts, true);
+      start = end;
+      starts = true;
+      do { end = offset(++k + 1); } while (end == start);   // Skip empty segments
+    }
+    f(k, start, e, starts, end == e);
+  }
+};
+
+// A segment starts at position 0 and at every position i such that
+// head_flags[i] is true. If the segments need to be numbered, the number
+// of segments that start before each block is counted on construction.
+template<typename Flags>
+struct flag_segments {
+  Flags head_flags;
+  size_t n;
+  sequence<size_t> first_segment;   // The segment containing the first position of each block
+  size_t total;                     // The number of segments, if counted
+
+  flag_segments(Flags head_flags_, size_t n_, size_t block_size, bool count)
+      : head_flags(std::move(head_flags_)), n(n_), first_segment(), total(0) {
+    assert(static_cast<size_t>(head_flags.size()) == n && "There must be one flag for each element");
+    if (count && n > 0) {
+      first_segment = sequence<size_t>::from_function(num_blocks(n, block_size), [&](size_t b) {
+        size_t s = b * block_size, e = (std::min)(s + block_size, n);
+        size_t c = 0;
+        for (size_t i = s; i < e; i++) c += is_head(i);
+        return c;
+      });
+      total = scan_inplace(make_slice(first_segment), plus<size_t>());
+      parallel_for(0, first_segment.size(), [&](size_t b) {
+        first_segment[b] = first_segment[b] + is_head(b * block_size) - 1;
+      });
+    }
+  }
+
+  bool is_head(size_t i) const { return i == 0 || static_cast<bool>(head_flags[i]); }
+
+  size_t num_segments() const { return total; }
+
+  std::pair<size_t, bool> last_run(size_t s, size_t e) const {
+    size_t i = e - 1;
+    while (i > s && !is_head(i)) i--;
+    return {i, is_head(i)};
+  }
+
+  template<typename F>
+  void for_each_run(size_t b, size_t s, size_t e, F&& f) const {
+    size_t k = first_segment.empty() ? 0 : first_segment[b];
+    size_t start = s;
+    for (size_t i = s + 1; i < e; i++) {
+      if (head_flags[i]) {
+        f(k++, start, i, start != s || is_head(s), true);
+        start = i;
+      }
+    }
+    f(k, start, e, start != s || is_head(s), e == n || is_head(e));
+  }
+};
+
+inline size_t segmented_block_size(size_t n) {
+  return (std::max)(_block_size, 4 * static_cast<size_t>(std::ceil(std::sqrt(n))));
+}
+
+// Returns the value carried into each block by the segment that contains
+// its first position, i.e., the reduction of the elements of that segment
+// that precede the block
+template<typename InSeq, typename Segments, typename Monoid>
+auto segmented_carries(const InSeq& In, const Segments& segments, size_t block_size, Monoid& m) {
+  using T = monoid_value_type_t<Monoid>;
+  size_t n = In.size();
+  size_t l = num_blocks(n, block_size);
+
+  // Only the last run of each block contributes to the following blocks
+  auto starts = sequence<bool>::uninitialized(l);
+  auto tails = sequence<T>::uninitialized(l);
+  sliced_for(n, block_size, [&](size_t b, size_t s, size_t e) {
+    auto [start, starts_segment] = segments.last_run(s, e);
+    starts[b] = starts_segment;
+    assign_uninitialized(tails[b], reduce_serial(make_slice(In).cut(start, e), m));
+  });
+
+  auto carries = sequence<T>::uninitialized(l);
+  assign_uninitialized(carries[0], m.identity);
+  for (size_t b = 1; b < l; b++) {
+    if (starts[b - 1]) assign_uninitialized(carries[b], std::move(tails[b - 1]));
+    else assign_uninitialized(carries[b], m(carries[b - 1], std::move(tails[b - 1])));
+  }
+  return carries;
+}
+
+// Returns the reduction of each segment. Empty segments reduce to the identity.
+template<typename InSeq, typename Segments, typename Monoid>
+auto segmented_reduce_(const InSeq& In, const Segments& segments, size_t block_size, Monoid&& m) {
+  using T = monoid_value_type_t<Monoid>;
+  size_t n = In.size();
+  auto result = sequence<T>(segments.num_segments(), m.identity);
+  if (n == 0) return result;
+  auto carries = segmented_carries(In, segments, block_size, m);
+
+  // Each segment is written by the block containing its last position
+  sliced_for(n, block_size, [&](size_t b, size_t s, size_t e) {
+    segments.for_each_run(b, s, e, [&](size_t k, size_t start, size_t end, bool starts, bool ends) {
+      if (ends) {
+        T total = reduce_serial(make_slice(In).cut(start, end), m);
+        result[k] = starts ? std::move(total) : m(carries[b], std::move(total));
+      }
+    });
+  });
+  return result;
+}
+
+// Returns the (exclusive, or if fl_scan_inclusive is set, inclusive) scan
+// of each segment
+template<typename InSeq, typename Segments, typename Monoid>
+auto segmented_scan_(const InSeq& In, const Segments& segments, size_t block_size, Monoid&& m, flags fl) {
+  using T = monoid_value_type_t<Monoid>;
+  size_t n = In.size();
+  auto Out = sequence<T>::uninitialized(n);
+  if (n == 0) return Out;
+  auto carries = segmented_carries(In, segments, block_size, m);
+
+  sliced_for(n, block_size, [&](size_t b, size_t s, size_t e) {
+    segments.for_each_run(b, s, e, [&](size_t, size_t start, size_t end, bool starts, bool) {
+      scan_serial(make_slice(In).cut(start, end), make_slice(Out).cut(start, end), m,
+                  starts ? m.identity : carries[b], fl, true);
+    });
+  });
+  return Out;
+}
+
+// Whether a range of segment descriptors holds flags rather than offsets
+template<typename Range>
+inline constexpr bool is_segment_flags_v = std::is_same_v<std::remove_cv_t<range_value_type_t<Range>>, bool>;
+
+template<typename InSeq, typename SegSeq, typename Monoid>
+auto segmented_reduce(const InSeq& In, const SegSeq& S, Monoid&& m) {
+  size_t n = In.size();
+  size_t block_size = segmented_block_size(n);
+  if constexpr (is_segment_flags_v<SegSeq>) {
+    return segmented_reduce_(In, flag_segments(make_slice(S), n, block_size, true), block_size, std::forward<Monoid>(m));
+  }
+  else {
+    return segmented_reduce_(In, offset_segments(make_slice(S), n), block_size, std::forward<Monoid>(m));
+  }
+}
+
+template<typename InSeq, typename SegSeq, typename Monoid>
+auto segmented_scan(const InSeq& In, const SegSeq& S, Monoid&& m, flags fl = no_flag) {
+  size_t n = In.size();
+  size_t block_size = segmented_block_size(n);
+  if constexpr (is_segment_flags_v<SegSeq>) {
+    return segmented_scan_(In, flag_segments(make_slice(S), n, block_size, false), block_size, std::forward<Monoid>(m), fl);
+  }
+  else {
+    return segmented_scan_(In, offset_segments(make_slice(S), n), block_size, std::forward<Monoid>(m), fl);
+  }
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SEGMENTED_OPS_H_
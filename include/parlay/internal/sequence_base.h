@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <cstring>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <new>
@@ -31,6 +32,30 @@
 namespace parlay {
 namespace sequence_internal {
 
+// Detects allocators that can resize a buffer without copying it via a
+// (non-standard) member a.try_reallocate(ptr, old_n, new_n), such as parlay::allocator
+template<typename Alloc, typename = void>
+struct has_try_reallocate : std::false_type {};
+
+template<typename Alloc>
+struct has_try_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>> : std::true_type {};
+
+template<typename Alloc>
+inline constexpr bool has_try_reallocate_v = has_try_reallocate<Alloc>::value;
+
+// Detects allocators that can sometimes provide zero-filled memory for free via a
+// (non-standard) member a.try_allocate_zeroed(n), such as parlay::allocator
+template<typename Alloc, typename = void>
+struct has_try_allocate_zeroed : std::false_type {};
+
+template<typename Alloc>
+struct has_try_allocate_zeroed<Alloc, std::void_t<decltype(std::declval<Alloc&>().try_allocate_zeroed(size_t{}))>>
+    : std::true_type {};
+
+template<typename Alloc>
+inline constexpr bool has_try_allocate_zeroed_v = has_try_allocate_zeroed<Alloc>::value;
+
 // Sequence base class that handles storage layout and memory allocation
 //
 // Template arguments:
@@ -65,6 +90,20 @@ struct alignas(uint64_t) sequence_base {
     return (std::is_trivially_default_constructible_v<value_type>) ? (1 + (1024 * sizeof(size_t) / sizeof(T))) : 0;
   }
 
+  // True if value_type objects can be created by leaving memory filled with
+  // zero bytes, i.e., if a value-initialized object consists entirely of zero
+  // bytes, and the allocator does not customize construction. This is restricted
+  // to scalar types, since e.g., null pointers to members are not represented by
+  // zero bytes on common ABIs, so this can not be assumed for all trivial types.
+  static constexpr bool zero_bytes_initializable = std::is_scalar_v<value_type> &&
+      !std::is_member_pointer_v<value_type> && is_trivial_allocator_v<T_allocator_type, value_type>;
+
+  // Returns true if the object representation of v consists entirely of zero bytes
+  static bool is_zero_bytes(const value_type& v) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(std::addressof(v));
+    return std::all_of(bytes, bytes + sizeof(value_type), [](unsigned char b) { return b == 0; });
+  }
+
   // This class handles internal memory allocation and whether
   // the sequence is big or small. We inherit from Allocator to
   // employ empty base optimization so that the size of the
@@ -285,6 +324,17 @@ struct alignas(uint64_t) sequence_base {
           return new (bytes) header(capacity);
         }
 
+        // Returns a header whose elements are all zero bytes if the allocator can
+        // provide zeroed memory without writing to it, or nullptr otherwise
+        static header* try_create_zeroed([[maybe_unused]] size_t capacity, [[maybe_unused]] raw_allocator_type& a) {
+          if constexpr (has_try_allocate_zeroed_v<raw_allocator_type>) {
+            auto buffer_size = offsetof(header, data) + capacity * sizeof(value_type);
+            std::byte* bytes = a.try_allocate_zeroed(buffer_size);
+            if (bytes != nullptr) return new (bytes) header(capacity);
+          }
+          return nullptr;
+        }
+
         static void destroy(header* p, raw_allocator_type& a) {
           auto buffer_size = offsetof(header, data) + p->capacity * sizeof(value_type);
           std::byte* bytes = reinterpret_cast<std::byte*>(p);
@@ -305,6 +355,30 @@ struct alignas(uint64_t) sequence_base {
         assert(get_capacity() == capacity);
       }
 
+      // Take ownership of a buffer obtained from header::create or header::try_create_zeroed
+      explicit capacitated_buffer(header* buffer_) : buffer(buffer_) {
+        assert(buffer != nullptr);
+      }
+
+      // Attempt to change the capacity of the buffer without copying its contents,
+      // which is possible if the allocator supports try_reallocate. The contents
+      // of the buffer are moved bitwise, so this is only valid if value_type is
+      // trivially relocatable. Returns false and leaves the buffer untouched if
+      // this is not possible.
+      bool try_reallocate([[maybe_unused]] size_t new_capacity, [[maybe_unused]] raw_allocator_type& a) {
+        if constexpr (has_try_reallocate_v<raw_allocator_type>) {
+          if (buffer == nullptr) return false;
+          auto old_size = offsetof(header, data) + get_capacity() * sizeof(value_type);
+          auto new_size = offsetof(header, data) + new_capacity * sizeof(value_type);
+          std::byte* bytes = a.try_reallocate(reinterpret_cast<std::byte*>(buffer), old_size, new_size);
+          if (bytes != nullptr) {
+            buffer = new (bytes) header(new_capacity);
+            return true;
+          }
+        }
+        return false;
+      }
+
       // This unfortunately can not go in the destructor and be done
       // automatically because we need a reference to the allocator
       // to deallocate the buffer, and we do not want to store the
@@ -531,6 +605,29 @@ struct alignas(uint64_t) sequence_base {
       assert(capacity() >= desired);
     }
 
+    // Should only be called during initialization. Same as
+    // initialize_capacity, except that it only succeeds if it
+    // can obtain a buffer whose elements are all zero bytes
+    // without writing to it, e.g., fresh pages from the OS.
+    // Returns false and does nothing otherwise.
+    bool try_initialize_capacity_zeroed(size_t desired) {
+      if constexpr (has_try_allocate_zeroed_v<raw_allocator_type>) {
+        if (!use_sso || short_capacity < desired) {
+          auto alloc = get_raw_allocator();
+          auto buffer = capacitated_buffer::header::try_create_zeroed(desired, alloc);
+          if (buffer != nullptr) {
+            if constexpr (use_sso) {
+              _data.flag = 1;
+            }
+            _data.long_mode = long_seq(capacitated_buffer(buffer), 0);
+            assert(capacity() >= desired);
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+
     // Ensure that the capacity is at least new_capacity. The
     // actual capacity may be increased to a larger amount.
     void ensure_capacity(size_t desired) {
@@ -543,6 +640,15 @@ struct alignas(uint64_t) sequence_base {
         // 50% larger than the old capacity
         size_t new_capacity = (std::max)(desired, (5 * current)/ 2);//(15 * current + 9) / 10);
         auto alloc = get_raw_allocator();
+
+        // Large buffers of trivially relocatable types can sometimes be grown
+        // in place by the allocator, which avoids copying the old contents
+        if constexpr (is_trivially_relocatable_v<value_type> && is_trivial_allocator_v<T_allocator_type, T>) {
+          if (!is_small() && _data.long_mode.buffer.try_reallocate(new_capacity, alloc)) {
+            assert(capacity() >= desired);
+            return;
+          }
+        }
         capacitated_buffer new_buffer(new_capacity, alloc);
 
         // If uninitialized debugging is enabled, mark the new memory as uninitialized
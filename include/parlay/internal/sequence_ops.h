@@ -4,8 +4,11 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -17,6 +20,8 @@
 #include "../slice.h"
 #include "../utilities.h"
 
+#include "simd_kernels.h"
+
 namespace parlay {
 namespace internal {
 
@@ -181,6 +186,10 @@ auto reduce_serial(Seq const &A, Monoid&& m) {
   static_assert(is_monoid_for_v<Monoid, range_reference_type_t<Seq>>);
   using T = monoid_value_type_t<Monoid>;
   if (A.size() == 0) return m.identity;
+  if constexpr (can_reduce_simd_v<Seq, Monoid>) {
+    T r;
+    if (simd_reduce<simd_op_of<std::decay_t<Monoid>>()>(&*std::begin(A), A.size(), r)) return r;
+  }
   T r = A[0];
   for (size_t j = 1; j < A.size(); j++) {
     r = m(std::move(r), A[j]);
@@ -219,6 +228,12 @@ auto scan_serial(In_Seq const &In, Out_Seq Out, Monoid&& m,
   T r = std::move(offset);
   size_t n = In.size();
   bool inclusive = fl & fl_scan_inclusive;
+  if constexpr (can_scan_simd_v<In_Seq, Out_Seq, Monoid>) {
+    if (n > 0) {
+      T total;
+      if (simd_scan_add(&*std::begin(In), &*std::begin(Out), n, r, inclusive, total)) return total;
+    }
+  }
   if (inclusive) {
     for (size_t i = 0; i < n; i++) {
       r = m(std::move(r), In[i]);
@@ -236,7 +251,87 @@ auto scan_serial(In_Seq const &In, Out_Seq Out, Monoid&& m,
   return r;
 }
 
-  
+// Scans of at least this many bytes are done in a single pass, since the
+// input is too large to still be in the cache when it is read again
+constexpr const size_t _single_pass_scan_threshold = (1 << 23);
+
+// The size in bytes of each block of a single-pass scan. Blocks must be
+// small enough to stay in the cache between being reduced and scanned,
+// and large enough to make looking back across them cheap.
+constexpr const size_t _single_pass_scan_block_bytes = (1 << 16);
+
+// Whether In can be scanned in a single pass, which requires that reading
+// its elements and combining them can not fork. Delayed sequences are
+// excluded since their functions may fork, as are non-trivial copies.
+template <typename In_Seq, class Monoid>
+inline constexpr bool use_single_pass_scan_v = is_contiguous_range_v<const In_Seq> &&
+    std::is_trivially_copyable_v<range_value_type_t<In_Seq>> &&
+    std::is_trivially_copyable_v<monoid_value_type_t<Monoid>>;
+
+// Single-pass scan with decoupled look-back. Each block is reduced and its
+// total is published. The block then combines the totals of the blocks
+// before it, looking back only until it finds one whose inclusive prefix
+// is already published. It publishes its own prefix and finally scans its
+// elements, which are still in the cache. The input is therefore only read
+// from memory once, rather than twice as in the two-pass scan below.
+//
+// Blocks are claimed in increasing order from a shared counter by a fixed
+// number of tasks, rather than being assigned to tasks in advance. A
+// block therefore only ever waits on blocks that have been claimed by tasks
+// that are already running, including when some tasks never run at all.
+// This only ensures progress if processing a claimed block never forks,
+// however: a task waiting at a join could take work that then spins on
+// the block it claimed, which only it can complete. The single-pass scan is
+// therefore only used when reading the input cannot fork, i.e., when it is
+// contiguous and trivially copyable (see use_single_pass_scan_v).
+template <typename In_Seq, typename Out_Range, class Monoid>
+auto scan_single_pass_(In_Seq const &In, Out_Range Out, Monoid&& m, flags fl, bool out_uninitialized) {
+  using T = monoid_value_type_t<Monoid>;
+  enum : uint8_t { not_ready, total_ready, prefix_ready };
+  size_t n = In.size();
+  size_t block_size = (std::max)(_block_size, _single_pass_scan_block_bytes / sizeof(T));
+  size_t l = num_blocks(n, block_size);
+  auto status = sequence<std::atomic<uint8_t>>(l);
+  auto totals = sequence<T>::uninitialized(l);
+  auto prefixes = sequence<T>::uninitialized(l);
+  std::atomic<size_t> next_block{0};
+
+  auto wait_for = [&](size_t j) {
+    uint8_t st;
+    for (size_t spins = 0; (st = status[j].load(std::memory_order_acquire)) == not_ready; spins++) {
+      if (spins >= 64) std::this_thread::yield();
+    }
+    return st;
+  };
+
+  auto process_blocks = [&](size_t) {
+    for (size_t i = next_block.fetch_add(1); i < l; i = next_block.fetch_add(1)) {
+      size_t s = i * block_size, e = (std::min)(s + block_size, n);
+      T offset = m.identity;
+      T total = reduce_serial(make_slice(In).cut(s, e), m);
+      assign_uninitialized(totals[i], total);
+      if (i == 0) {
+        assign_uninitialized(prefixes[0], std::move(total));
+        status[0].store(prefix_ready, std::memory_order_release);
+      }
+      else {
+        status[i].store(total_ready, std::memory_order_release);
+        // Combine the totals of the preceding blocks, from right to left
+        // since the operator need not be commutative
+        size_t j = i - 1;
+        while (wait_for(j) == total_ready) offset = m(totals[j--], std::move(offset));
+        offset = m(prefixes[j], std::move(offset));
+        assign_uninitialized(prefixes[i], m(offset, std::move(total)));
+        status[i].store(prefix_ready, std::memory_order_release);
+      }
+      scan_serial(make_slice(In).cut(s, e), make_slice(Out).cut(s, e), m, std::move(offset), fl, out_uninitialized);
+    }
+  };
+  size_t num_tasks = (std::min)(l, num_workers());
+  parallel_for(0, num_tasks, process_blocks, 1, 0 != (fl & fl_conservative));
+  return prefixes[l - 1];
+}
+
 template <typename In_Seq, typename Out_Range, class Monoid>
 auto scan_(In_Seq const &In, Out_Range Out, Monoid&& m, flags fl, bool out_uninitialized=false) {
   static_assert(is_random_access_range_v<In_Seq>);
@@ -246,6 +341,10 @@ auto scan_(In_Seq const &In, Out_Range Out, Monoid&& m, flags fl, bool out_unini
   size_t l = num_blocks(n, _block_size);
   if (l <= 2 || fl & fl_sequential)
     return scan_serial(In, Out, m, m.identity, fl, out_uninitialized);
+  if constexpr (use_single_pass_scan_v<In_Seq, Monoid>) {
+    if (n * sizeof(T) >= _single_pass_scan_threshold)
+      return scan_single_pass_(In, Out, m, fl, out_uninitialized);
+  }
   auto sums = sequence<T>::uninitialized(l);
   sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
     assign_uninitialized(sums[i], reduce_serial(make_slice(In).cut(s, e), m));
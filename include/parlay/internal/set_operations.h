@@ -0,0 +1,244 @@
+#ifndef PARLAY_INTERNAL_SET_OPERATIONS_H_
+#define PARLAY_INTERNAL_SET_OPERATIONS_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <utility>
+
+#include "binary_search.h"
+#include "merge.h"
+#include "sequence_ops.h"
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Set operations on sorted sequences. As for std::set_union and friends, the
+// inputs may contain duplicates and are treated as multisets: an element that
+// occurs m times in A and n times in B occurs min(m, n) times in the
+// intersection, max(m, n) times in the union, and max(m - n, 0) times in the
+// difference A \ B. Elements in the output are copied from A where possible.
+//
+// Large inputs are cut into pieces by dual binary search: the larger input is
+// cut at equally spaced positions, each moved back to the start of its group
+// of equal elements, and the smaller input is cut at the same values, so that
+// each piece of one input only meets the matching piece of the other. The
+// pieces are processed in parallel, first counting the size of their output
+// and then writing it. Within a piece, an input that is much smaller than the
+// other is intersected by galloping, i.e. exponential search, for each of its
+// elements in the larger one, which takes O(m log(1 + n/m)) comparisons.
+
+// the following parameter can be tuned
+constexpr size_t SET_OPERATIONS_GALLOP_RATIO = 16;
+
+// Returns the first position at or after i of an element in A
+// that is not less than v, searching exponentially from i
+template <typename Iterator, typename T, typename BinaryOp>
+size_t gallop(slice<Iterator, Iterator> A, size_t i, const T& v, const BinaryOp& f) {
+  size_t n = A.size();
+  size_t step = 1;
+  size_t hi = i;
+  while (hi < n && f(A[hi], v)) {
+    i = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  hi = (std::min)(hi, n);
+  return i + binary_search(A.cut(i, hi), [&](const auto& x) { return f(x, v); });
+}
+
+// Calls emit on each element of A that is matched by an element of B
+template <typename Iterator1, typename Iterator2, typename BinaryOp, typename F>
+void seq_set_intersection(slice<Iterator1, Iterator1> A,
+                          slice<Iterator2, Iterator2> B,
+                          const BinaryOp& f,
+                          F&& emit) {
+  size_t nA = A.size(), nB = B.size();
+  size_t i = 0, j = 0;
+  if (nA * SET_OPERATIONS_GALLOP_RATIO < nB) {
+    for (; i < nA && j < nB; i++) {
+      j = gallop(B, j, A[i], f);
+      if (j < nB && !f(A[i], B[j])) emit(A[i]), j++;
+    }
+  }
+  else if (nB * SET_OPERATIONS_GALLOP_RATIO < nA) {
+    for (; i < nA && j < nB; j++) {
+      i = gallop(A, i, B[j], f);
+      if (i < nA && !f(B[j], A[i])) emit(A[i]), i++;
+    }
+  }
+  else {
+    while (i < nA && j < nB) {
+      if (f(A[i], B[j])) i++;
+      else if (f(B[j], A[i])) j++;
+      else emit(A[i]), i++, j++;
+    }
+  }
+}
+
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+size_t seq_set_intersection_size(slice<Iterator1, Iterator1> A,
+                                 slice<Iterator2, Iterator2> B,
+                                 const BinaryOp& f) {
+  size_t nA = A.size(), nB = B.size();
+  if (nA * SET_OPERATIONS_GALLOP_RATIO < nB || nB * SET_OPERATIONS_GALLOP_RATIO < nA) {
+    size_t count = 0;
+    seq_set_intersection(A, B, f, [&](const auto&) { count++; });
+    return count;
+  }
+
+  // Without branches on the order of the elements, which is unpredictable
+  size_t count = 0, i = 0, j = 0;
+  while (i < nA && j < nB) {
+    bool less = f(A[i], B[j]), greater = f(B[j], A[i]);
+    count += !less && !greater;
+    i += !greater;
+    j += !less;
+  }
+  return count;
+}
+
+// Calls emit on each element of the union of A and B, in order
+template <typename Iterator1, typename Iterator2, typename BinaryOp, typename F>
+void seq_set_union(slice<Iterator1, Iterator1> A,
+                   slice<Iterator2, Iterator2> B,
+                   const BinaryOp& f,
+                   F&& emit) {
+  size_t nA = A.size(), nB = B.size();
+  size_t i = 0, j = 0;
+  while (i < nA && j < nB) {
+    if (f(A[i], B[j])) emit(A[i++]);
+    else if (f(B[j], A[i])) emit(B[j++]);
+    else emit(A[i++]), j++;
+  }
+  for (; i < nA; i++) emit(A[i]);
+  for (; j < nB; j++) emit(B[j]);
+}
+
+// Calls emit on each element of A that is not matched by an element of B
+template <typename Iterator1, typename Iterator2, typename BinaryOp, typename F>
+void seq_set_difference(slice<Iterator1, Iterator1> A,
+                        slice<Iterator2, Iterator2> B,
+                        const BinaryOp& f,
+                        F&& emit) {
+  size_t nA = A.size(), nB = B.size();
+  size_t i = 0, j = 0;
+  bool skewed = nA * SET_OPERATIONS_GALLOP_RATIO < nB;
+  for (; i < nA && j < nB; i++) {
+    if (skewed) j = gallop(B, j, A[i], f);
+    else while (j < nB && f(B[j], A[i])) j++;
+    if (j < nB && !f(A[i], B[j])) j++;
+    else emit(A[i]);
+  }
+  for (; i < nA; i++) emit(A[i]);
+}
+
+// Returns the positions at which A and B are cut into num_pieces pieces,
+// as pairs of positions in A and in B. The cuts are equally spaced in the
+// larger of the two, and are moved back to the start of a group of equal
+// elements, so that equal elements are always in the same piece.
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+sequence<std::pair<size_t, size_t>> set_operation_cuts(slice<Iterator1, Iterator1> A,
+                                                       slice<Iterator2, Iterator2> B,
+                                                       size_t num_pieces,
+                                                       const BinaryOp& f) {
+  size_t nA = A.size(), nB = B.size();
+  return sequence<std::pair<size_t, size_t>>::from_function(num_pieces + 1, [&](size_t p) {
+    if (p == 0) return std::make_pair(size_t{0}, size_t{0});
+    if (p == num_pieces) return std::make_pair(nA, nB);
+    auto cut_at = [&](const auto& v) {
+      return std::make_pair(binary_search(A, [&](const auto& x) { return f(x, v); }),
+                            binary_search(B, [&](const auto& x) { return f(x, v); }));
+    };
+    return nA >= nB ? cut_at(A[p * nA / num_pieces]) : cut_at(B[p * nB / num_pieces]);
+  }, 1);
+}
+
+template <typename Iterator1, typename Iterator2>
+size_t set_operation_pieces(slice<Iterator1, Iterator1> A, slice<Iterator2, Iterator2> B) {
+  return (std::min)(8 * num_workers(), (A.size() + B.size()) / _merge_base);
+}
+
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+size_t set_intersection_size(slice<Iterator1, Iterator1> A,
+                             slice<Iterator2, Iterator2> B,
+                             const BinaryOp& f) {
+  size_t num_pieces = set_operation_pieces(A, B);
+  if (num_pieces <= 1) return seq_set_intersection_size(A, B, f);
+  auto cuts = set_operation_cuts(A, B, num_pieces, f);
+  auto sizes = sequence<size_t>::from_function(num_pieces, [&](size_t p) {
+    return seq_set_intersection_size(A.cut(cuts[p].first, cuts[p + 1].first),
+                                     B.cut(cuts[p].second, cuts[p + 1].second), f);
+  }, 1);
+  return internal::reduce(make_slice(sizes), plus<size_t>());
+}
+
+// Applies the sequential set operation op to each piece of A and B in
+// parallel, and returns the concatenation of the results. The size of the
+// output of a piece is given by output_size(size of A, size of B, size of
+// their intersection).
+template <typename Iterator1, typename Iterator2, typename BinaryOp, typename SeqOp, typename SizeF>
+auto set_operation(slice<Iterator1, Iterator1> A,
+                   slice<Iterator2, Iterator2> B,
+                   const BinaryOp& f,
+                   const SeqOp& op,
+                   const SizeF& output_size) {
+  using T = typename slice<Iterator1, Iterator1>::value_type;
+  size_t num_pieces = (std::max)(size_t{1}, set_operation_pieces(A, B));
+  auto cuts = set_operation_cuts(A, B, num_pieces, f);
+  auto piece_A = [&](size_t p) { return A.cut(cuts[p].first, cuts[p + 1].first); };
+  auto piece_B = [&](size_t p) { return B.cut(cuts[p].second, cuts[p + 1].second); };
+  auto offsets = sequence<size_t>::from_function(num_pieces, [&](size_t p) {
+    auto a = piece_A(p);
+    auto b = piece_B(p);
+    return output_size(a.size(), b.size(), seq_set_intersection_size(a, b, f));
+  }, 1);
+  size_t m = scan_inplace(make_slice(offsets), plus<size_t>());
+
+  auto R = sequence<T>::uninitialized(m);
+  parallel_for(0, num_pieces, [&](size_t p) {
+    size_t k = offsets[p];
+    op(piece_A(p), piece_B(p), f, [&](const auto& x) {
+      assign_dispatch(R[k++], x, uninitialized_copy_tag{});
+    });
+  }, 1);
+  return R;
+}
+
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+auto set_intersection(slice<Iterator1, Iterator1> A,
+                      slice<Iterator2, Iterator2> B,
+                      const BinaryOp& f) {
+  return set_operation(A, B, f,
+    [](auto a, auto b, const auto& g, auto&& emit) { seq_set_intersection(a, b, g, emit); },
+    [](size_t, size_t, size_t c) { return c; });
+}
+
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+auto set_union(slice<Iterator1, Iterator1> A,
+               slice<Iterator2, Iterator2> B,
+               const BinaryOp& f) {
+  return set_operation(A, B, f,
+    [](auto a, auto b, const auto& g, auto&& emit) { seq_set_union(a, b, g, emit); },
+    [](size_t nA, size_t nB, size_t c) { return nA + nB - c; });
+}
+
+template <typename Iterator1, typename Iterator2, typename BinaryOp>
+auto set_difference(slice<Iterator1, Iterator1> A,
+                    slice<Iterator2, Iterator2> B,
+                    const BinaryOp& f) {
+  return set_operation(A, B, f,
+    [](auto a, auto b, const auto& g, auto&& emit) { seq_set_difference(a, b, g, emit); },
+    [](size_t nA, size_t, size_t c) { return nA - c; });
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SET_OPERATIONS_H_
@@ -0,0 +1,551 @@
+
+#ifndef PARLAY_INTERNAL_SIMD_KERNELS_H_
+#define PARLAY_INTERNAL_SIMD_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "../monoid.h"
+#include "../range.h"
+
+// Explicitly vectorized kernels for the sequential (per-block) parts of
+// reduce and scan. They are used for contiguous ranges of 32- or 64-bit
+// integers, floats, or doubles, with the plus, minimum, and maximum
+// monoids (or the legacy addm, minm, and maxm). The compiler does not
+// reliably vectorize the generic loops, and cannot vectorize floating
+// point reductions at all without being allowed to reassociate them.
+//
+// The kernels are compiled for AVX2 and AVX-512 regardless of the flags
+// that the library is compiled with, and the best one supported by the
+// CPU is chosen at runtime. Other compilers and architectures use the
+// generic loops. Define PARLAY_NO_SIMD_KERNELS to disable them.
+//
+// Since the kernels reassociate the operations, the results of floating
+// point sums may differ slightly from those of the generic loops, in the
+// same way as they already depend on how the input is split into blocks.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(PARLAY_NO_SIMD_KERNELS)
+#define PARLAY_SIMD_KERNELS
+#include <immintrin.h>
+#define PARLAY_TARGET_AVX2 __attribute__((__target__("avx2")))
+#define PARLAY_TARGET_AVX512 __attribute__((__target__("avx512f")))
+#endif
+
+namespace parlay {
+namespace internal {
+
+enum class simd_op { add, min, max };
+
+// Identifies the monoids that have vectorized kernels, and their operation
+template<typename Monoid>
+struct simd_monoid : public std::false_type {};
+
+template<typename T>
+struct simd_monoid<plus<T>> : public std::true_type { static constexpr simd_op op = simd_op::add; };
+
+template<typename T>
+struct simd_monoid<minimum<T>> : public std::true_type { static constexpr simd_op op = simd_op::min; };
+
+template<typename T>
+struct simd_monoid<maximum<T>> : public std::true_type { static constexpr simd_op op = simd_op::max; };
+
+template<typename T>
+struct simd_monoid<legacy_monoid_adapter<addm<T>>> : public std::true_type { static constexpr simd_op op = simd_op::add; };
+
+template<typename T>
+struct simd_monoid<legacy_monoid_adapter<minm<T>>> : public std::true_type { static constexpr simd_op op = simd_op::min; };
+
+template<typename T>
+struct simd_monoid<legacy_monoid_adapter<maxm<T>>> : public std::true_type { static constexpr simd_op op = simd_op::max; };
+
+// Whether there is a kernel for the operation Op on elements of type T.
+// Additions of unsigned integers use the signed kernels since they are
+// bitwise identical, but comparisons are only supported for signed types.
+template<typename T, simd_op Op>
+inline constexpr bool is_simd_type_v =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8) &&
+     (Op == simd_op::add || std::is_signed_v<T>)) ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<typename Monoid>
+constexpr simd_op simd_op_of() {
+  if constexpr (simd_monoid<Monoid>::value) return simd_monoid<Monoid>::op;
+  else return simd_op::add;
+}
+
+// Whether a range of type Range can be reduced by the vectorized kernels using Monoid
+template<typename Range, typename Monoid, typename M = std::decay_t<Monoid>>
+inline constexpr bool can_reduce_simd_v = [] {
+  if constexpr (simd_monoid<M>::value && is_contiguous_range_v<Range>) {
+    using T = monoid_value_type_t<M>;
+    return std::is_same_v<std::remove_cv_t<range_value_type_t<Range>>, T> && is_simd_type_v<T, simd_monoid<M>::op>;
+  }
+  else return false;
+}();
+
+// Whether a range of type In can be scanned into a range of type Out by the
+// vectorized kernels using Monoid. Only sums are supported.
+template<typename In, typename Out, typename Monoid, typename M = std::decay_t<Monoid>>
+inline constexpr bool can_scan_simd_v = [] {
+  if constexpr (can_reduce_simd_v<In, Monoid> && simd_op_of<M>() == simd_op::add && is_contiguous_range_v<Out>) {
+    return std::is_same_v<range_value_type_t<Out>, monoid_value_type_t<M>> &&
+           !std::is_const_v<std::remove_reference_t<range_reference_type_t<Out>>>;
+  }
+  else return false;
+}();
+
+template<simd_op Op, typename T>
+inline T simd_combine_scalar(T a, T b) {
+  if constexpr (Op == simd_op::add) return a + b;
+  else if constexpr (Op == simd_op::min) return (std::min)(a, b);
+  else return (std::max)(a, b);
+}
+
+#if defined(PARLAY_SIMD_KERNELS)
+
+// GCC 12 warns about the deliberately undefined values that its AVX-512
+// intrinsics use for unmasked operations
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// The type whose vector operations are used for elements of type T
+template<typename T>
+using simd_lane_t = std::conditional_t<std::is_floating_point_v<T>, T,
+                    std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>;
+
+// ----------------------------------------------------------------------------
+//                                    AVX2
+// ----------------------------------------------------------------------------
+
+template<typename Lane>
+struct avx2_ops;
+
+template<>
+struct avx2_ops<int32_t> {
+  using vec = __m256i;
+  static constexpr size_t width = 8;
+
+  PARLAY_TARGET_AVX2 static vec load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+  PARLAY_TARGET_AVX2 static void store(void* p, vec x) { _mm256_storeu_si256(static_cast<__m256i*>(p), x); }
+  PARLAY_TARGET_AVX2 static vec set1(int32_t x) { return _mm256_set1_epi32(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX2 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm256_add_epi32(a, b);
+    else if constexpr (Op == simd_op::min) return _mm256_min_epi32(a, b);
+    else return _mm256_max_epi32(a, b);
+  }
+
+  // Inclusive prefix sum of the lanes: shift and add within each 128-bit
+  // half, then add the last element of the low half to the high half
+  PARLAY_TARGET_AVX2 static vec prefix_sum(vec x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    vec t = _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xFF);
+    return _mm256_add_epi32(x, t);
+  }
+
+  // Shift the lanes up by one, shifting in a zero
+  PARLAY_TARGET_AVX2 static vec shift_in_zero(vec x) {
+    vec t = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+    return _mm256_blend_epi32(t, _mm256_setzero_si256(), 0x01);
+  }
+
+  PARLAY_TARGET_AVX2 static vec broadcast_last(vec x) { return _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7)); }
+};
+
+template<>
+struct avx2_ops<int64_t> {
+  using vec = __m256i;
+  static constexpr size_t width = 4;
+
+  PARLAY_TARGET_AVX2 static vec load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+  PARLAY_TARGET_AVX2 static void store(void* p, vec x) { _mm256_storeu_si256(static_cast<__m256i*>(p), x); }
+  PARLAY_TARGET_AVX2 static vec set1(int64_t x) { return _mm256_set1_epi64x(x); }
+
+  // AVX2 has no 64-bit min and max, so they are built from a comparison
+  template<simd_op Op>
+  PARLAY_TARGET_AVX2 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm256_add_epi64(a, b);
+    else if constexpr (Op == simd_op::min) return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    else return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+  }
+
+  PARLAY_TARGET_AVX2 static vec prefix_sum(vec x) {
+    x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+    vec t = _mm256_shuffle_epi32(_mm256_permute2x128_si256(x, x, 0x08), 0xEE);
+    return _mm256_add_epi64(x, t);
+  }
+
+  PARLAY_TARGET_AVX2 static vec shift_in_zero(vec x) {
+    return _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), _mm256_setzero_si256(), 0x03);
+  }
+
+  PARLAY_TARGET_AVX2 static vec broadcast_last(vec x) { return _mm256_permute4x64_epi64(x, 0xFF); }
+};
+
+template<>
+struct avx2_ops<float> {
+  using vec = __m256;
+  static constexpr size_t width = 8;
+
+  PARLAY_TARGET_AVX2 static vec load(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+  PARLAY_TARGET_AVX2 static void store(void* p, vec x) { _mm256_storeu_ps(static_cast<float*>(p), x); }
+  PARLAY_TARGET_AVX2 static vec set1(float x) { return _mm256_set1_ps(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX2 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm256_add_ps(a, b);
+    else if constexpr (Op == simd_op::min) return _mm256_min_ps(a, b);
+    else return _mm256_max_ps(a, b);
+  }
+
+  PARLAY_TARGET_AVX2 static vec prefix_sum(vec x) {
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    vec t = _mm256_permute_ps(_mm256_permute2f128_ps(x, x, 0x08), 0xFF);
+    return _mm256_add_ps(x, t);
+  }
+
+  PARLAY_TARGET_AVX2 static vec shift_in_zero(vec x) {
+    vec t = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+    return _mm256_blend_ps(t, _mm256_setzero_ps(), 0x01);
+  }
+
+  PARLAY_TARGET_AVX2 static vec broadcast_last(vec x) { return _mm256_permutevar8x32_ps(x, _mm256_set1_epi32(7)); }
+};
+
+template<>
+struct avx2_ops<double> {
+  using vec = __m256d;
+  static constexpr size_t width = 4;
+
+  PARLAY_TARGET_AVX2 static vec load(const void* p) { return _mm256_loadu_pd(static_cast<const double*>(p)); }
+  PARLAY_TARGET_AVX2 static void store(void* p, vec x) { _mm256_storeu_pd(static_cast<double*>(p), x); }
+  PARLAY_TARGET_AVX2 static vec set1(double x) { return _mm256_set1_pd(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX2 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm256_add_pd(a, b);
+    else if constexpr (Op == simd_op::min) return _mm256_min_pd(a, b);
+    else return _mm256_max_pd(a, b);
+  }
+
+  PARLAY_TARGET_AVX2 static vec prefix_sum(vec x) {
+    x = _mm256_add_pd(x, _mm256_castsi256_pd(_mm256_slli_si256(_mm256_castpd_si256(x), 8)));
+    vec t = _mm256_permute_pd(_mm256_permute2f128_pd(x, x, 0x08), 0xF);
+    return _mm256_add_pd(x, t);
+  }
+
+  PARLAY_TARGET_AVX2 static vec shift_in_zero(vec x) {
+    return _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), _mm256_setzero_pd(), 0x1);
+  }
+
+  PARLAY_TARGET_AVX2 static vec broadcast_last(vec x) { return _mm256_permute4x64_pd(x, 0xFF); }
+};
+
+// ----------------------------------------------------------------------------
+//                                  AVX-512
+// ----------------------------------------------------------------------------
+
+template<typename Lane>
+struct avx512_ops;
+
+template<>
+struct avx512_ops<int32_t> {
+  using vec = __m512i;
+  static constexpr size_t width = 16;
+
+  PARLAY_TARGET_AVX512 static vec load(const void* p) { return _mm512_loadu_si512(p); }
+  PARLAY_TARGET_AVX512 static void store(void* p, vec x) { _mm512_storeu_si512(p, x); }
+  PARLAY_TARGET_AVX512 static vec set1(int32_t x) { return _mm512_set1_epi32(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX512 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm512_add_epi32(a, b);
+    else if constexpr (Op == simd_op::min) return _mm512_min_epi32(a, b);
+    else return _mm512_max_epi32(a, b);
+  }
+
+  // Inclusive prefix sum of the lanes, by adding the lanes shifted up by 1, 2, 4, and 8
+  PARLAY_TARGET_AVX512 static vec prefix_sum(vec x) {
+    vec z = _mm512_setzero_si512();
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, z, 15));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, z, 14));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, z, 12));
+    return _mm512_add_epi32(x, _mm512_alignr_epi32(x, z, 8));
+  }
+
+  PARLAY_TARGET_AVX512 static vec shift_in_zero(vec x) { return _mm512_alignr_epi32(x, _mm512_setzero_si512(), 15); }
+
+  PARLAY_TARGET_AVX512 static vec broadcast_last(vec x) { return _mm512_permutexvar_epi32(_mm512_set1_epi32(15), x); }
+};
+
+template<>
+struct avx512_ops<int64_t> {
+  using vec = __m512i;
+  static constexpr size_t width = 8;
+
+  PARLAY_TARGET_AVX512 static vec load(const void* p) { return _mm512_loadu_si512(p); }
+  PARLAY_TARGET_AVX512 static void store(void* p, vec x) { _mm512_storeu_si512(p, x); }
+  PARLAY_TARGET_AVX512 static vec set1(int64_t x) { return _mm512_set1_epi64(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX512 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm512_add_epi64(a, b);
+    else if constexpr (Op == simd_op::min) return _mm512_min_epi64(a, b);
+    else return _mm512_max_epi64(a, b);
+  }
+
+  PARLAY_TARGET_AVX512 static vec prefix_sum(vec x) {
+    vec z = _mm512_setzero_si512();
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 7));
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 6));
+    return _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 4));
+  }
+
+  PARLAY_TARGET_AVX512 static vec shift_in_zero(vec x) { return _mm512_alignr_epi64(x, _mm512_setzero_si512(), 7); }
+
+  PARLAY_TARGET_AVX512 static vec broadcast_last(vec x) { return _mm512_permutexvar_epi64(_mm512_set1_epi64(7), x); }
+};
+
+template<>
+struct avx512_ops<float> {
+  using vec = __m512;
+  static constexpr size_t width = 16;
+
+  PARLAY_TARGET_AVX512 static vec load(const void* p) { return _mm512_loadu_ps(p); }
+  PARLAY_TARGET_AVX512 static void store(void* p, vec x) { _mm512_storeu_ps(p, x); }
+  PARLAY_TARGET_AVX512 static vec set1(float x) { return _mm512_set1_ps(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX512 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm512_add_ps(a, b);
+    else if constexpr (Op == simd_op::min) return _mm512_min_ps(a, b);
+    else return _mm512_max_ps(a, b);
+  }
+
+  PARLAY_TARGET_AVX512 static vec prefix_sum(vec x) {
+    x = _mm512_add_ps(x, shift<15>(x));
+    x = _mm512_add_ps(x, shift<14>(x));
+    x = _mm512_add_ps(x, shift<12>(x));
+    return _mm512_add_ps(x, shift<8>(x));
+  }
+
+  PARLAY_TARGET_AVX512 static vec shift_in_zero(vec x) { return shift<15>(x); }
+
+  PARLAY_TARGET_AVX512 static vec broadcast_last(vec x) { return _mm512_permutexvar_ps(_mm512_set1_epi32(15), x); }
+
+ private:
+  template<int k>
+  PARLAY_TARGET_AVX512 static vec shift(vec x) {
+    return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(x), _mm512_setzero_si512(), k));
+  }
+};
+
+template<>
+struct avx512_ops<double> {
+  using vec = __m512d;
+  static constexpr size_t width = 8;
+
+  PARLAY_TARGET_AVX512 static vec load(const void* p) { return _mm512_loadu_pd(p); }
+  PARLAY_TARGET_AVX512 static void store(void* p, vec x) { _mm512_storeu_pd(p, x); }
+  PARLAY_TARGET_AVX512 static vec set1(double x) { return _mm512_set1_pd(x); }
+
+  template<simd_op Op>
+  PARLAY_TARGET_AVX512 static vec combine(vec a, vec b) {
+    if constexpr (Op == simd_op::add) return _mm512_add_pd(a, b);
+    else if constexpr (Op == simd_op::min) return _mm512_min_pd(a, b);
+    else return _mm512_max_pd(a, b);
+  }
+
+  PARLAY_TARGET_AVX512 static vec prefix_sum(vec x) {
+    x = _mm512_add_pd(x, shift<7>(x));
+    x = _mm512_add_pd(x, shift<6>(x));
+    return _mm512_add_pd(x, shift<4>(x));
+  }
+
+  PARLAY_TARGET_AVX512 static vec shift_in_zero(vec x) { return shift<7>(x); }
+
+  PARLAY_TARGET_AVX512 static vec broadcast_last(vec x) { return _mm512_permutexvar_pd(_mm512_set1_epi64(7), x); }
+
+ private:
+  template<int k>
+  PARLAY_TARGET_AVX512 static vec shift(vec x) {
+    return _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(x), _mm512_setzero_si512(), k));
+  }
+};
+
+// ----------------------------------------------------------------------------
+//                                  Kernels
+// ----------------------------------------------------------------------------
+
+// The kernels for each instruction set are identical except for their
+// target attribute, which can not be a template parameter.
+
+// Reduce A[0, n) with the operation Op. Requires n >= 4 * width.
+template<simd_op Op, typename T>
+PARLAY_TARGET_AVX2 T simd_reduce_avx2(const T* A, size_t n) {
+  using ops = avx2_ops<simd_lane_t<T>>;
+  using vec = typename ops::vec;
+  constexpr size_t w = ops::width;
+  // Four independent accumulators hide the latency of the operation
+  vec r0 = ops::load(A), r1 = ops::load(A + w), r2 = ops::load(A + 2 * w), r3 = ops::load(A + 3 * w);
+  size_t i = 4 * w;
+  for (; i + 4 * w <= n; i += 4 * w) {
+    r0 = ops::template combine<Op>(r0, ops::load(A + i));
+    r1 = ops::template combine<Op>(r1, ops::load(A + i + w));
+    r2 = ops::template combine<Op>(r2, ops::load(A + i + 2 * w));
+    r3 = ops::template combine<Op>(r3, ops::load(A + i + 3 * w));
+  }
+  r0 = ops::template combine<Op>(ops::template combine<Op>(r0, r1), ops::template combine<Op>(r2, r3));
+  for (; i + w <= n; i += w) r0 = ops::template combine<Op>(r0, ops::load(A + i));
+  T lanes[w];
+  ops::store(lanes, r0);
+  T r = lanes[0];
+  for (size_t j = 1; j < w; j++) r = simd_combine_scalar<Op>(r, lanes[j]);
+  for (; i < n; i++) r = simd_combine_scalar<Op>(r, A[i]);
+  return r;
+}
+
+template<simd_op Op, typename T>
+PARLAY_TARGET_AVX512 T simd_reduce_avx512(const T* A, size_t n) {
+  using ops = avx512_ops<simd_lane_t<T>>;
+  using vec = typename ops::vec;
+  constexpr size_t w = ops::width;
+  vec r0 = ops::load(A), r1 = ops::load(A + w), r2 = ops::load(A + 2 * w), r3 = ops::load(A + 3 * w);
+  size_t i = 4 * w;
+  for (; i + 4 * w <= n; i += 4 * w) {
+    r0 = ops::template combine<Op>(r0, ops::load(A + i));
+    r1 = ops::template combine<Op>(r1, ops::load(A + i + w));
+    r2 = ops::template combine<Op>(r2, ops::load(A + i + 2 * w));
+    r3 = ops::template combine<Op>(r3, ops::load(A + i + 3 * w));
+  }
+  r0 = ops::template combine<Op>(ops::template combine<Op>(r0, r1), ops::template combine<Op>(r2, r3));
+  for (; i + w <= n; i += w) r0 = ops::template combine<Op>(r0, ops::load(A + i));
+  T lanes[w];
+  ops::store(lanes, r0);
+  T r = lanes[0];
+  for (size_t j = 1; j < w; j++) r = simd_combine_scalar<Op>(r, lanes[j]);
+  for (; i < n; i++) r = simd_combine_scalar<Op>(r, A[i]);
+  return r;
+}
+
+// Write the prefix sums of In[0, n), starting from offset, to Out[0, n),
+// and return the total. In and Out may be the same. Each vector is summed
+// in registers, so the only dependency between consecutive vectors is the
+// addition of the running total.
+template<typename T>
+PARLAY_TARGET_AVX2 T simd_scan_add_avx2(const T* In, T* Out, size_t n, T offset, bool inclusive) {
+  using ops = avx2_ops<simd_lane_t<T>>;
+  using vec = typename ops::vec;
+  constexpr size_t w = ops::width;
+  vec carry = ops::set1(static_cast<simd_lane_t<T>>(offset));
+  size_t i = 0;
+  for (; i + w <= n; i += w) {
+    vec p = ops::prefix_sum(ops::load(In + i));
+    ops::store(Out + i, ops::template combine<simd_op::add>(inclusive ? p : ops::shift_in_zero(p), carry));
+    carry = ops::template combine<simd_op::add>(ops::broadcast_last(p), carry);
+  }
+  T lanes[w];
+  ops::store(lanes, carry);
+  T r = lanes[0];
+  for (; i < n; i++) {
+    T t = In[i];
+    if (inclusive) Out[i] = r = r + t;
+    else { Out[i] = r; r = r + t; }
+  }
+  return r;
+}
+
+template<typename T>
+PARLAY_TARGET_AVX512 T simd_scan_add_avx512(const T* In, T* Out, size_t n, T offset, bool inclusive) {
+  using ops = avx512_ops<simd_lane_t<T>>;
+  using vec = typename ops::vec;
+  constexpr size_t w = ops::width;
+  vec carry = ops::set1(static_cast<simd_lane_t<T>>(offset));
+  size_t i = 0;
+  for (; i + w <= n; i += w) {
+    vec p = ops::prefix_sum(ops::load(In + i));
+    ops::store(Out + i, ops::template combine<simd_op::add>(inclusive ? p : ops::shift_in_zero(p), carry));
+    carry = ops::template combine<simd_op::add>(ops::broadcast_last(p), carry);
+  }
+  T lanes[w];
+  ops::store(lanes, carry);
+  T r = lanes[0];
+  for (; i < n; i++) {
+    T t = In[i];
+    if (inclusive) Out[i] = r = r + t;
+    else { Out[i] = r; r = r + t; }
+  }
+  return r;
+}
+
+enum class simd_level { none, avx2, avx512 };
+
+// The best instruction set supported by the CPU, detected once
+inline simd_level detect_simd_level() {
+  static const simd_level level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+    return simd_level::none;
+  }();
+  return level;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // defined(PARLAY_SIMD_KERNELS)
+
+// Inputs smaller than this are not worth vectorizing. It is also at least
+// four vectors for every instruction set, as required by the kernels.
+inline constexpr size_t simd_min_size = 64;
+
+// Reduce A[0, n) with the operation Op into result, and return true, if
+// the CPU supports one of the vectorized kernels. Otherwise return false.
+template<simd_op Op, typename T>
+bool simd_reduce([[maybe_unused]] const T* A, [[maybe_unused]] size_t n, [[maybe_unused]] T& result) {
+#if defined(PARLAY_SIMD_KERNELS)
+  if (n >= simd_min_size) {
+    switch (detect_simd_level()) {
+      case simd_level::avx512: result = simd_reduce_avx512<Op>(A, n); return true;
+      case simd_level::avx2: result = simd_reduce_avx2<Op>(A, n); return true;
+      default: break;
+    }
+  }
+#endif
+  return false;
+}
+
+// Write the (inclusive or exclusive) prefix sums of In[0, n), starting from
+// offset, into Out[0, n), store the total in result, and return true, if
+// the CPU supports one of the vectorized kernels. Otherwise return false.
+template<typename T>
+bool simd_scan_add([[maybe_unused]] const T* In, [[maybe_unused]] T* Out, [[maybe_unused]] size_t n,
+                   [[maybe_unused]] T offset, [[maybe_unused]] bool inclusive, [[maybe_unused]] T& result) {
+#if defined(PARLAY_SIMD_KERNELS)
+  if (n >= simd_min_size) {
+    switch (detect_simd_level()) {
+      case simd_level::avx512: result = simd_scan_add_avx512(In, Out, n, offset, inclusive); return true;
+      case simd_level::avx2: result = simd_scan_add_avx2(In, Out, n, offset, inclusive); return true;
+      default: break;
+    }
+  }
+#endif
+  return false;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SIMD_KERNELS_H_
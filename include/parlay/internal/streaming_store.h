@@ -0,0 +1,119 @@
+
+#ifndef PARLAY_INTERNAL_STREAMING_STORE_H_
+#define PARLAY_INTERNAL_STREAMING_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "../parallel.h"
+
+// Non-temporal ("streaming") stores write directly to memory, bypassing
+// the cache. For large outputs that will not be read again soon, this
+// avoids evicting useful data from the cache, and avoids reading each
+// destination cache line from memory before overwriting it. They are
+// used by copy, relocation, and the bucket transpose of the sorts when
+// the output is larger than streaming_threshold bytes.
+//
+// Streaming stores are weakly ordered, so each thread that issues them
+// must execute streaming_fence before its writes are published to other
+// threads. Define PARLAY_NO_STREAMING_STORES to disable them.
+
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && \
+    !defined(PARLAY_NO_STREAMING_STORES)
+#define PARLAY_STREAMING_STORES
+#include <immintrin.h>
+#endif
+
+namespace parlay {
+namespace internal {
+
+// Outputs of at least this many bytes are written with streaming stores.
+// It should be larger than the last-level cache, since smaller outputs
+// are likely to still be in the cache when they are next read.
+#ifdef PARLAY_STREAMING_THRESHOLD
+inline constexpr size_t streaming_threshold = PARLAY_STREAMING_THRESHOLD;
+#else
+inline constexpr size_t streaming_threshold = size_t{1} << 26;
+#endif
+
+// Whether an output of the given size should be written with streaming stores
+inline bool use_streaming_stores([[maybe_unused]] size_t bytes) {
+#ifdef PARLAY_STREAMING_STORES
+  return bytes >= streaming_threshold;
+#else
+  return false;
+#endif
+}
+
+// Whether objects of type T can be written with streaming stores, i.e.,
+// whether copying them byte by byte is a valid way to assign them
+template<typename T>
+inline constexpr bool is_streamable_v = std::is_trivially_copyable_v<T>;
+
+// Orders all preceding streaming stores of the calling thread before
+// any of its later stores
+inline void streaming_fence() {
+#ifdef PARLAY_STREAMING_STORES
+  _mm_sfence();
+#endif
+}
+
+// Copy n bytes from src to dest using streaming stores, except for the
+// unaligned bytes at either end. Does not fence.
+inline void streaming_memcpy_unfenced(void* dest, const void* src, size_t n) {
+#ifdef PARLAY_STREAMING_STORES
+#if defined(__AVX__)
+  using vector_type = __m256i;
+#else
+  using vector_type = __m128i;
+#endif
+  constexpr size_t vector_size = sizeof(vector_type);
+  auto d = static_cast<char*>(dest);
+  auto s = static_cast<const char*>(src);
+
+  size_t head = (vector_size - reinterpret_cast<uintptr_t>(d) % vector_size) % vector_size;
+  if (head > n) head = n;
+  std::memcpy(d, s, head);
+  d += head; s += head; n -= head;
+
+  for (; n >= vector_size; d += vector_size, s += vector_size, n -= vector_size) {
+#if defined(__AVX__)
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+#else
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+#endif
+  }
+  std::memcpy(d, s, n);
+#else
+  std::memcpy(dest, src, n);
+#endif
+}
+
+// Copy n bytes from src to dest using streaming stores, followed by a fence
+inline void streaming_memcpy(void* dest, const void* src, size_t n) {
+  streaming_memcpy_unfenced(dest, src, n);
+  streaming_fence();
+}
+
+// Copy n objects from in to out in parallel using streaming stores.
+// Every chunk is fenced by the worker that copied it.
+template<typename T>
+void streaming_copy_n(const T* in, size_t n, T* out) {
+  static_assert(is_streamable_v<T>);
+  constexpr size_t chunk_size = (std::max)(size_t{1}, (size_t{1} << 16) / sizeof(T));
+  size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+  parallel_for(0, n_chunks, [&](size_t i) {
+    size_t start = i * chunk_size;
+    size_t len = (std::min)(chunk_size, n - start);
+    streaming_memcpy(static_cast<void*>(out + start), static_cast<const void*>(in + start), len * sizeof(T));
+  }, 1);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_STREAMING_STORE_H_
@@ -0,0 +1,279 @@
+#ifndef PARLAY_INTERNAL_STRING_SORT_H_
+#define PARLAY_INTERNAL_STRING_SORT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "counting_sort.h"
+#include "sequence_ops.h"
+
+#include "../delayed_sequence.h"
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../range.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// String sorting sorts a sequence of strings, i.e., of ranges of one-byte
+// characters, without comparing them in full. It sorts references to the
+// strings by a parallel most-significant-digit radix sort on one character
+// at a time, so that each character of the distinguishing prefixes of the
+// strings is looked at only once per level. Buckets below a threshold size
+// are sorted sequentially by multikey quicksort on seven characters at a
+// time, and tiny ones by insertion sort.
+//
+// Characters are compared as unsigned bytes, which is the order used by
+// std::string and strcmp (but not by operator< on sequences of signed chars).
+
+// the following parameters can be tuned
+constexpr size_t STRING_SORT_RADIX_THRESHOLD = 1 << 14;
+constexpr size_t STRING_SORT_INSERTION_THRESHOLD = 16;
+
+// A reference to the characters of one of the strings being sorted, and its
+// position in the input. Sorting these rather than the indices of the strings
+// saves an indirection through the input on every access to a character.
+template<typename CharIterator, typename Index>
+struct string_ref {
+  CharIterator first;
+  Index length;
+  Index index;
+
+  CharIterator begin() const { return first; }
+  CharIterator end() const { return first + length; }
+  size_t size() const { return length; }
+};
+
+// Character d of a string as one of 257 buckets, where bucket 0 means
+// that the string ends before position d and c occupies bucket c + 1
+constexpr size_t STRING_SORT_BUCKETS = 257;
+
+template<typename String>
+size_t string_char(const String& s, size_t d) {
+  return d < parlay::size(s) ? static_cast<size_t>(static_cast<unsigned char>(std::begin(s)[d])) + 1 : 0;
+}
+
+// The length of the longest common prefix of a and b, given that
+// they have a common prefix of length at least d
+template<typename String1, typename String2>
+size_t string_lcp(const String1& a, const String2& b, size_t d = 0) {
+  size_t n = (std::min)(parlay::size(a), parlay::size(b));
+  auto ia = std::begin(a);
+  auto ib = std::begin(b);
+  while (d < n && static_cast<unsigned char>(ia[d]) == static_cast<unsigned char>(ib[d])) d++;
+  return d;
+}
+
+// Whether a < b, given that they have a common prefix of length at least d
+template<typename String1, typename String2>
+bool string_less(const String1& a, const String2& b, size_t d = 0) {
+  size_t l = string_lcp(a, b, d);
+  return string_char(a, l) < string_char(b, l);
+}
+
+// Characters d, ..., d + 6 of a string packed into the high bytes of a
+// 64-bit key, followed by the number of these that are in the string. The
+// keys of two strings compare in the same order as the strings truncated to
+// these characters, and strings with equal keys whose count is less than 7
+// are equal. Comparing keys compares seven characters at a time.
+constexpr size_t STRING_SORT_KEY_CHARS = 7;
+
+template<typename String>
+uint64_t string_key(const String& s, size_t d) {
+  size_t n = parlay::size(s);
+  size_t m = d < n ? (std::min)(n - d, STRING_SORT_KEY_CHARS) : 0;
+  // Shifting by the full 64 bits below would be undefined
+  if (m == 0) return 0;
+  uint64_t k = 0;
+  auto it = std::begin(s) + d;
+  for (size_t j = 0; j < m; j++) k = (k << 8) | static_cast<unsigned char>(it[j]);
+  return (k << (8 * (STRING_SORT_KEY_CHARS - m) + 8)) | m;
+}
+
+// Insertion sort of the strings A[0...n), all of which have a common
+// prefix of length d, and whose keys at position d are K[0...n)
+template<typename Ref>
+void string_insertion_sort(Ref* A, uint64_t* K, size_t n, size_t d) {
+  auto less = [&](const Ref& a, uint64_t ka, const Ref& b, uint64_t kb) {
+    if (ka != kb) return ka < kb;
+    return (ka & 0xff) == STRING_SORT_KEY_CHARS && string_less(a, b, d + STRING_SORT_KEY_CHARS);
+  };
+  for (size_t i = 1; i < n; i++) {
+    Ref x = A[i];
+    uint64_t kx = K[i];
+    size_t j = i;
+    while (j > 0 && less(x, kx, A[j - 1], K[j - 1])) {
+      A[j] = A[j - 1];
+      K[j] = K[j - 1];
+      j--;
+    }
+    A[j] = x;
+    K[j] = kx;
+  }
+}
+
+// Sequential multikey quicksort of the strings A[0...n), all of which
+// have a common prefix of length d, and whose keys at position d are
+// K[0...n). Partitions three ways on the key of a pivot, and moves on to
+// the next characters only for the strings whose keys are equal to the
+// pivot's, which are the only ones whose keys need to be recomputed. The
+// keys are cached in K so that partitioning does not touch the strings.
+template<typename Ref>
+void multikey_quicksort(Ref* A, uint64_t* K, size_t n, size_t d) {
+  while (n > STRING_SORT_INSERTION_THRESHOLD) {
+    uint64_t a = K[0], b = K[n / 2], c = K[n - 1];
+    uint64_t pivot = (std::max)((std::min)(a, b), (std::min)((std::max)(a, b), c));
+
+    // Partition into [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+    size_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+      if (K[i] < pivot) {
+        std::swap(A[lt], A[i]);
+        std::swap(K[lt++], K[i++]);
+      }
+      else if (K[i] > pivot) {
+        std::swap(A[i], A[--gt]);
+        std::swap(K[i], K[gt]);
+      }
+      else i++;
+    }
+    multikey_quicksort(A, K, lt, d);
+    multikey_quicksort(A + gt, K + gt, n - gt, d);
+
+    // Strings that end within the pivot's key are all equal
+    if ((pivot & 0xff) < STRING_SORT_KEY_CHARS) return;
+    A += lt;
+    K += lt;
+    n = gt - lt;
+    d += STRING_SORT_KEY_CHARS;
+    for (size_t j = 0; j < n; j++) K[j] = string_key(A[j], d);
+  }
+  string_insertion_sort(A, K, n, d);
+}
+
+template<typename Ref>
+void multikey_quicksort(Ref* A, size_t n, size_t d) {
+  auto K = sequence<uint64_t>::uninitialized(n);
+  for (size_t i = 0; i < n; i++) K[i] = string_key(A[i], d);
+  multikey_quicksort(A, K.begin(), n, d);
+}
+
+// Sorts the strings in A, all of which have a common prefix of length d, by
+// distributing them into buckets by character d and recursively sorting the
+// buckets in parallel. Tmp is scratch space of the same size.
+template<typename Ref>
+void string_radix_sort_r(slice<Ref*, Ref*> A, slice<Ref*, Ref*> Tmp, size_t d, float parallelism = 1.0) {
+  size_t n = A.size();
+  sequence<size_t> offsets;
+  bool one_bucket;
+  while (n >= STRING_SORT_RADIX_THRESHOLD) {
+    auto keys = sequence<uint16_t>::from_function(n, [&](size_t i) {
+      return static_cast<uint16_t>(string_char(A[i], d));
+    }, 1024);
+
+    std::tie(offsets, one_bucket) = count_sort<copy_assign_tag>(A, Tmp, make_slice(keys),
+                                                                STRING_SORT_BUCKETS, parallelism, true);
+
+    // If the strings all have the same character d, skip to the end of
+    // their longest common prefix, which may be much longer
+    if (one_bucket) {
+      if (keys[0] == 0) return;
+      auto lcps = delayed_seq<size_t>(n, [&](size_t i) { return string_lcp(A[0], A[i], d + 1); });
+      d = internal::reduce(make_slice(lcps), minimum<size_t>());
+      continue;
+    }
+    parallel_for(0, n, [&](size_t i) { A[i] = Tmp[i]; });
+
+    // Bucket 0 contains the strings that end before position d, which are equal
+    parallel_for(1, STRING_SORT_BUCKETS, [&](size_t b) {
+      size_t start = offsets[b], end = offsets[b + 1];
+      if (end - start > 1) {
+        auto new_parallelism = (parallelism * static_cast<float>(end - start)) / static_cast<float>(n + 1);
+        string_radix_sort_r(A.cut(start, end), Tmp.cut(start, end), d + 1, new_parallelism);
+      }
+    }, 1);
+    return;
+  }
+  multikey_quicksort(A.begin(), n, d);
+}
+
+// Returns references to the strings in S in sorted order
+template<typename Index, typename Iterator>
+auto sorted_string_refs(slice<Iterator, Iterator> S) {
+  using char_iterator = decltype(std::begin(S[0]));
+  using ref_type = string_ref<char_iterator, Index>;
+  size_t n = S.size();
+  auto A = sequence<ref_type>::from_function(n, [&](size_t i) {
+    return ref_type{std::begin(S[i]), static_cast<Index>(parlay::size(S[i])), static_cast<Index>(i)};
+  });
+  auto Tmp = sequence<ref_type>::uninitialized(n);
+  string_radix_sort_r(make_slice(A), make_slice(Tmp), 0);
+  return A;
+}
+
+// Calls f with references to the strings in S in sorted order, which
+// use 32-bit lengths and indices when there are few and short enough
+// strings. The references must refer to elements of S, so S must not
+// be a range whose elements are computed on demand.
+template<typename Iterator, typename F>
+auto with_sorted_string_refs(slice<Iterator, Iterator> S, F&& f) {
+  static_assert(std::is_lvalue_reference_v<typename std::iterator_traits<Iterator>::reference>);
+  size_t n = S.size();
+  auto lengths = delayed_seq<size_t>(n, [&](size_t i) { return parlay::size(S[i]); });
+  size_t max_length = internal::reduce(make_slice(lengths), maximum<size_t>());
+  if ((std::max)(n, max_length) < static_cast<size_t>((std::numeric_limits<uint32_t>::max)()))
+    return f(sorted_string_refs<uint32_t>(S));
+  return f(sorted_string_refs<size_t>(S));
+}
+
+// The longest common prefix of each string in the sorted sequence S
+// with the one before it, and 0 for the first string
+template<typename Strings>
+sequence<size_t> string_lcp_array(const Strings& S) {
+  return sequence<size_t>::from_function(S.size(), [&](size_t i) {
+    return i == 0 ? size_t{0} : string_lcp(S[i - 1], S[i]);
+  });
+}
+
+template<typename Iterator>
+void string_sort_inplace(slice<Iterator, Iterator> In) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  with_sorted_string_refs(In, [&](const auto& R) {
+    auto Tmp = sequence<value_type>::from_function(In.size(), [&](size_t i) {
+      return std::move(In[R[i].index]);
+    });
+    parallel_for(0, In.size(), [&](size_t i) { In[i] = std::move(Tmp[i]); });
+  });
+}
+
+template<typename Iterator>
+auto string_sort(slice<Iterator, Iterator> In) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  using reference = typename std::iterator_traits<Iterator>::reference;
+  if constexpr (std::is_lvalue_reference_v<reference>) {
+    return with_sorted_string_refs(In, [&](const auto& R) {
+      return sequence<value_type>::from_function(In.size(), [&](size_t i) { return In[R[i].index]; });
+    });
+  }
+  else {
+    // The strings are computed on demand, so they are first stored
+    auto Out = sequence<value_type>::from_function(In.size(), [&](size_t i) { return In[i]; });
+    string_sort_inplace(make_slice(Out));
+    return Out;
+  }
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_STRING_SORT_H_
@@ -12,6 +12,7 @@
 #include "../utilities.h"
 
 #include "sequence_ops.h"
+#include "streaming_store.h"
 
 namespace parlay {
 namespace internal {
@@ -118,15 +119,47 @@ struct transpose {
 // again, given in row-major order. You can think of the offsets as the prefix sum of
 // the chunk sizes.
 //
+// Whether runs of elements can be moved from In to Out with streaming
+// stores, i.e., both are contiguous and hold the same trivially copyable type
+template <typename InIterator, typename OutIterator>
+inline constexpr bool can_stream_runs_v =
+    is_contiguous_iterator_v<InIterator> && is_contiguous_iterator_v<OutIterator> &&
+    std::is_same_v<iterator_value_type_t<InIterator>, iterator_value_type_t<OutIterator>> &&
+    is_streamable_v<iterator_value_type_t<OutIterator>>;
+
+// Runs shorter than this many bytes are not worth writing with streaming
+// stores, since they would mostly write partial cache lines
+constexpr const size_t STREAMING_RUN_BYTES = 256;
+
+// Move the l elements starting at In[sa] to Out[sb]. If streaming is true,
+// long runs are written with streaming stores, and the caller must call
+// streaming_fence before the output is used.
+template <typename assignment_tag, typename InIterator, typename OutIterator>
+void move_run(InIterator In, OutIterator Out, size_t sa, size_t sb, size_t l, [[maybe_unused]] bool streaming) {
+  if constexpr (can_stream_runs_v<InIterator, OutIterator>) {
+    using T = iterator_value_type_t<OutIterator>;
+    if (streaming && l * sizeof(T) >= STREAMING_RUN_BYTES) {
+      streaming_memcpy_unfenced(voidify(Out[sb]), voidify(In[sa]), l * sizeof(T));
+      return;
+    }
+  }
+  for (size_t k = 0; k < l; k++) {
+    assign_dispatch(Out[k + sb], In[k + sa], assignment_tag());
+  }
+}
+
 template <typename assignment_tag, typename InIterator, typename OutIterator, typename CountIterator, typename DestIterator>
 struct blockTrans {
   InIterator In;
   OutIterator Out;
   CountIterator InOffset;
   DestIterator OutOffset;
+  bool streaming;
 
-  blockTrans(InIterator In_, OutIterator Out_, CountIterator InOffset_, DestIterator OutOffset_)
-      : In(std::move(In_)), Out(std::move(Out_)), InOffset(std::move(InOffset_)), OutOffset(std::move(OutOffset_)) {}
+  blockTrans(InIterator In_, OutIterator Out_, CountIterator InOffset_, DestIterator OutOffset_,
+             bool streaming_ = false)
+      : In(std::move(In_)), Out(std::move(Out_)), InOffset(std::move(InOffset_)), OutOffset(std::move(OutOffset_)),
+        streaming(streaming_) {}
 
   void transR(size_t rStart, size_t rCount, size_t rLength, size_t cStart,
               size_t cCount, size_t cLength) {
@@ -136,10 +169,9 @@ struct blockTrans {
           size_t sa = InOffset[i * rLength + j];
           size_t sb = OutOffset[j * cLength + i];
           size_t l = InOffset[i * rLength + j + 1] - sa;
-          for (size_t k = 0; k < l; k++) {
-            assign_dispatch(Out[k + sb], In[k + sa], assignment_tag());
-          }
+          move_run<assignment_tag>(In, Out, sa, sb, l, streaming);
         }
+        if (streaming) streaming_fence();
       });
     } else if (cCount > rCount) {
       size_t l1 = split(cCount);
@@ -184,6 +216,10 @@ sequence<size_t> transpose_buckets(InIterator From, OutIterator To,
   sequence<s_size_t> dest_offsets;
   auto add = plus<s_size_t>();
 
+  // Large outputs are written with streaming stores
+  using T = iterator_value_type_t<OutIterator>;
+  bool streaming = can_stream_runs_v<InIterator, OutIterator> && use_streaming_stores(n * sizeof(T));
+
   // for smaller input do non-cache oblivious version
   if (n < NON_CACHE_OBLIVIOUS_THRESHOLD || num_buckets <= 512 || num_blocks <= 512) {
     size_t block_bits = log2_up(num_blocks);
@@ -206,9 +242,10 @@ sequence<size_t> transpose_buckets(InIterator From, OutIterator To,
       for (size_t j = 0; j < num_buckets; j++) {
         size_t d_offset = dest_offsets[i + num_blocks * j];
         size_t len = counts[i * num_buckets + j];
-        for (size_t k = 0; k < len; k++)
-          assign_dispatch(To[d_offset++], From[s_offset++], assignment_tag());
+        move_run<assignment_tag>(From, To, s_offset, d_offset, len, streaming);
+        s_offset += len;
       }
+      if (streaming) streaming_fence();
     };
     parallel_for(0, num_blocks, f, 1);
   } else {  // for larger input do cache efficient transpose
@@ -226,7 +263,7 @@ sequence<size_t> transpose_buckets(InIterator From, OutIterator To,
     blockTrans<assignment_tag, InIterator, OutIterator,
                typename sequence<s_size_t>::iterator,
                typename sequence<s_size_t>::iterator>(
-      From, To, counts.begin(), dest_offsets.begin())
+      From, To, counts.begin(), dest_offsets.begin(), streaming)
         .trans(num_blocks, num_buckets);
   }
 
@@ -0,0 +1,61 @@
+
+#ifndef PARLAY_INTERNAL_VARINT_H_
+#define PARLAY_INTERNAL_VARINT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace parlay {
+namespace internal {
+
+// Variable-length byte encoding of unsigned integers (LEB128). Each byte
+// holds seven bits of the value, least significant first, and its high
+// bit is set if more bytes follow. Small values, such as the differences
+// between consecutive elements of a sorted sequence, take few bytes.
+
+// The number of bytes needed to encode x
+inline size_t varint_size(uint64_t x) {
+  size_t k = 1;
+  while (x >= 128) { x >>= 7; k++; }
+  return k;
+}
+
+// Writes the encoding of x to out, and returns a pointer past its end
+inline uint8_t* varint_encode(uint64_t x, uint8_t* out) {
+  while (x >= 128) {
+    *out++ = static_cast<uint8_t>(x | 128);
+    x >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(x);
+  return out;
+}
+
+// Reads an encoded value from in into x, and returns a pointer past its end
+inline const uint8_t* varint_decode(const uint8_t* in, uint64_t& x) {
+  uint64_t b = *in++;
+  if (b < 128) {   // Fast path for one-byte values, which are the common case
+    x = b;
+    return in;
+  }
+  x = b & 127;
+  for (int shift = 7; b >= 128; shift += 7) {
+    b = *in++;
+    x |= (b & 127) << shift;
+  }
+  return in;
+}
+
+// Maps signed integers to unsigned integers such that values close to zero,
+// positive or negative, map to small values: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+inline uint64_t zigzag_encode(int64_t x) {
+  return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t x) {
+  return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_VARINT_H_
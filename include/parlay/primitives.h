@@ -5,6 +5,8 @@
 #include <cassert>
 #include <cstddef>
 #include <cctype>
+#include <cmath>
+#include <cstdint>
 
 #include <algorithm>
 #include <atomic>
@@ -21,8 +23,15 @@
 #include "internal/heap_tree.h"           // IWYU pragma: keep
 #include "internal/merge.h"
 #include "internal/merge_sort.h"
+#include "internal/multiway_merge.h"
+#include "internal/partition.h"
+#include "internal/radix_key.h"
 #include "internal/sequence_ops.h"        // IWYU pragma: export
+#include "internal/segmented_ops.h"
 #include "internal/sample_sort.h"
+#include "internal/set_operations.h"
+#include "internal/streaming_store.h"
+#include "internal/string_sort.h"
 
 #include "delayed.h"
 #include "delayed_sequence.h"
@@ -79,6 +88,18 @@ void copy(R_in&& in, R_out&& out) {
   static_assert(is_random_access_range_v<R_out>);
   static_assert(std::is_assignable_v<range_reference_type_t<R_out>, range_reference_type_t<R_in>>);
   assert(parlay::size(out) >= parlay::size(in));
+
+  // Large contiguous copies bypass the cache with streaming stores
+  using T = range_value_type_t<R_in>;
+  if constexpr (is_contiguous_iterator_v<range_iterator_type_t<R_in>> &&
+                is_contiguous_iterator_v<range_iterator_type_t<R_out>> &&
+                std::is_same_v<range_value_type_t<R_out>, T> && internal::is_streamable_v<T>) {
+    if (internal::use_streaming_stores(parlay::size(in) * sizeof(T))) {
+      internal::streaming_copy_n(std::addressof(*std::begin(in)), parlay::size(in), std::addressof(*std::begin(out)));
+      return;
+    }
+  }
+
   parallel_for(0, parlay::size(in), [in_it = std::begin(in), out_it = std::begin(out)](size_t i) {
     out_it[i] = in_it[i];
   });
@@ -198,6 +219,67 @@ auto scan_inclusive_inplace(R&& r, LegacyMonoid m) {
   return parlay::scan_inclusive_inplace(std::forward<R>(r), legacy_monoid_adapter(std::move(m)));
 }
 
+/* ---------------- Segmented reduce and scan ---------------- */
+
+// The segments of r are given by a random access range s, which is either
+//  - a range of bools, where a segment starts at position 0 and at every
+//    position i such that s[i] is true, or
+//  - a range of k+1 integer offsets, where segment j is r[s[j], s[j+1]),
+//    s[0] == 0, and s[k] == size(r). Segments may be empty.
+// The work is balanced over the elements of r rather than over the
+// segments, so it is efficient even when the segment sizes are skewed.
+
+// Returns the reduction of each segment of r with the given monoid. With
+// offsets, empty segments reduce to the identity.
+template<typename R, typename S, typename Monoid,
+         std::enable_if_t<is_monoid_v<Monoid>, int> = 0>
+auto segmented_reduce(R&& r, S&& s, Monoid&& m) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<S>);
+  static_assert(is_monoid_for_v<Monoid, range_reference_type_t<R>>);
+  return internal::segmented_reduce(make_slice(r), make_slice(s), std::forward<Monoid>(m));
+}
+
+// Returns the sum of each segment of r
+template<typename R, typename S>
+auto segmented_reduce(R&& r, S&& s) {
+  static_assert(is_random_access_range_v<R>);
+  return parlay::segmented_reduce(r, s, parlay::plus<range_value_type_t<R>>());
+}
+
+// Returns the exclusive scan of each segment of r, i.e., each element is
+// replaced by the reduction of the elements before it in its segment
+template<typename R, typename S, typename Monoid,
+         std::enable_if_t<is_monoid_v<Monoid>, int> = 0>
+auto segmented_scan(R&& r, S&& s, Monoid&& m) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<S>);
+  static_assert(is_monoid_for_v<Monoid, range_reference_type_t<R>>);
+  return internal::segmented_scan(make_slice(r), make_slice(s), std::forward<Monoid>(m));
+}
+
+template<typename R, typename S>
+auto segmented_scan(R&& r, S&& s) {
+  static_assert(is_random_access_range_v<R>);
+  return parlay::segmented_scan(r, s, parlay::plus<range_value_type_t<R>>());
+}
+
+// Returns the inclusive scan of each segment of r
+template<typename R, typename S, typename Monoid,
+         std::enable_if_t<is_monoid_v<Monoid>, int> = 0>
+auto segmented_scan_inclusive(R&& r, S&& s, Monoid&& m) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<S>);
+  static_assert(is_monoid_for_v<Monoid, range_reference_type_t<R>>);
+  return internal::segmented_scan(make_slice(r), make_slice(s), std::forward<Monoid>(m), internal::fl_scan_inclusive);
+}
+
+template<typename R, typename S>
+auto segmented_scan_inclusive(R&& r, S&& s) {
+  static_assert(is_random_access_range_v<R>);
+  return parlay::segmented_scan_inclusive(r, s, parlay::plus<range_value_type_t<R>>());
+}
+
 /* ----------------------- Pack ----------------------- */
 
 template<typename R, typename BoolSeq>
@@ -285,11 +367,47 @@ auto filter_into_uninitialized(R_in&& in, R_out&& out, UnaryPred&& f) {
 
 /* ----------------------- Partition --------------------- */
 
-// TODO: Partition
+// Rearrange r in place so that the elements for which pred is true come
+// before those for which it is false, and return the number of the former.
+// The relative order of the elements within each part is not preserved.
+// No second buffer is used, only O(n / 4096) extra space.
+template<typename R, typename UnaryPred>
+size_t partition(R&& r, UnaryPred&& pred) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_r_v<bool, UnaryPred, range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  return internal::partition_inplace(make_slice(r), std::forward<UnaryPred>(pred));
+}
+
+// As partition, but preserves the relative order of the elements within
+// each part. Takes O(n log n) work rather than O(n).
+template<typename R, typename UnaryPred>
+size_t stable_partition(R&& r, UnaryPred&& pred) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_r_v<bool, UnaryPred, range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  return internal::stable_partition_inplace(make_slice(r), std::forward<UnaryPred>(pred));
+}
 
-// TODO: nth element
+// Rearrange r in place into the elements for which f is 0, then those for
+// which it is 1, then those for which it is 2, and return the ends of the
+// first two parts. The relative order within each part is not preserved.
+template<typename R, typename UnaryOp>
+std::pair<size_t, size_t> partition3(R&& r, UnaryOp&& f) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_r_v<int, UnaryOp, range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  return internal::partition3_inplace(make_slice(r), std::forward<UnaryOp>(f), false);
+}
 
-// TODO: partial sort? maybe
+// As partition3, but preserves the relative order within each part
+template<typename R, typename UnaryOp>
+std::pair<size_t, size_t> stable_partition3(R&& r, UnaryOp&& f) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_r_v<int, UnaryOp, range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  return internal::partition3_inplace(make_slice(r), std::forward<UnaryOp>(f), true);
+}
 
 /* ----------------------- Merging --------------------- */
 
@@ -312,15 +430,131 @@ auto merge(R1&& r1, R2&& r2) {
   return parlay::merge(r1, r2, std::less<>());
 }
 
+// Merge a range of k sorted ranges in a single pass over the data, and
+// return the merged sequence. The merge is stable, i.e., equal elements
+// are ordered by the range that they come from.
+template<typename R, typename BinaryPred>
+auto multiway_merge(R&& rs, BinaryPred&& pred) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<range_reference_type_t<R>>);
+  using inner_range = range_reference_type_t<R>;
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<inner_range>,
+                                                        range_reference_type_t<inner_range>>);
+  static_assert(std::is_constructible_v<range_value_type_t<inner_range>, range_reference_type_t<inner_range>>);
+  using slice_type = decltype(make_slice(std::declval<inner_range>()));
+  auto slices = sequence<slice_type>::from_function(parlay::size(rs), [&](size_t i) {
+    return make_slice(std::begin(rs)[i]);
+  });
+  return internal::multiway_merge(slices, std::forward<BinaryPred>(pred));
+}
+
+template<typename R>
+auto multiway_merge(R&& rs) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<range_reference_type_t<R>>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<range_reference_type_t<R>>>);
+  return parlay::multiway_merge(rs, std::less<>());
+}
+
+/* -------------------- Set Operations -------------------- */
+
+// Set operations on sorted ranges. As for std::set_union and friends, the
+// ranges may contain duplicates, and an element that occurs m times in r1
+// and n times in r2 occurs min(m, n) times in the intersection, max(m, n)
+// times in the union, and max(m - n, 0) times in the difference.
+
+// Return the elements of the sorted range r1 that are also in r2
+template<typename R1, typename R2, typename BinaryPred>
+auto set_intersection(R1&& r1, R2&& r2, BinaryPred&& pred) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R2>, range_reference_type_t<R1>>);
+  static_assert(std::is_constructible_v<range_value_type_t<R1>, range_reference_type_t<R1>>);
+  return internal::set_intersection(make_slice(r1), make_slice(r2), std::forward<BinaryPred>(pred));
+}
+
+template<typename R1, typename R2>
+auto set_intersection(R1&& r1, R2&& r2) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  return parlay::set_intersection(r1, r2, std::less<>());
+}
+
+// Return the number of elements of the sorted range r1 that are also in r2,
+// i.e., the size of their intersection, without computing the intersection
+template<typename R1, typename R2, typename BinaryPred>
+size_t set_intersection_size(R1&& r1, R2&& r2, BinaryPred&& pred) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R2>, range_reference_type_t<R1>>);
+  return internal::set_intersection_size(make_slice(r1), make_slice(r2), std::forward<BinaryPred>(pred));
+}
+
+template<typename R1, typename R2>
+size_t set_intersection_size(R1&& r1, R2&& r2) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  return parlay::set_intersection_size(r1, r2, std::less<>());
+}
+
+// Return the sorted elements of the union of the sorted ranges r1 and r2.
+// Elements that are in both are taken from r1.
+template<typename R1, typename R2, typename BinaryPred>
+auto set_union(R1&& r1, R2&& r2, BinaryPred&& pred) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(std::is_same_v<range_value_type_t<R1>, range_value_type_t<R2>>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R2>, range_reference_type_t<R1>>);
+  static_assert(std::is_constructible_v<range_value_type_t<R1>, range_reference_type_t<R1>>);
+  static_assert(std::is_constructible_v<range_value_type_t<R1>, range_reference_type_t<R2>>);
+  return internal::set_union(make_slice(r1), make_slice(r2), std::forward<BinaryPred>(pred));
+}
+
+template<typename R1, typename R2>
+auto set_union(R1&& r1, R2&& r2) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  return parlay::set_union(r1, r2, std::less<>());
+}
+
+// Return the elements of the sorted range r1 that are not in r2
+template<typename R1, typename R2, typename BinaryPred>
+auto set_difference(R1&& r1, R2&& r2, BinaryPred&& pred) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  static_assert(std::is_invocable_r_v<bool, BinaryPred, range_reference_type_t<R2>, range_reference_type_t<R1>>);
+  static_assert(std::is_constructible_v<range_value_type_t<R1>, range_reference_type_t<R1>>);
+  return internal::set_difference(make_slice(r1), make_slice(r2), std::forward<BinaryPred>(pred));
+}
+
+template<typename R1, typename R2>
+auto set_difference(R1&& r1, R2&& r2) {
+  static_assert(is_random_access_range_v<R1>);
+  static_assert(is_random_access_range_v<R2>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<R1>, range_reference_type_t<R2>>);
+  return parlay::set_difference(r1, r2, std::less<>());
+}
+
 /* -------------------- General Sorting -------------------- */
 
 // Sort the given sequence and return the sorted sequence
+//
+// Sequences of integers, floats, doubles, and pairs and tuples of these (see
+// has_radix_key_v) are sorted by radix sort rather than by comparisons when
+// they are sorted by the default comparison std::less.
 template<typename R>
 [[nodiscard]] auto sort(R&& in) {
   static_assert(is_random_access_range_v<R>);
   static_assert(is_less_than_comparable_v<range_reference_type_t<R>>);
   static_assert(std::is_constructible_v<range_value_type_t<R>, range_reference_type_t<R>>);
-  return internal::sample_sort(make_slice(in), std::less<>());
+  return sort(std::forward<R>(in), std::less<>());
 }
 
 // Sort the given sequence with respect to the given
@@ -331,6 +565,11 @@ template<typename R, typename Compare>
   static_assert(is_random_access_range_v<R>);
   static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<R>, range_reference_type_t<R>>);
   static_assert(std::is_constructible_v<range_value_type_t<R>, range_reference_type_t<R>>);
+  if constexpr (internal::is_radix_sortable_v<range_value_type_t<R>, Compare>) {
+    if (parlay::size(in) >= internal::PARLAY_RADIX_SORT_THRESHOLD) {
+      return internal::radix_sort(make_slice(in));
+    }
+  }
   return internal::sample_sort(make_slice(in), std::forward<Compare>(comp));
 }
 
@@ -350,11 +589,17 @@ template<typename R, typename Compare>
   return internal::sample_sort(make_slice(in), std::forward<Compare>(comp), true);
 }
 
-template<typename R, typename Compare>
+template<typename R, typename Compare, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Compare>, sort_mode>>>
 void sort_inplace(R&& in, Compare&& comp) {
   static_assert(is_random_access_range_v<R>);
   static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<R>, range_reference_type_t<R>>);
   static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  if constexpr (internal::is_radix_sortable_v<range_value_type_t<R>, Compare>) {
+    if (parlay::size(in) >= internal::PARLAY_RADIX_SORT_THRESHOLD) {
+      internal::radix_sort_inplace(make_slice(in));
+      return;
+    }
+  }
   internal::sample_sort_inplace(make_slice(in), std::forward<Compare>(comp));
 }
 
@@ -366,6 +611,32 @@ void sort_inplace(R&& in) {
   sort_inplace(std::forward<R>(in), std::less<>{});
 }
 
+// With sort_mode::low_memory, the elements are distributed into buckets in
+// place rather than through a temporary copy of the input. This requires the
+// elements to be copyable; otherwise the standard algorithm is used. Elements
+// that are sorted by radix sort use the in-place radix sort in this mode.
+template<typename R, typename Compare>
+void sort_inplace(R&& in, Compare&& comp, sort_mode mode) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<R>, range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  if constexpr (internal::is_radix_sortable_v<range_value_type_t<R>, Compare>) {
+    if (parlay::size(in) >= internal::PARLAY_RADIX_SORT_THRESHOLD) {
+      internal::radix_sort_inplace(make_slice(in), mode);
+      return;
+    }
+  }
+  internal::sample_sort_inplace(make_slice(in), std::forward<Compare>(comp), mode);
+}
+
+template<typename R>
+void sort_inplace(R&& in, sort_mode mode) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_less_than_comparable_v<range_reference_type_t<R>>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  sort_inplace(std::forward<R>(in), std::less<>{}, mode);
+}
+
 template<typename R, typename Compare>
 void stable_sort_inplace(R&& in, Compare&& comp) {
   static_assert(is_random_access_range_v<R>);
@@ -411,7 +682,7 @@ void integer_sort_inplace(R&& in) {
   internal::integer_sort_inplace(make_slice(in), [](auto x) { return x; });
 }
 
-template<typename R, typename Key>
+template<typename R, typename Key, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Key>, sort_mode>>>
 void integer_sort_inplace(R&& in, Key&& key) {
   static_assert(is_random_access_range_v<R>);
   static_assert(std::is_invocable_v<Key, range_reference_type_t<R>>);
@@ -422,6 +693,27 @@ void integer_sort_inplace(R&& in, Key&& key) {
   internal::integer_sort_inplace(make_slice(in), std::forward<Key>(key));
 }
 
+// With sort_mode::low_memory, the sort is not stable, but permutes
+// the input in place rather than through a temporary copy of it
+template<typename R>
+void integer_sort_inplace(R&& in, sort_mode mode) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_integral_v<range_value_type_t<R>>);
+  static_assert(std::is_unsigned_v<range_value_type_t<R>>);
+  internal::integer_sort_inplace(make_slice(in), [](auto x) { return x; }, 0, mode);
+}
+
+template<typename R, typename Key>
+void integer_sort_inplace(R&& in, Key&& key, sort_mode mode) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(std::is_invocable_v<Key, range_reference_type_t<R>>);
+  using key_type = std::invoke_result_t<Key, range_reference_type_t<R>>;
+  static_assert(std::is_integral_v<key_type>);
+  static_assert(std::is_unsigned_v<key_type>);
+  static_assert(std::is_swappable_v<range_reference_type_t<R>>);
+  internal::integer_sort_inplace(make_slice(in), std::forward<Key>(key), 0, mode);
+}
+
 template<typename R, typename Key>
 [[nodiscard]] auto stable_integer_sort(R&& in, Key&& key) {
   static_assert(is_random_access_range_v<R>);
@@ -444,6 +736,45 @@ void stable_integer_sort_inplace(R&& in, Key&& key) {
   internal::integer_sort_inplace(make_slice(in), std::forward<Key>(key));
 }
 
+/* -------------------- String Sorting -------------------- */
+
+// Sort a sequence of strings, i.e., of random-access ranges of one-byte
+// characters such as std::string or sequence<char>, and return the sorted
+// sequence. The strings are sorted by a parallel radix sort on their
+// characters, so common prefixes are not compared repeatedly. Characters
+// are compared as unsigned bytes, which is the order of std::string.
+template<typename R>
+[[nodiscard]] auto string_sort(R&& in) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<range_reference_type_t<R>>);
+  static_assert(sizeof(range_value_type_t<range_reference_type_t<R>>) == 1);
+  static_assert(std::is_constructible_v<range_value_type_t<R>, range_reference_type_t<R>>);
+  return internal::string_sort(make_slice(in));
+}
+
+// Sort a sequence of strings as above, and also return their LCP array,
+// whose ith element is the length of the longest common prefix of the ith
+// sorted string and the one before it (or zero, for the first string)
+template<typename R>
+[[nodiscard]] auto string_sort_with_lcp(R&& in) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<range_reference_type_t<R>>);
+  static_assert(sizeof(range_value_type_t<range_reference_type_t<R>>) == 1);
+  static_assert(std::is_constructible_v<range_value_type_t<R>, range_reference_type_t<R>>);
+  auto sorted = internal::string_sort(make_slice(in));
+  auto lcp = internal::string_lcp_array(make_slice(sorted));
+  return std::make_pair(std::move(sorted), std::move(lcp));
+}
+
+template<typename R>
+void string_sort_inplace(R&& in) {
+  static_assert(is_random_access_range_v<R>);
+  static_assert(is_random_access_range_v<range_reference_type_t<R>>);
+  static_assert(sizeof(range_value_type_t<range_reference_type_t<R>>) == 1);
+  static_assert(std::is_move_assignable_v<range_value_type_t<R>>);
+  internal::string_sort_inplace(make_slice(in));
+}
+
 /* -------------------- Counting Sort -------------------- */
 
 template<typename Range>
@@ -1310,6 +1641,177 @@ auto kth_smallest(Range&& in, size_t k, Compare&& less = {}) {
   });
 }
 
+/* -------------------- Partial sorting and selection -------------------- */
+
+// top_k, partial_sort and multi_select find the elements of given ranks
+// without sorting the whole input. Each sorts a random sample of the input,
+// takes elements of the sample as pivots, makes one pass over the input to
+// split it by the pivots, and then sorts only the elements that lie between
+// the pivots that bracket the ranks that are asked for.
+
+namespace internal {
+
+// the following parameter can be tuned
+constexpr size_t SELECTION_SAMPLE_SIZE = 1 << 16;
+
+// A sorted random sample, with replacement, of sample_size elements of r
+template<typename Range, typename Compare>
+auto sorted_sample(Range&& r, size_t sample_size, Compare&& less) {
+  size_t n = parlay::size(r);
+  auto it = std::begin(r);
+  parlay::random_generator gen;
+  std::uniform_int_distribution<size_t> dis(0, n-1);
+  return parlay::sort(parlay::tabulate(sample_size, [&] (size_t i) -> range_value_type_t<Range> {
+    auto g = gen[i];
+    return it[dis(g)];
+  }), less);
+}
+
+// The rank in a sorted sample of size s from n elements of the first
+// pivot to try for selecting the k smallest. It is a few standard
+// deviations above the expected rank of the k'th smallest, so that it
+// is rarely too small.
+inline size_t initial_pivot_rank(size_t n, size_t k, size_t s) {
+  double expected = static_cast<double>(k) * static_cast<double>(s) / static_cast<double>(n);
+  return (std::min)(s - 1, static_cast<size_t>(expected + 3 * std::sqrt(expected) + 2));
+}
+
+}  // namespace internal
+
+// Return the k smallest elements of r as a sorted sequence, where equal
+// elements are in the order of the input, i.e., the first k elements of
+// stable_sort(r, less). Use std::greater to get the k largest.
+template <typename Range, typename Compare = std::less<>>
+auto top_k(Range&& r, size_t k, Compare&& less = {}) {
+  static_assert(is_random_access_range_v<Range>);
+  static_assert(std::is_constructible_v<range_value_type_t<Range>, range_reference_type_t<Range>>);
+  static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<Range>, range_reference_type_t<Range>>);
+  using T = range_value_type_t<Range>;
+
+  size_t n = parlay::size(r);
+  k = (std::min)(k, n);
+  if (n > internal::SELECTION_SAMPLE_SIZE && k <= n / 16) {
+    auto sample = internal::sorted_sample(r, internal::SELECTION_SAMPLE_SIZE, less);
+    size_t s = sample.size();
+
+    // Keep the elements that are at most the pivot, and retry with a larger
+    // pivot in the unlikely case that there are fewer than k of them
+    for (size_t rank = internal::initial_pivot_rank(n, k, s); ; rank = (std::min)(s - 1, 2 * rank + 1)) {
+      const T& pivot = sample[rank];
+      auto le = parlay::filter(r, [&] (auto&& x) { return !less(pivot, x); });
+      if (le.size() >= k) {
+        // Only those less than the pivot need sorting, since there
+        // may be very many elements that are equal to it
+        auto lt = parlay::stable_sort(parlay::filter(le, [&] (auto&& x) { return less(x, pivot); }), less);
+        if (lt.size() >= k) return parlay::to_sequence(lt.cut(0, k));
+        auto eq = parlay::filter(le, [&] (auto&& x) { return !less(x, pivot); });
+        return parlay::tabulate(k, [&] (size_t i) -> T {
+          return i < lt.size() ? lt[i] : eq[i - lt.size()]; });
+      }
+      if (rank == s - 1) break;
+    }
+  }
+  auto sorted = parlay::stable_sort(r, less);
+  return parlay::to_sequence(sorted.cut(0, k));
+}
+
+// Rearrange r so that its first k elements are the k smallest in sorted
+// order, as std::partial_sort does. The order of the others is unspecified.
+template <typename Range, typename Compare = std::less<>>
+void partial_sort(Range&& r, size_t k, Compare&& less = {}) {
+  static_assert(is_random_access_range_v<Range>);
+  static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<Range>, range_reference_type_t<Range>>);
+  using T = range_value_type_t<Range>;
+
+  size_t n = parlay::size(r);
+  k = (std::min)(k, n);
+  if (n > internal::SELECTION_SAMPLE_SIZE && k <= n / 16) {
+    auto sample = internal::sorted_sample(r, internal::SELECTION_SAMPLE_SIZE, less);
+    size_t s = sample.size();
+    auto A = make_slice(r);
+
+    // Move the elements that are at most the pivot to the front, and then
+    // those that are less than it to the front of those, and sort them
+    for (size_t rank = internal::initial_pivot_rank(n, k, s); ; rank = (std::min)(s - 1, 2 * rank + 1)) {
+      const T& pivot = sample[rank];
+      size_t m = internal::partition_inplace(A, [&] (auto&& x) { return !less(pivot, x); });
+      if (m >= k) {
+        size_t l = internal::partition_inplace(A.cut(0, m), [&] (auto&& x) { return less(x, pivot); });
+        parlay::sort_inplace(A.cut(0, l), less);
+        return;
+      }
+      if (rank == s - 1) break;
+    }
+  }
+  parlay::sort_inplace(r, less);
+}
+
+// Return the elements of the given ranks in r, i.e., the sequence
+// whose i'th element is the element of rank ranks[i] in sorted order
+template <typename Range, typename RankRange, typename Compare = std::less<>>
+auto multi_select(Range&& r, RankRange&& ranks, Compare&& less = {}) {
+  static_assert(is_random_access_range_v<Range>);
+  static_assert(is_random_access_range_v<RankRange>);
+  static_assert(std::is_convertible_v<range_reference_type_t<RankRange>, size_t>);
+  static_assert(std::is_constructible_v<range_value_type_t<Range>, range_reference_type_t<Range>>);
+  static_assert(std::is_invocable_r_v<bool, Compare, range_reference_type_t<Range>, range_reference_type_t<Range>>);
+  using T = range_value_type_t<Range>;
+
+  size_t n = parlay::size(r);
+  size_t m = parlay::size(ranks);
+  auto rank = [&] (size_t i) -> size_t {
+    size_t k = std::begin(ranks)[i];
+    assert(k < n);
+    return k;
+  };
+
+  // With p pivots, the buckets that hold the ranks have about m n / p
+  // elements, so p is chosen to be about 64 m, up to a limit that keeps
+  // the bucket ids in 16 bits. More pivots make splitting more expensive.
+  constexpr size_t over = 8;
+  size_t num_pivots = (size_t{1} << log2_up(64 * m + 1)) - 1;
+  if (m == 0 || num_pivots > (size_t{1} << 15) - 1 || num_pivots * over > n / 4) {
+    auto sorted = parlay::sort(r, less);
+    return parlay::tabulate(m, [&] (size_t i) -> T { return sorted[rank(i)]; });
+  }
+  auto sample = internal::sorted_sample(r, num_pivots * over, less);
+  auto pivots = parlay::tabulate(num_pivots, [&] (size_t i) -> T { return sample[i * over + over / 2]; });
+
+  // Bucket 2j holds the elements between pivots j-1 and j, and bucket
+  // 2j+1 holds those equal to pivot j, which need no sorting. The pivots
+  // are searched with a heap_tree, as in sample sort, which may place an
+  // element that is equal to pivot j just after it.
+  auto it = std::begin(r);
+  internal::heap_tree<T> ss(pivots);
+  auto ids = parlay::tabulate(n, [&] (size_t i) -> uint16_t {
+    const T& x = it[i];
+    size_t j = ss.rank(x, less);
+    if (j > 0 && !less(pivots[j - 1], x)) return static_cast<uint16_t>(2 * j - 1);
+    return static_cast<uint16_t>(2 * j + (j < num_pivots && !less(x, pivots[j])));
+  });
+  size_t num_buckets = 2 * num_pivots + 1;
+  auto offsets = parlay::histogram_by_index(ids, num_buckets);
+  parlay::scan_inplace(offsets);
+
+  // Gather the elements of the buckets that hold a rank and sort them,
+  // which leaves the buckets in order since they are ranges of values
+  auto buckets = parlay::tabulate(m, [&] (size_t i) -> size_t {
+    return std::upper_bound(offsets.begin(), offsets.end(), rank(i)) - offsets.begin() - 1; });
+  auto wanted = parlay::remove_duplicates_ordered(parlay::filter(buckets, [] (size_t b) { return b % 2 == 0; }));
+  auto is_wanted = parlay::sequence<bool>(num_buckets, false);
+  parallel_for(0, wanted.size(), [&] (size_t i) { is_wanted[wanted[i]] = true; });
+  auto gathered = parlay::pack(r, parlay::delayed_map(ids, [&] (uint16_t b) -> bool { return is_wanted[b]; }));
+  parlay::sort_inplace(gathered, less);
+  auto gathered_offsets = parlay::scan(parlay::delayed_tabulate(num_buckets, [&] (size_t b) -> size_t {
+    return is_wanted[b] ? (b + 1 < num_buckets ? offsets[b + 1] : n) - offsets[b] : 0; })).first;
+
+  return parlay::tabulate(m, [&] (size_t i) -> T {
+    size_t b = buckets[i];
+    if (b % 2 == 1) return pivots[b / 2];
+    return gathered[gathered_offsets[b] + rank(i) - offsets[b]];
+  });
+}
+
 }  // namespace parlay
 
 #endif  // PARLAY_PRIMITIVES_H_
@@ -16,6 +16,7 @@
 #include "utilities.h"         // IWYU pragma: keep
 
 #include "internal/debug_uninitialized.h"
+#include "internal/streaming_store.h"
 
 namespace parlay {
 
@@ -96,16 +97,23 @@ inline std::pair<InputIterator, NoThrowForwardIterator> uninitialized_relocate_n
   if constexpr (contiguous && trivially_relocatable) {
     constexpr size_t chunk_size = 1024 * sizeof(size_t) / sizeof(T);
     const size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+    // Large relocations bypass the cache with streaming stores
+    const bool streaming = internal::is_streamable_v<T> && internal::use_streaming_stores(n * sizeof(T));
     parallel_for(0, n_chunks, [&](size_t i) {
       size_t n_objects = (std::min)(chunk_size, n - i * chunk_size);
-#if defined(__cpp_lib_trivially_relocatable)
-      std::uninitialized_relocate_n(first + i * chunk_size, n_objects, result + i * chunk_size);
-#else
       size_t n_bytes = sizeof(T) * n_objects;
       void* src = voidify(*(first + i * chunk_size));
       void* dest = voidify(*(result + i * chunk_size));
-      std::memcpy(dest, src, n_bytes);
+      if (streaming) {
+        internal::streaming_memcpy(dest, src, n_bytes);
+      }
+      else {
+#if defined(__cpp_lib_trivially_relocatable)
+        std::uninitialized_relocate_n(first + i * chunk_size, n_objects, result + i * chunk_size);
+#else
+        std::memcpy(dest, src, n_bytes);
 #endif
+      }
     }, 1);
     return {first + n, result + n};
   }
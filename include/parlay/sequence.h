@@ -102,6 +102,8 @@ class PARLAY_TRIVIALLY_RELOCATABLE sequence : protected sequence_internal::seque
   using sequence_base_type::_max_size;
   using sequence_base_type::copy_granularity;
   using sequence_base_type::initialization_granularity;
+  using sequence_base_type::zero_bytes_initializable;
+  using sequence_base_type::is_zero_bytes;
 
   // creates an empty sequence
   sequence() : sequence_base_type() {}
@@ -373,6 +375,16 @@ class PARLAY_TRIVIALLY_RELOCATABLE sequence : protected sequence_internal::seque
         parallel_for(new_size, current, [&](size_t i) { storage.destroy(&buffer[i]); });
       }
     } else {
+      // Growing an empty sequence to a large size with zeros can use fresh zeroed pages
+      if constexpr (zero_bytes_initializable) {
+        if (current == 0 && new_size > storage.capacity() && is_zero_bytes(v)) {
+          storage.clear();
+          if (storage.try_initialize_capacity_zeroed(new_size)) {
+            storage.set_size(new_size);
+            return;
+          }
+        }
+      }
       storage.ensure_capacity(new_size);
       assert(storage.capacity() >= new_size);
       auto buffer = storage.data();
@@ -544,6 +556,13 @@ class PARLAY_TRIVIALLY_RELOCATABLE sequence : protected sequence_internal::seque
   // Implement initialize_default manually rather than calling initialize_fill(n, value_type()) because
   // this allows us to store a sequence of uncopyable types provided that no reallocation ever happens.
   void initialize_default(size_t n) {
+    // Large buffers of zeros can be obtained from the OS without touching them
+    if constexpr (zero_bytes_initializable) {
+      if (storage.try_initialize_capacity_zeroed(n)) {
+        storage.set_size(n);
+        return;
+      }
+    }
     storage.initialize_capacity(n);
     auto buffer = storage.data();
     parallel_for(0, n, [&](size_t i) {      // Calling initialize with
@@ -553,6 +572,12 @@ class PARLAY_TRIVIALLY_RELOCATABLE sequence : protected sequence_internal::seque
   }
 
   void initialize_fill(size_t n, const value_type& v) {
+    if constexpr (zero_bytes_initializable) {
+      if (is_zero_bytes(v) && storage.try_initialize_capacity_zeroed(n)) {
+        storage.set_size(n);
+        return;
+      }
+    }
     storage.initialize_capacity(n);
     auto buffer = storage.data();
     parallel_for(0, n, [&](size_t i) {
@@ -0,0 +1,280 @@
+// A structure-of-arrays sequence stores a sequence of tuples as one
+// contiguous column per field, rather than as one contiguous array of
+// tuples. Kernels that only touch some of the fields, e.g., a reduce
+// over the weights of a set of edges, then only read the memory of the
+// columns that they access, rather than the memory of every field.
+//
+// The columns can be accessed directly with column<I>(), which returns
+// a parlay::sequence that can be passed to any primitive. The sequence
+// as a whole is also a random access range whose reference type is a
+// tuple of references to the fields of an element, so it can be passed
+// to primitives such as map, reduce, or for_each. Since the tuple only
+// holds references, only the fields that are actually used are read.
+//
+// Example:
+//
+//   parlay::soa_sequence<int, double> edges(targets, weights);
+//   double total = parlay::reduce(edges.column<1>());
+//   edges.sort_by<0>();      // sort by target, permuting the weights too
+//   auto [v, w] = edges[0];  // references to the first target and weight
+//
+
+#ifndef PARLAY_SOA_SEQUENCE_H_
+#define PARLAY_SOA_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.h"
+#include "primitives.h"
+#include "range.h"
+#include "sequence.h"
+#include "type_traits.h"
+#include "utilities.h"
+
+namespace parlay {
+
+template<typename... Ts>
+class soa_sequence {
+  static_assert(sizeof...(Ts) >= 1, "soa_sequence must have at least one column");
+
+  using columns_type = std::tuple<sequence<Ts>...>;
+  using index_sequence_type = std::index_sequence_for<Ts...>;
+
+ public:
+  using value_type = std::tuple<Ts...>;
+  using reference = std::tuple<Ts&...>;
+  using const_reference = std::tuple<const Ts&...>;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  template<size_t I>
+  using column_value_type = std::tuple_element_t<I, value_type>;
+
+  // An iterator is a tuple of pointers, one into each column, which are
+  // advanced together. Dereferencing it gives a tuple of references.
+  template<bool Const>
+  class iterator_t {
+    friend class soa_sequence<Ts...>;
+    friend class iterator_t<true>;
+
+    using pointers_type = std::tuple<std::add_pointer_t<maybe_const_t<Const, Ts>>...>;
+
+    explicit iterator_t(pointers_type ptrs_) : ptrs(ptrs_) { }
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<std::add_lvalue_reference_t<maybe_const_t<Const, Ts>>...>;
+    using pointer = void;
+
+    iterator_t() : ptrs{} { }
+
+    /* implicit */ iterator_t(const iterator_t<false>& other) : ptrs(other.ptrs) { }  // cppcheck-suppress noExplicitConstructor    // NOLINT
+
+    reference operator*() const {
+      return std::apply([](auto... p) { return reference{*p...}; }, ptrs);
+    }
+
+    reference operator[](difference_type i) const {
+      return std::apply([i](auto... p) { return reference{p[i]...}; }, ptrs);
+    }
+
+    iterator_t& operator+=(difference_type diff) {
+      std::apply([diff](auto&... p) { ((p += diff), ...); }, ptrs);
+      return *this;
+    }
+
+    iterator_t& operator-=(difference_type diff) { return *this += (-diff); }
+    iterator_t& operator++() { return *this += 1; }
+    iterator_t& operator--() { return *this -= 1; }
+    iterator_t operator++(int) { auto tmp = *this; ++(*this); return tmp; }   //NOLINT
+    iterator_t operator--(int) { auto tmp = *this; --(*this); return tmp; }   //NOLINT
+
+    iterator_t operator+(difference_type diff) const { auto result = *this; result += diff; return result; }
+    iterator_t operator-(difference_type diff) const { auto result = *this; result -= diff; return result; }
+    friend iterator_t operator+(difference_type diff, const iterator_t& it) { return it + diff; }
+
+    // All of the pointers move in lockstep, so it suffices to compare the first
+    difference_type operator-(const iterator_t& other) const { return first() - other.first(); }
+
+    bool operator==(const iterator_t& other) const { return first() == other.first(); }
+    bool operator!=(const iterator_t& other) const { return first() != other.first(); }
+    bool operator<(const iterator_t& other) const { return first() < other.first(); }
+    bool operator<=(const iterator_t& other) const { return first() <= other.first(); }
+    bool operator>(const iterator_t& other) const { return first() > other.first(); }
+    bool operator>=(const iterator_t& other) const { return first() >= other.first(); }
+
+   private:
+    auto first() const { return std::get<0>(ptrs); }
+
+    pointers_type ptrs;
+  };
+
+  using iterator = iterator_t<false>;
+  using const_iterator = iterator_t<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static_assert(is_random_access_iterator_v<iterator>);
+  static_assert(is_random_access_iterator_v<const_iterator>);
+
+  // ------------------------- Constructors -------------------------------
+
+  soa_sequence() = default;
+
+  // Create a sequence of n value-initialized elements
+  explicit soa_sequence(size_t n) : columns(sequence<Ts>(n)...) { }
+
+  // Create a sequence of n copies of the given value
+  soa_sequence(size_t n, const value_type& v)
+      : soa_sequence(n, v, index_sequence_type{}) { }
+
+  // Create a sequence from the given columns, which must have the same size
+  explicit soa_sequence(sequence<Ts>... columns_) : columns(std::move(columns_)...) {
+    assert(std::apply([n = size()](const auto&... c) { return ((c.size() == n) && ...); }, columns));
+  }
+
+  // Create a sequence by splitting each tuple-like element of the given
+  // range (e.g., a std::tuple or std::pair) into its fields
+  template<typename R>
+  static soa_sequence from_tuples(R&& r) {
+    static_assert(is_random_access_range_v<R>);
+    return from_tuples_impl(std::forward<R>(r), index_sequence_type{});
+  }
+
+  // Gather the fields of each element back into a sequence of tuples
+  [[nodiscard]] sequence<value_type> to_tuples() const {
+    return parlay::tabulate(size(), [this](size_t i) -> value_type { return value_type((*this)[i]); });
+  }
+
+  // --------------------------- Accessors --------------------------------
+
+  [[nodiscard]] size_t size() const { return std::get<0>(columns).size(); }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  template<size_t I>
+  sequence<column_value_type<I>>& column() { return std::get<I>(columns); }
+
+  template<size_t I>
+  const sequence<column_value_type<I>>& column() const { return std::get<I>(columns); }
+
+  reference operator[](size_t i) {
+    assert(i < size());
+    return std::apply([i](auto&... c) { return reference{c[i]...}; }, columns);
+  }
+
+  const_reference operator[](size_t i) const {
+    assert(i < size());
+    return std::apply([i](const auto&... c) { return const_reference{c[i]...}; }, columns);
+  }
+
+  iterator begin() { return iterator(std::apply([](auto&... c) { return std::make_tuple(c.data()...); }, columns)); }
+  iterator end() { return begin() + static_cast<difference_type>(size()); }
+  const_iterator begin() const {
+    return const_iterator(std::apply([](const auto&... c) { return std::make_tuple(c.data()...); }, columns));
+  }
+  const_iterator end() const { return begin() + static_cast<difference_type>(size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  // --------------------------- Modifiers --------------------------------
+
+  void push_back(const value_type& v) { push_back_impl(v, index_sequence_type{}); }
+
+  void reserve(size_t n) { std::apply([n](auto&... c) { (c.reserve(n), ...); }, columns); }
+
+  void resize(size_t n) { std::apply([n](auto&... c) { (c.resize(n), ...); }, columns); }
+
+  void clear() { std::apply([](auto&... c) { (c.clear(), ...); }, columns); }
+
+  // Rearrange the elements so that the i'th element becomes the element
+  // that was previously at position idx[i]. Each column is gathered
+  // independently, in parallel.
+  template<typename R>
+  void permute(const R& idx) {
+    static_assert(is_random_access_range_v<R>);
+    // The size is read once, since the columns are replaced concurrently
+    size_t n = size();
+    assert(parlay::size(idx) == n);
+    auto it = std::begin(idx);
+    std::apply([&](auto&... c) {
+      par_do_all([&] { c = parlay::tabulate(n, [&](size_t i) { return c[it[i]]; }); }...);
+    }, columns);
+  }
+
+  // Stably sort the elements by the values of their I'th field, permuting
+  // the other fields accordingly. Only the I'th column is read during the
+  // sort itself, and the other columns are gathered once at the end.
+  template<size_t I, typename Compare = std::less<>>
+  void sort_by(Compare comp = {}) {
+    using key_type = column_value_type<I>;
+    auto& keys = std::get<I>(columns);
+    auto pairs = parlay::tabulate(size(), [&](size_t i) { return std::make_pair(std::move(keys[i]), i); });
+
+    // Breaking ties by position makes the (faster) unstable sort stable
+    parlay::sort_inplace(pairs, [&](const auto& a, const auto& b) {
+      return comp(a.first, b.first) || (!comp(b.first, a.first) && a.second < b.second);
+    });
+    keys = parlay::map(pairs, [](auto& p) -> key_type { return std::move(p.first); });
+    gather_except<I>(parlay::delayed_map(pairs, [](const auto& p) { return p.second; }), index_sequence_type{});
+  }
+
+ private:
+  template<size_t... Is>
+  soa_sequence(size_t n, const value_type& v, std::index_sequence<Is...>)
+      : columns(sequence<Ts>(n, std::get<Is>(v))...) { }
+
+  template<typename R, size_t... Is>
+  static soa_sequence from_tuples_impl(R&& r, std::index_sequence<Is...>) {
+    auto it = std::begin(r);
+    size_t n = parlay::size(r);
+    return soa_sequence(parlay::tabulate(n, [&](size_t i) -> Ts { return std::get<Is>(it[i]); })...);
+  }
+
+  template<size_t... Is>
+  void push_back_impl(const value_type& v, std::index_sequence<Is...>) {
+    (std::get<Is>(columns).push_back(std::get<Is>(v)), ...);
+  }
+
+  template<size_t I, typename R, size_t... Is>
+  void gather_except(const R& idx, std::index_sequence<Is...>) {
+    size_t n = size();
+    par_do_all([&] {
+      if constexpr (Is != I) {
+        auto& c = std::get<Is>(columns);
+        c = parlay::tabulate(n, [&](size_t i) { return std::move(c[idx[i]]); });
+      }
+    }...);
+  }
+
+  // Run the given functions in parallel
+  template<typename F, typename... Fs>
+  static void par_do_all(F&& f, Fs&&... fs) {
+    if constexpr (sizeof...(Fs) == 0) {
+      f();
+    }
+    else {
+      par_do([&] { f(); }, [&] { par_do_all(std::forward<Fs>(fs)...); });
+    }
+  }
+
+  columns_type columns;
+};
+
+}  // namespace parlay
+
+#endif  // PARLAY_SOA_SEQUENCE_H_
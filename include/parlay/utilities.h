@@ -278,6 +278,28 @@ size_t log2_up(T i) {
   return a;
 }
 
+// returns the number of bits that are set in a 64-bit word
+inline size_t popcount(uint64_t x) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_popcountll(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<size_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// returns the index of the lowest set bit of a nonzero 64-bit word
+inline size_t count_trailing_zeros(uint64_t x) {
+  assert(x != 0);
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctzll(x));
+#else
+  return popcount((x & (~x + 1)) - 1);
+#endif
+}
+
 
 inline size_t granularity(size_t n) {
   return (n > 100) ? static_cast<size_t>(std::ceil(std::sqrt(n))) : 100;
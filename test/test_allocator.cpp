@@ -1,9 +1,12 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 #include <vector>
 
 #include <parlay/alloc.h>
+#include <parlay/parallel.h>
 #include <parlay/random.h>
 
 
@@ -150,6 +153,42 @@ TEST(TestAllocator, TestAlignedPMallocAndPFree) {
   }
 }
 
+// Checks that the medium and large size classes are finer than powers of two
+TEST(TestAllocator, TestDefaultAllocatorSizeClasses) {
+  auto sizes = parlay::internal::default_allocator_sizes();
+  ASSERT_FALSE(sizes.empty());
+  ASSERT_EQ(sizes.front(), 16);
+  ASSERT_TRUE(std::is_sorted(sizes.begin(), sizes.end()));
+  for (size_t i = 1; i < sizes.size(); i++) {
+    ASSERT_LT(sizes[i - 1], sizes[i]);
+    if (sizes[i] <= parlay::internal::default_allocator_min_fine_size) {
+      ASSERT_EQ(sizes[i], 2 * sizes[i - 1]);
+    }
+    else {
+      ASSERT_LE(sizes[i] - sizes[i - 1], sizes[i] / parlay::internal::default_allocator_classes_per_doubling);
+      ASSERT_EQ(sizes[i] % parlay::internal::pool_allocator::max_alignment, 0);
+    }
+  }
+}
+
+// Allocate blocks of sizes that fall between the medium size classes
+TEST(TestAllocator, TestParlayAllocatorMediumSizes) {
+  parlay::allocator<char> alloc;
+  std::vector<std::pair<char*, size_t>> blocks;
+  for (size_t size = (1 << 18) - 1000; size < (1 << 22); size += size / 7) {
+    char* p = alloc.allocate(size);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % parlay::internal::pool_allocator::max_alignment, 0);
+    std::fill(p, p + size, 'a');
+    blocks.emplace_back(p, size);
+  }
+  for (auto [p, size] : blocks) {
+    ASSERT_EQ(p[0], 'a');
+    ASSERT_EQ(p[size - 1], 'a');
+    alloc.deallocate(p, size);
+  }
+}
+
 TEST(TestAllocator, TestTypeAllocatorLarge) {
   // Larger than block_allocators default size
   struct X { char x[1<<19]; };
@@ -162,6 +201,95 @@ TEST(TestAllocator, TestTypeAllocatorLarge) {
 }
 
 
+TEST(TestAllocator, TestPoolAllocatorReallocateHuge) {
+  std::vector<size_t> sizes;
+  for (size_t size = 16; size <= (1 << 20); size *= 2) sizes.push_back(size);
+  parlay::internal::pool_allocator pool(sizes);
+
+  // Blocks within the pools can not be reallocated in place
+  void* small = pool.allocate(1000);
+  ASSERT_EQ(pool.try_reallocate(small, 1000, 2000), nullptr);
+  pool.deallocate(small, 1000);
+
+  size_t old_size = (1 << 21) + 3;
+  auto p = static_cast<unsigned char*>(pool.allocate(old_size));
+  ASSERT_NE(p, nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % parlay::internal::pool_allocator::max_alignment, 0);
+  for (size_t i = 0; i < old_size; i++) p[i] = static_cast<unsigned char>(i % 251);
+
+  size_t new_size = (1 << 23) + 5;
+  auto q = static_cast<unsigned char*>(pool.try_reallocate(p, old_size, new_size));
+#if defined(__linux__)
+  ASSERT_NE(q, nullptr);
+#endif
+  if (q == nullptr) {
+    pool.deallocate(p, old_size);
+  }
+  else {
+    for (size_t i = 0; i < old_size; i++) ASSERT_EQ(q[i], static_cast<unsigned char>(i % 251));
+    for (size_t i = old_size; i < new_size; i++) q[i] = 1;
+    pool.deallocate(q, new_size);
+  }
+}
+
+struct RetireTracked {
+  static inline std::atomic<int> num_destroyed{0};
+  std::atomic<int> value;
+  explicit RetireTracked(int value_) : value(value_) { }
+  ~RetireTracked() { value.store(-1); num_destroyed++; }
+};
+
+TEST(TestAllocator, TestTypeAllocatorRetire) {
+  using tracked_allocator = parlay::type_allocator<RetireTracked>;
+  int destroyed_before = RetireTracked::num_destroyed.load();
+  for (int i = 0; i < 100000; i++) {
+    tracked_allocator::retire(tracked_allocator::create(i));
+  }
+  // Retired objects are freed in batches, so most should already be gone
+  ASSERT_LT(tracked_allocator::num_retired(), 100000);
+  tracked_allocator::finish();
+  ASSERT_EQ(tracked_allocator::num_retired(), 0);
+  ASSERT_EQ(RetireTracked::num_destroyed.load() - destroyed_before, 100000);
+  ASSERT_EQ(tracked_allocator::num_used_blocks(), 0);
+}
+
+TEST(TestAllocator, TestTypeAllocatorRetireProtected) {
+  using tracked_allocator = parlay::type_allocator<RetireTracked>;
+  RetireTracked* x = tracked_allocator::create(42);
+  parlay::with_epoch([&]() {
+    tracked_allocator::retire(x);
+    for (int i = 0; i < 100000; i++) {
+      tracked_allocator::retire(tracked_allocator::create(i));
+    }
+    // x can not be destroyed while this thread is still protected
+    ASSERT_EQ(x->value.load(), 42);
+  });
+  tracked_allocator::finish();
+  ASSERT_EQ(tracked_allocator::num_used_blocks(), 0);
+}
+
+TEST(TestAllocator, TestTypeAllocatorRetireConcurrent) {
+  using tracked_allocator = parlay::type_allocator<RetireTracked>;
+  std::atomic<RetireTracked*> current{tracked_allocator::create(0)};
+  std::atomic<bool> ok{true};
+  parlay::parallel_for(1, 200000, [&](int i) {
+    if (i % 4 == 0) {
+      auto old = current.exchange(tracked_allocator::create(i));
+      tracked_allocator::retire(old);
+    }
+    else {
+      parlay::with_epoch([&]() {
+        RetireTracked* p = current.load();
+        if (p->value.load() < 0) ok = false;
+      });
+    }
+  }, 1);
+  ASSERT_TRUE(ok.load());
+  tracked_allocator::destroy(current.load());
+  tracked_allocator::finish();
+  ASSERT_EQ(tracked_allocator::num_used_blocks(), 0);
+}
+
 parlay::sequence<parlay::sequence<int>> a;
 
 TEST(TestAllocator, TestStaticGlobal) {
@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include <parlay/binary_io.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+namespace {
+
+// A new directory in the system's temporary directory, which is removed along
+// with its files when it goes out of scope, including when an assertion fails
+class temp_directory {
+ public:
+  temp_directory() : path(std::filesystem::temp_directory_path() /
+                          ("parlay_test_binary_io_" + std::to_string(std::random_device{}()))) {
+    std::filesystem::create_directories(path);
+  }
+  ~temp_directory() {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+  }
+
+  temp_directory(const temp_directory&) = delete;
+  temp_directory& operator=(const temp_directory&) = delete;
+
+  [[nodiscard]] std::string file(const std::string& name) const { return (path / name).string(); }
+
+ private:
+  std::filesystem::path path;
+};
+
+}  // namespace
+
+TEST(TestBinaryIO, TestFlat) {
+  temp_directory dir;
+  std::string filename = dir.file("flat.bin");
+  for (size_t n : {0, 1, 1000, 1000000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> long { return parlay::hash64(i); });
+    parlay::write_binary(s, filename);
+    ASSERT_EQ(parlay::read_binary<long>(filename), s);
+
+    auto view = parlay::map_binary<long>(filename);
+    ASSERT_EQ(view.size(), n);
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), s.begin()));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(view.data()) % alignof(long), 0U);
+  }
+}
+
+namespace {
+
+struct point {
+  int id;
+  double x, y;
+  bool operator==(const point& other) const { return id == other.id && x == other.x && y == other.y; }
+};
+
+}  // namespace
+
+TEST(TestBinaryIO, TestStruct) {
+  temp_directory dir;
+  std::string filename = dir.file("struct.bin");
+  auto s = parlay::tabulate(5000, [](size_t i) { return point{int(i), double(i) / 2, double(i) * 3}; });
+  parlay::write_binary(s, filename);
+  ASSERT_EQ(parlay::read_binary<point>(filename), s);
+}
+
+TEST(TestBinaryIO, TestNested) {
+  temp_directory dir;
+  std::string filename = dir.file("nested.bin");
+  auto s = parlay::tabulate(10000, [](size_t i) {
+    return parlay::tabulate(parlay::hash64(i) % 20, [&](size_t j) -> int { return int(i + j); });
+  });
+  parlay::write_binary(s, filename);
+  ASSERT_EQ(parlay::read_binary_nested<int>(filename), s);
+
+  auto view = parlay::map_binary_nested<int>(filename);
+  ASSERT_EQ(view.size(), s.size());
+  ASSERT_EQ(view.num_elements(), parlay::reduce(parlay::map(s, parlay::size_of())));
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(parlay::to_sequence(view[i]), s[i]);
+  }
+  auto sizes = parlay::map(view, parlay::size_of());
+  ASSERT_EQ(sizes, parlay::map(s, parlay::size_of()));
+}
+
+TEST(TestBinaryIO, TestNestedLarge) {
+  // Spans several of the blocks that are written in parallel
+  temp_directory dir;
+  std::string filename = dir.file("nested_large.bin");
+  auto s = parlay::tabulate(1000, [](size_t i) {
+    return parlay::tabulate(i % 10 == 0 ? 0 : 5000, [&](size_t j) -> uint32_t { return uint32_t(i * j); });
+  });
+  parlay::write_binary(s, filename);
+  ASSERT_EQ(parlay::read_binary_nested<uint32_t>(filename), s);
+}
+
+#if defined(PARLAY_EXCEPTIONS_ENABLED)
+
+TEST(TestBinaryIO, TestMismatch) {
+  temp_directory dir;
+  std::string filename = dir.file("mismatch.bin");
+  parlay::write_binary(parlay::sequence<int>(10, 1), filename);
+  ASSERT_THROW(parlay::read_binary<long>(filename), std::runtime_error);
+  ASSERT_THROW(parlay::read_binary_nested<int>(filename), std::runtime_error);
+  ASSERT_THROW(parlay::map_binary<double>(filename), std::runtime_error);
+
+  std::string text_filename = dir.file("text.bin");
+  std::ofstream out(text_filename);
+  out << "Not a binary sequence file, but long enough to contain a header. Words, words, words.";
+  out.close();
+  ASSERT_THROW(parlay::read_binary<int>(text_filename), std::runtime_error);
+}
+
+// Overwrites the 64-bit value at the given position in a file
+static void patch_binary_file(const std::string& filename, size_t position, uint64_t value) {
+  std::fstream f(filename, std::ios::in | std::ios::out | std::ios::binary);
+  f.seekp(static_cast<std::streamoff>(position));
+  f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(TestBinaryIO, TestCorrupt) {
+  temp_directory dir;
+  std::string filename = dir.file("corrupt.bin");
+  auto s = parlay::tabulate(100, [](size_t i) { return parlay::sequence<int>(i % 5, int(i)); });
+  auto check_throws = [&]() {
+    ASSERT_THROW(parlay::read_binary_nested<int>(filename), std::runtime_error);
+    ASSERT_THROW(parlay::map_binary_nested<int>(filename), std::runtime_error);
+  };
+  // The header is followed by the offsets, and the sizes in the header are
+  // the number of sequences at byte 24 and the number of elements at byte 32
+  size_t num_sequences_pos = 24, num_elements_pos = 32, offsets_pos = 64;
+
+  // A number of elements whose size in bytes overflows
+  parlay::write_binary(s, filename);
+  patch_binary_file(filename, num_elements_pos, (uint64_t{1} << 62) + 1);
+  check_throws();
+
+  // More offsets than fit before the elements
+  parlay::write_binary(s, filename);
+  patch_binary_file(filename, num_sequences_pos, 1000000);
+  check_throws();
+
+  // Offsets that decrease, or that do not end at the number of elements
+  parlay::write_binary(s, filename);
+  patch_binary_file(filename, offsets_pos + 10 * sizeof(uint64_t), 1000);
+  check_throws();
+  parlay::write_binary(s, filename);
+  patch_binary_file(filename, offsets_pos + 100 * sizeof(uint64_t), 1);
+  check_throws();
+}
+
+#endif  // defined(PARLAY_EXCEPTIONS_ENABLED)
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <parlay/bit_sequence.h>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+TEST(TestBitSequence, TestConstruct) {
+  parlay::bit_sequence empty;
+  ASSERT_TRUE(empty.empty());
+  ASSERT_EQ(empty.count(), 0U);
+  ASSERT_TRUE(parlay::pack_index(empty).empty());
+
+  for (size_t n : {1, 63, 64, 65, 1000, 4096, 100001}) {
+    parlay::bit_sequence zeros(n);
+    ASSERT_EQ(zeros.size(), n);
+    ASSERT_EQ(zeros.count(), 0U);
+    parlay::bit_sequence ones(n, true);
+    ASSERT_EQ(ones.count(), n);
+    ASSERT_EQ(ones.num_words(), (n + 63) / 64);
+    ones.fill(false);
+    ASSERT_EQ(ones.count(), 0U);
+  }
+}
+
+TEST(TestBitSequence, TestConvert) {
+  size_t n = 100003;
+  auto flags = parlay::tabulate(n, [](size_t i) -> bool { return parlay::hash64(i) % 3 == 0; });
+  parlay::bit_sequence b(flags);
+  ASSERT_EQ(b.size(), n);
+  for (size_t i = 0; i < n; i++) {
+    ASSERT_EQ(b[i], flags[i]);
+  }
+  ASSERT_EQ(b.to_sequence(), flags);
+  ASSERT_EQ(parlay::to_sequence(b), flags);
+}
+
+TEST(TestBitSequence, TestSetAndReset) {
+  size_t n = 1000;
+  parlay::bit_sequence b(n);
+  for (size_t i = 0; i < n; i += 7) b.set(i);
+  for (size_t i = 0; i < n; i++) ASSERT_EQ(b.test(i), i % 7 == 0);
+  for (size_t i = 0; i < n; i += 14) b.reset(i);
+  for (size_t i = 0; i < n; i++) ASSERT_EQ(b.test(i), i % 14 == 7);
+}
+
+TEST(TestBitSequence, TestAtomicSet) {
+  size_t n = 100000;
+  parlay::bit_sequence b(n);
+  auto firsts = parlay::tabulate(4 * n, [&](size_t i) -> size_t { return b.atomic_set(i % n); });
+  ASSERT_EQ(parlay::reduce(firsts), n);
+  ASSERT_EQ(b.count(), n);
+  auto resets = parlay::tabulate(n / 2, [&](size_t i) -> size_t { return b.atomic_reset(2 * i); });
+  ASSERT_EQ(parlay::reduce(resets), n / 2);
+  ASSERT_EQ(b.count(), n / 2);
+}
+
+TEST(TestBitSequence, TestCount) {
+  size_t n = 1000001;
+  auto flags = parlay::tabulate(n, [](size_t i) -> bool { return parlay::hash64(i) % 5 < 2; });
+  parlay::bit_sequence b(flags);
+  ASSERT_EQ(b.count(), parlay::count(flags, true));
+  ASSERT_EQ(parlay::count(b, true), parlay::count(flags, true));
+  ASSERT_EQ(parlay::count(b, false), parlay::count(flags, false));
+}
+
+TEST(TestBitSequence, TestPack) {
+  size_t n = 1000001;
+  auto flags = parlay::tabulate(n, [](size_t i) -> bool { return parlay::hash64(i) % 5 < 2; });
+  auto values = parlay::tabulate(n, [](size_t i) { return static_cast<int64_t>(i * i); });
+  parlay::bit_sequence b(flags);
+
+  ASSERT_EQ(parlay::pack_index(b), parlay::pack_index(flags));
+  ASSERT_EQ(parlay::pack_index<uint32_t>(b), parlay::pack_index<uint32_t>(flags));
+  ASSERT_EQ(parlay::pack(values, b), parlay::pack(values, flags));
+
+  const parlay::bit_sequence& cb = b;
+  ASSERT_EQ(parlay::pack(values, cb), parlay::pack(values, flags));
+  ASSERT_EQ(parlay::pack_index(parlay::bit_sequence(flags)), parlay::pack_index(flags));
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+
+#include <numeric>
+#include <utility>
+
+#include <parlay/chunked_sequence.h>
+#include <parlay/primitives.h>
+#include <parlay/range.h>
+#include <parlay/sequence.h>
+
+static_assert(parlay::is_random_access_range_v<parlay::chunked_sequence<int>>);
+static_assert(parlay::is_random_access_range_v<const parlay::chunked_sequence<int>>);
+
+// Chunks of sizes 0, 1, ..., n-1, so that there are plenty of empty and tiny chunks
+parlay::sequence<parlay::sequence<long long>> make_chunks(size_t n) {
+  size_t start = 0;
+  parlay::sequence<parlay::sequence<long long>> chunks;
+  for (size_t i = 0; i < n; i++) {
+    chunks.push_back(parlay::tabulate(i, [&](size_t j) -> long long { return start + j; }));
+    start += i;
+  }
+  return chunks;
+}
+
+TEST(TestChunkedSequence, TestEmpty) {
+  parlay::chunked_sequence<int> c;
+  ASSERT_TRUE(c.empty());
+  ASSERT_EQ(c.size(), 0);
+  ASSERT_EQ(c.num_chunks(), 0);
+  ASSERT_EQ(c.begin(), c.end());
+  ASSERT_TRUE(c.to_sequence().empty());
+  c.append(parlay::sequence<int>{});
+  ASSERT_EQ(c.num_chunks(), 0);
+  ASSERT_EQ(c.begin(), c.end());
+}
+
+TEST(TestChunkedSequence, TestFlattenChunked) {
+  auto chunks = make_chunks(1000);
+  auto expected = parlay::flatten(chunks);
+  auto first = chunks[1].begin();
+  auto c = parlay::flatten_chunked(std::move(chunks));
+  ASSERT_EQ(c.size(), expected.size());
+  ASSERT_EQ(c.num_chunks(), 1000);
+  ASSERT_EQ(&c[0], &*first);    // The elements were not copied
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(c[i], expected[i]);
+  }
+  ASSERT_EQ(c.to_sequence(), expected);
+  ASSERT_EQ(std::move(c).flatten(), expected);
+  ASSERT_TRUE(c.empty());
+}
+
+TEST(TestChunkedSequence, TestIterators) {
+  auto c = parlay::flatten_chunked(make_chunks(200));
+  long long n = static_cast<long long>(c.size());
+  ASSERT_EQ(c.end() - c.begin(), n);
+
+  long long i = 0;
+  for (auto x : c) ASSERT_EQ(x, i++);
+  ASSERT_EQ(i, n);
+
+  for (auto it = c.rbegin(); it != c.rend(); ++it) ASSERT_EQ(*it, --i);
+
+  for (long long j = 0; j < n; j += 37) {
+    auto it = c.begin() + j;
+    ASSERT_EQ(*it, j);
+    ASSERT_EQ(it - c.begin(), j);
+    for (long long k = 0; k < n; k += 101) {
+      ASSERT_EQ(*(it + (k - j)), k);
+      ASSERT_EQ(it[k - j], k);
+    }
+  }
+}
+
+TEST(TestChunkedSequence, TestAppend) {
+  parlay::chunked_sequence<long long> c;
+  parlay::sequence<long long> expected;
+  for (long long i = 0; i < 100; i++) {
+    auto s = parlay::tabulate(i * 10, [&](long long j) { return i + j; });
+    expected.append(s);
+    c.append(std::move(s));
+  }
+  ASSERT_EQ(c.to_sequence(), expected);
+
+  auto c2 = parlay::flatten_chunked(make_chunks(50));
+  expected.append(c2.to_sequence());
+  c.append(std::move(c2));
+  ASSERT_TRUE(c2.empty());
+  ASSERT_EQ(c.to_sequence(), expected);
+
+  auto a = parlay::append_chunked(parlay::sequence<int>{1, 2, 3}, parlay::sequence<int>{4, 5});
+  ASSERT_EQ(a.to_sequence(), (parlay::sequence<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(TestChunkedSequence, TestPrimitives) {
+  auto chunks = make_chunks(2000);
+  auto expected = parlay::flatten(chunks);
+  auto c = parlay::flatten_chunked(std::move(chunks));
+
+  ASSERT_EQ(parlay::reduce(c), parlay::reduce(expected));
+  ASSERT_EQ(parlay::scan(c), parlay::scan(expected));
+  ASSERT_EQ(parlay::map(c, [](long long x) { return 2 * x; }),
+            parlay::map(expected, [](long long x) { return 2 * x; }));
+  auto flags = parlay::map(expected, [](long long x) { return x % 3 == 0; });
+  ASSERT_EQ(parlay::pack(c, flags), parlay::pack(expected, flags));
+  ASSERT_EQ(parlay::filter(c, [](long long x) { return x % 7 == 1; }),
+            parlay::filter(expected, [](long long x) { return x % 7 == 1; }));
+
+  parlay::parallel_for(0, c.size(), [&](size_t i) { c[i] += 1; });
+  ASSERT_EQ(parlay::reduce(c), parlay::reduce(expected) + static_cast<long long>(expected.size()));
+}
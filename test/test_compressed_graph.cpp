@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+
+#include <utility>
+
+#include <parlay/compressed_graph.h>
+#include <parlay/csr_graph.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+namespace {
+
+using edge = std::pair<int, int>;
+
+parlay::sequence<edge> random_edges(size_t n, size_t m) {
+  return parlay::tabulate(m, [&](size_t i) {
+    return edge(parlay::hash64(2 * i) % n, parlay::hash64(2 * i + 1) % n);
+  });
+}
+
+}  // namespace
+
+TEST(TestCompressedGraph, TestEmpty) {
+  parlay::compressed_graph<int> G;
+  ASSERT_TRUE(G.empty());
+  ASSERT_EQ(G.num_edges(), 0);
+}
+
+TEST(TestCompressedGraph, TestFromCsr) {
+  size_t n = 2000, m = 40000;
+  auto G = parlay::csr_graph<int>::from_edges(random_edges(n, m), n);
+  parlay::compressed_graph<int> C(G);
+  ASSERT_EQ(C.num_vertices(), n);
+  ASSERT_EQ(C.num_edges(), m);
+  for (size_t u = 0; u < n; u++) {
+    ASSERT_EQ(C.degree(u), G.degree(u));
+    ASSERT_EQ(C[u], parlay::sort(G[u]));
+  }
+
+  auto D = C.to_csr_graph();
+  D.sort_neighbors();
+  G.sort_neighbors();
+  ASSERT_EQ(D.get_offsets(), G.get_offsets());
+  ASSERT_EQ(D.get_edges(), G.get_edges());
+}
+
+TEST(TestCompressedGraph, TestFromNested) {
+  // Neighbors close to the vertex id, which should take one byte each
+  size_t n = 10000;
+  auto nested = parlay::tabulate(n, [&](size_t u) {
+    return parlay::tabulate(10, [&](size_t j) -> int { return static_cast<int>((u + 3 * j + n - 12) % n); });
+  });
+  parlay::compressed_graph<int> C(nested);
+  ASSERT_EQ(C.num_edges(), 10 * n);
+  ASSERT_LT(C.size_in_bytes(), 10 * n * sizeof(int) / 2 + 2 * (n + 1) * sizeof(size_t));
+  for (size_t u = 0; u < n; u++) ASSERT_EQ(C[u], parlay::sort(nested[u]));
+
+  auto degrees = parlay::map(C, parlay::size_of());
+  ASSERT_EQ(parlay::reduce(degrees), 10 * n);
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+
+#include <parlay/compressed_sequence.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+#include <parlay/internal/varint.h>
+
+TEST(TestCompressedSequence, TestVarint) {
+  uint8_t buffer[16];
+  for (uint64_t x : {uint64_t{0}, uint64_t{1}, uint64_t{127}, uint64_t{128}, uint64_t{300},
+                     uint64_t{1} << 35, ~uint64_t{0}}) {
+    uint8_t* end = parlay::internal::varint_encode(x, buffer);
+    ASSERT_EQ(size_t(end - buffer), parlay::internal::varint_size(x));
+    uint64_t y;
+    ASSERT_EQ(parlay::internal::varint_decode(buffer, y), end);
+    ASSERT_EQ(x, y);
+  }
+  for (int64_t x : {int64_t{0}, int64_t{-1}, int64_t{1}, int64_t{-1000}, int64_t{1} << 40}) {
+    ASSERT_EQ(parlay::internal::zigzag_decode(parlay::internal::zigzag_encode(x)), x);
+  }
+  ASSERT_EQ(parlay::internal::zigzag_encode(-1), 1);
+  ASSERT_EQ(parlay::internal::zigzag_encode(1), 2);
+}
+
+TEST(TestCompressedSequence, TestEmpty) {
+  parlay::compressed_sequence<uint64_t> c;
+  ASSERT_TRUE(c.empty());
+  ASSERT_EQ(c.lower_bound(5), 0);
+  ASSERT_TRUE(c.to_sequence().empty());
+
+  parlay::compressed_sequence<uint64_t> d(parlay::sequence<uint64_t>{});
+  ASSERT_EQ(d.size(), 0);
+  ASSERT_EQ(d.num_blocks(), 0);
+}
+
+TEST(TestCompressedSequence, TestRoundTrip) {
+  for (size_t n : {1, 127, 128, 129, 1000, 100000}) {
+    auto s = parlay::sort(parlay::tabulate(n, [](size_t i) -> uint64_t {
+      return parlay::hash64(i) % (1000 * (i + 1));
+    }));
+    parlay::compressed_sequence<uint64_t> c(s);
+    ASSERT_EQ(c.size(), n);
+    ASSERT_EQ(c.to_sequence(), s);
+    for (size_t i = 0; i < n; i += 1 + n / 100) ASSERT_EQ(c[i], s[i]);
+    ASSERT_EQ(c[n - 1], s[n - 1]);
+  }
+}
+
+TEST(TestCompressedSequence, TestCompresses) {
+  size_t n = 100000;
+  auto s = parlay::tabulate(n, [](size_t i) -> uint64_t { return (uint64_t{1} << 40) + 3 * i; });
+  parlay::compressed_sequence<uint64_t> c(s);
+  ASSERT_EQ(c.to_sequence(), s);
+  ASSERT_LT(c.size_in_bytes(), n * sizeof(uint64_t) / 4);
+}
+
+TEST(TestCompressedSequence, TestSigned) {
+  auto s = parlay::tabulate(10000, [](long i) -> int { return static_cast<int>(i * 7 - 30000); });
+  parlay::compressed_sequence<int> c(s);
+  ASSERT_EQ(c.to_sequence(), s);
+  ASSERT_EQ(c[0], -30000);
+}
+
+TEST(TestCompressedSequence, TestLowerBound) {
+  size_t n = 5000;
+  auto s = parlay::tabulate(n, [](size_t i) -> uint32_t { return static_cast<uint32_t>(2 * (i / 3)); });
+  parlay::compressed_sequence<uint32_t> c(s);
+  for (uint32_t x = 0; x < 2 * n / 3 + 3; x++) {
+    size_t expected = std::lower_bound(s.begin(), s.end(), x) - s.begin();
+    ASSERT_EQ(c.lower_bound(x), expected);
+  }
+}
+
+TEST(TestCompressedSequence, TestForEach) {
+  size_t n = 100000;
+  auto s = parlay::tabulate(n, [](size_t i) -> uint64_t { return i * i; });
+  parlay::compressed_sequence<uint64_t> c(s);
+  std::atomic<uint64_t> total{0};
+  parlay::for_each(c, [&](uint64_t x) { total += x; });
+  ASSERT_EQ(total.load(), parlay::reduce(s));
+
+  size_t blocks_seen = 0;
+  for (size_t b = 0; b < c.num_blocks(); b++) {
+    c.decode_block(b, [&](size_t i, uint64_t x) { ASSERT_EQ(x, s[i]); });
+    blocks_seen++;
+  }
+  ASSERT_EQ(blocks_seen, (n + c.block_size - 1) / c.block_size);
+}
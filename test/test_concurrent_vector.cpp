@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <parlay/concurrent_vector.h>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+TEST(TestConcurrentVector, TestEmpty) {
+  parlay::concurrent_vector<int> v;
+  ASSERT_TRUE(v.empty());
+  ASSERT_EQ(v.size(), 0);
+  ASSERT_TRUE(v.finalize().empty());
+  ASSERT_TRUE(v.finalize_chunked().empty());
+}
+
+TEST(TestConcurrentVector, TestPushBack) {
+  size_t n = 1000000;
+  parlay::concurrent_vector<size_t> v;
+  parlay::parallel_for(0, n, [&](size_t i) {
+    if (i % 3 == 0) v.push_back(i);
+  });
+  ASSERT_EQ(v.size(), (n + 2) / 3);
+  auto result = parlay::sort(v.finalize());
+  ASSERT_TRUE(v.empty());
+  ASSERT_EQ(result, parlay::filter(parlay::iota(n), [](size_t i) { return i % 3 == 0; }));
+}
+
+TEST(TestConcurrentVector, TestEmplaceAndAppend) {
+  size_t n = 100000;
+  parlay::concurrent_vector<std::unique_ptr<size_t>> v;
+  parlay::parallel_for(0, n, [&](size_t i) {
+    if (i % 2 == 0) {
+      v.emplace_back(std::make_unique<size_t>(i));
+    }
+    else {
+      parlay::sequence<std::unique_ptr<size_t>> s;
+      s.push_back(std::make_unique<size_t>(i));
+      v.append(std::move(s));
+    }
+  });
+  auto result = parlay::sort(parlay::map(v.finalize(), [](auto& p) { return *p; }));
+  ASSERT_EQ(result, parlay::to_sequence(parlay::iota(n)));
+}
+
+TEST(TestConcurrentVector, TestFinalizeChunked) {
+  size_t n = 100000;
+  parlay::concurrent_vector<size_t> v;
+  parlay::parallel_for(0, n, [&](size_t i) { v.push_back(i); });
+  auto c = v.finalize_chunked();
+  ASSERT_TRUE(v.empty());
+  ASSERT_EQ(c.size(), n);
+  ASSERT_EQ(parlay::reduce(c), n * (n - 1) / 2);
+}
+
+// An element that is not trivially relocatable, whose slow move gives other
+// tasks time to push onto the same buffer if a push ever forks
+struct slow_move {
+  size_t value;
+  explicit slow_move(size_t v) : value(v) { }
+  slow_move(const slow_move& other) : value(other.value) { }
+  slow_move(slow_move&& other) noexcept : value(other.value) {
+    for (volatile int k = 0; k < 20; k = k + 1) { }
+  }
+  slow_move& operator=(const slow_move& other) { value = other.value; return *this; }
+  slow_move& operator=(slow_move&& other) noexcept { value = other.value; return *this; }
+};
+
+TEST(TestConcurrentVector, TestOversubscribed) {
+  static_assert(!parlay::is_trivially_relocatable_v<slow_move>);
+  // With more workers than cores, a worker that waits at a join is likely
+  // to run another iteration of the loop
+  unsigned int p = (std::max)(16u, 2 * std::thread::hardware_concurrency());
+  parlay::execute_with_scheduler(p, [&]() {
+    size_t n = 1000000;
+    for (int round = 0; round < 3; round++) {
+      parlay::concurrent_vector<slow_move> v;
+      parlay::parallel_for(0, n, [&](size_t i) {
+        if (i % 1000 != 0) {
+          v.push_back(slow_move(i));
+        }
+        else {
+          auto s = parlay::tabulate(1000, [&](size_t j) { return slow_move(n + i + j); });
+          v.append(s);
+        }
+      });
+      ASSERT_EQ(v.size(), n - n / 1000 + n);
+      auto values = parlay::sort(parlay::map(v.finalize(), [](const slow_move& x) { return x.value; }));
+      auto expected = parlay::sort(parlay::append(
+          parlay::filter(parlay::iota(n), [](size_t i) { return i % 1000 != 0; }),
+          parlay::flatten(parlay::tabulate(n / 1000, [&](size_t b) {
+            return parlay::tabulate(1000, [&](size_t j) { return n + 1000 * b + j; });
+          }))));
+      ASSERT_EQ(values, expected);
+    }
+  });
+}
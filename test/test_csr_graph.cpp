@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include <tuple>
+#include <utility>
+
+#include <parlay/csr_graph.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+namespace {
+
+using edge = std::pair<int, int>;
+
+parlay::sequence<edge> random_edges(size_t n, size_t m) {
+  return parlay::tabulate(m, [&](size_t i) {
+    return edge(parlay::hash64(2 * i) % n, parlay::hash64(2 * i + 1) % n);
+  });
+}
+
+}  // namespace
+
+TEST(TestCsrGraph, TestEmpty) {
+  parlay::csr_graph<int> G;
+  ASSERT_TRUE(G.empty());
+  ASSERT_EQ(G.num_edges(), 0);
+
+  auto H = parlay::csr_graph<int>::from_edges(parlay::sequence<edge>(), 10);
+  ASSERT_EQ(H.num_vertices(), 10);
+  ASSERT_EQ(H.num_edges(), 0);
+  for (size_t u = 0; u < 10; u++) ASSERT_EQ(H[u].size(), 0);
+}
+
+TEST(TestCsrGraph, TestFromEdges) {
+  size_t n = 1000, m = 20000;
+  auto E = random_edges(n, m);
+  auto G = parlay::csr_graph<int>::from_edges(E, n);
+  auto expected = parlay::group_by_index(E, n);
+  ASSERT_EQ(G.num_vertices(), n);
+  ASSERT_EQ(G.num_edges(), m);
+  for (size_t u = 0; u < n; u++) {
+    ASSERT_EQ(G.degree(u), expected[u].size());
+    ASSERT_EQ(parlay::to_sequence(G[u]), expected[u]);
+  }
+}
+
+TEST(TestCsrGraph, TestFromNested) {
+  size_t n = 1000, m = 20000;
+  auto nested = parlay::group_by_index(random_edges(n, m), n);
+  parlay::csr_graph<int> G(nested);
+  ASSERT_EQ(G.num_vertices(), n);
+  ASSERT_EQ(G.num_edges(), m);
+  ASSERT_EQ(G.get_offsets()[n], m);
+  for (size_t u = 0; u < n; u++) ASSERT_EQ(parlay::to_sequence(G[u]), nested[u]);
+}
+
+TEST(TestCsrGraph, TestRange) {
+  size_t n = 500, m = 5000;
+  auto G = parlay::csr_graph<int>::from_edges(random_edges(n, m), n);
+  ASSERT_EQ(G.end() - G.begin(), n);
+  auto degrees = parlay::map(G, parlay::size_of());
+  ASSERT_EQ(parlay::reduce(degrees), m);
+  size_t u = 0;
+  for (auto nghs : G) ASSERT_EQ(nghs.size(), G.degree(u++));
+}
+
+TEST(TestCsrGraph, TestTranspose) {
+  size_t n = 1000, m = 20000;
+  auto E = random_edges(n, m);
+  auto G = parlay::csr_graph<int>::from_edges(E, n);
+  auto GT = G.transpose();
+  ASSERT_EQ(GT.num_vertices(), n);
+  ASSERT_EQ(GT.num_edges(), m);
+  auto ET = parlay::map(E, [](edge e) { return edge(e.second, e.first); });
+  auto expected = parlay::group_by_index(parlay::sort(ET), n);
+  for (size_t v = 0; v < n; v++) ASSERT_EQ(parlay::to_sequence(GT[v]), expected[v]);
+
+  auto GTT = GT.transpose();
+  ASSERT_EQ(parlay::sort(GTT.to_edges()), parlay::sort(E));
+}
+
+TEST(TestCsrGraph, TestWeighted) {
+  size_t n = 300, m = 3000;
+  auto E = parlay::tabulate(m, [&](size_t i) {
+    return std::make_tuple(int(parlay::hash64(2 * i) % n), int(parlay::hash64(2 * i + 1) % n), double(i));
+  });
+  auto G = parlay::csr_graph<int, double>::from_edges(E, n);
+  ASSERT_EQ(G.num_edges(), m);
+  auto GT = G.transpose();
+  for (size_t u = 0; u < n; u++) {
+    for (auto [v, w] : G[u]) {
+      auto [s, t, x] = E[size_t(w)];
+      ASSERT_EQ(s, int(u));
+      ASSERT_EQ(t, v);
+    }
+    for (auto [v, w] : GT[u]) {
+      auto [s, t, x] = E[size_t(w)];
+      ASSERT_EQ(s, v);
+      ASSERT_EQ(t, int(u));
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <parlay/file_allocator.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+TEST(TestFileAllocator, TestAllocate) {
+  parlay::file_allocator<int> a;
+  int* p = a.allocate(100000);
+  ASSERT_NE(p, nullptr);
+  for (int i = 0; i < 100000; i++) {
+    p[i] = i;
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(p[i], i);
+  }
+  a.deallocate(p, 100000);
+}
+
+TEST(TestFileAllocator, TestStdVector) {
+  std::vector<int, parlay::file_allocator<int>> v;
+  for (int i = 0; i < 100000; i++) {
+    v.push_back(i);
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(v[i], i);
+  }
+}
+
+TEST(TestFileAllocator, TestSequence) {
+  using alloc = parlay::file_allocator<long>;
+  parlay::sequence<long, alloc> s(1000000);
+  parlay::parallel_for(0, s.size(), [&](size_t i) { s[i] = (50021 * i + 61) % 1000003; });
+  ASSERT_EQ(parlay::reduce(s), parlay::reduce(parlay::tabulate(1000000, [](size_t i) -> long {
+    return (50021 * i + 61) % 1000003; })));
+  parlay::sort_inplace(s);
+  ASSERT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+TEST(TestFileAllocator, TestSequenceGrow) {
+  using alloc = parlay::file_allocator<int, parlay::file_access::sequential>;
+  parlay::sequence<int, alloc> s;
+  for (int i = 0; i < 100000; i++) {
+    s.push_back(i);
+  }
+  auto t = s;
+  t.append(s);
+  ASSERT_EQ(t.size(), 200000);
+  for (int i = 0; i < 200000; i++) {
+    ASSERT_EQ(t[i], i % 100000);
+  }
+}
+
+TEST(TestFileAllocator, TestRandomAccess) {
+  using alloc = parlay::file_allocator<size_t, parlay::file_access::random>;
+  parlay::sequence<size_t, alloc> s(100000);
+  parlay::parallel_for(0, s.size(), [&](size_t i) { s[i] = i; });
+  auto idx = parlay::random_permutation<size_t>(100000);
+  auto gathered = parlay::tabulate(s.size(), [&](size_t i) -> size_t { return s[idx[i]]; });
+  ASSERT_EQ(gathered, idx);
+}
+
+TEST(TestFileAllocator, TestSetDirectory) {
+  std::string old_directory = parlay::get_file_allocator_directory();
+  parlay::set_file_allocator_directory(".");
+  ASSERT_EQ(parlay::get_file_allocator_directory(), ".");
+  {
+    parlay::sequence<int, parlay::file_allocator<int>> s(1000, 42);
+    ASSERT_EQ(parlay::count(s, 42), 1000);
+  }
+  parlay::set_file_allocator_directory(old_directory);
+}
+
+#if defined(PARLAY_EXCEPTIONS_ENABLED) && defined(PARLAY_POSIX_FILE_MAP)
+
+TEST(TestFileAllocator, TestOverflow) {
+  // The size in bytes would wrap around to a small number
+  size_t n = std::numeric_limits<size_t>::max() / sizeof(size_t) + 2;
+  ASSERT_THROW(parlay::file_allocator<size_t>().allocate(n), std::bad_alloc);
+}
+
+#endif  // defined(PARLAY_EXCEPTIONS_ENABLED) && defined(PARLAY_POSIX_FILE_MAP)
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <deque>
 #include <numeric>
+#include <string>
+#include <utility>
 
 #include <parlay/primitives.h>
 #include <parlay/sequence.h>
@@ -93,3 +95,62 @@ TEST(TestIntegerSort, TestIntegerSortCopyAndDestructiveMove) {
     ASSERT_EQ(real_sorted[i].value(), sorted[i].value());
   }
 }
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemory) {
+  for (size_t n : {0, 1, 100, 200, 1000, 12345, 100000, 1000000}) {
+    // Uniform keys, few distinct keys, and keys that mostly share their top digit
+    auto uniform = parlay::tabulate(n, [](size_t i) -> unsigned long long { return parlay::hash64(i); });
+    auto few = parlay::tabulate(n, [](size_t i) -> unsigned long long { return parlay::hash64(i) % 5; });
+    auto skewed = parlay::tabulate(n, [](size_t i) -> unsigned long long {
+      return (i % 100 == 0) ? parlay::hash64(i) : parlay::hash64(i) % 1000;
+    });
+    for (auto s : {uniform, few, skewed}) {
+      auto sorted = s;
+      std::sort(std::begin(sorted), std::end(sorted));
+      parlay::integer_sort_inplace(s, parlay::sort_mode::low_memory);
+      ASSERT_EQ(s, sorted);
+    }
+  }
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryCustomKey) {
+  auto s = parlay::tabulate(300000, [](unsigned int i) -> UnstablePair {
+    UnstablePair x;
+    x.x = (53 * i + 61) % (1 << 20);
+    x.y = i;
+    return x;
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted), [](const auto& a, const auto& b) { return a.x < b.x; });
+  parlay::integer_sort_inplace(s, [](const auto& x) -> unsigned int { return x.x; },
+                               parlay::sort_mode::low_memory);
+  ASSERT_EQ(s.size(), sorted.size());
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i].x, sorted[i].x);
+  }
+  // Every element is still present
+  std::sort(std::begin(s), std::end(s), [](const auto& a, const auto& b) { return a.y < b.y; });
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(static_cast<size_t>(s[i].y), i);
+  }
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryNonTrivial) {
+  // Elements that are not trivially relocatable
+  auto s = parlay::tabulate(200000, [](size_t i) {
+    return std::make_pair(static_cast<unsigned int>(parlay::hash64(i) % 100000), std::to_string(i));
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted));
+  parlay::integer_sort_inplace(s, [](const auto& p) { return p.first; }, parlay::sort_mode::low_memory);
+  std::sort(std::begin(s), std::end(s));   // Make the order within equal keys deterministic
+  ASSERT_EQ(s, sorted);
+
+  // Elements that are trivially relocatable but not copyable
+  auto p = parlay::tabulate(200000, [](long long i) {
+    return std::make_unique<long long>((50021 * i + 61) % (1 << 20));
+  });
+  parlay::integer_sort_inplace(p, [](const auto& x) { return static_cast<unsigned int>(*x); },
+                               parlay::sort_mode::low_memory);
+  ASSERT_TRUE(std::is_sorted(std::begin(p), std::end(p), [](const auto& a, const auto& b) { return *a < *b; }));
+}
@@ -158,3 +158,63 @@ TEST(TestMergeSort, TestSortNonContiguous) {
   ASSERT_EQ(s, s2); 
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
+
+TEST(TestMergeSort, TestSortPresorted) {
+  for (size_t n : {100, 100000}) {
+    auto s = parlay::tabulate(n, [](int i) -> UnstablePair {
+      return {i / 3, i};
+    });
+    auto s2 = s;
+    parlay::internal::merge_sort_inplace(make_slice(s), std::less<UnstablePair>());
+    ASSERT_EQ(s, s2);
+  }
+}
+
+TEST(TestMergeSort, TestSortReverseSorted) {
+  auto s = parlay::tabulate(100000, [](long long i) -> long long {
+    return 100000 - i;
+  });
+  auto s2 = s;
+  parlay::internal::merge_sort_inplace(make_slice(s), std::less<long long>());
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestMergeSort, TestStableSortReverseSortedDuplicates) {
+  // Not strictly decreasing, so reversing the runs would not be stable
+  auto s = parlay::tabulate(100000, [](int i) -> UnstablePair {
+    return {(100000 - i) / 5, i};
+  });
+  auto s2 = s;
+  parlay::internal::merge_sort_inplace(make_slice(s), std::less<UnstablePair>());
+  std::stable_sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestMergeSort, TestStableSortRuns) {
+  for (int k : {2, 3, 10, 1000}) {
+    auto s = parlay::tabulate(100000, [&](int i) -> UnstablePair {
+      // k runs of alternating direction, with duplicates within and across runs
+      int len = 100000 / k, run = i / len, pos = i % len;
+      return {run % 2 == 0 ? pos / 2 : len - 2 * pos, i};
+    });
+    auto s2 = s;
+    parlay::internal::merge_sort_inplace(make_slice(s), std::less<UnstablePair>());
+    std::stable_sort(std::begin(s2), std::end(s2));
+    ASSERT_EQ(s, s2);
+  }
+}
+
+TEST(TestMergeSort, TestSortAppendedBatch) {
+  auto s = parlay::tabulate(100000, [](long long i) -> long long {
+    return 2 * i;
+  });
+  for (long long i = 0; i < 100; i++) s.push_back((50021 * i + 61) % 200000);
+  auto s2 = std::deque<long long>(s.begin(), s.end());
+  auto s3 = s;
+  parlay::internal::merge_sort_inplace(make_slice(s), std::less<long long>());
+  parlay::internal::merge_sort_inplace(parlay::make_slice(s2), std::less<long long>());
+  std::sort(std::begin(s3), std::end(s3));
+  ASSERT_EQ(s, s3);
+  ASSERT_TRUE(std::equal(s2.begin(), s2.end(), s3.begin()));
+}
@@ -174,6 +174,51 @@ TEST(TestPrimitives, TestScanInclusiveInplaceMax) {
   ASSERT_EQ(total, sum);
 }
 
+// Large enough to use the single-pass scan
+TEST(TestPrimitives, TestScanLarge) {
+  // Only inputs whose elements can be read without forking are scanned in a single pass
+  static_assert(parlay::internal::use_single_pass_scan_v<parlay::sequence<long long>, parlay::plus<long long>>);
+  static_assert(!parlay::internal::use_single_pass_scan_v<decltype(parlay::iota(1)), parlay::plus<size_t>>);
+  static_assert(!parlay::internal::use_single_pass_scan_v<parlay::sequence<std::string>, parlay::plus<std::string>>);
+  auto s = parlay::tabulate(3000000, [](long long i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto psums = parlay::sequence<long long>(3000000);
+  std::partial_sum(std::begin(s), std::end(s)-1, std::begin(psums)+1);
+  auto [scanned, total] = parlay::scan(s);
+  ASSERT_EQ(scanned, psums);
+  ASSERT_EQ(total, std::accumulate(std::begin(s), std::end(s), 0LL));
+  auto inclusive = parlay::scan_inclusive(s);
+  ASSERT_TRUE(std::equal(std::begin(psums)+1, std::end(psums), std::begin(inclusive)));
+  ASSERT_EQ(inclusive.back(), total);
+  ASSERT_EQ(parlay::scan_inplace(s), total);
+  ASSERT_EQ(s, psums);
+}
+
+// The composition of affine functions x -> a*x + b (mod p), which is not commutative
+struct Affine {
+  long long a, b;
+  bool operator==(const Affine& other) const { return a == other.a && b == other.b; }
+};
+
+TEST(TestPrimitives, TestScanLargeNonCommutative) {
+  const long long p = 1000000007;
+  auto compose = [p](const Affine& f, const Affine& g) {   // Apply f, then g
+    return Affine{f.a * g.a % p, (f.b * g.a + g.b) % p};
+  };
+  auto m = parlay::make_monoid(compose, Affine{1, 0});
+  auto s = parlay::tabulate(1000000, [](long long i) -> Affine {
+    return Affine{(i * 7 + 3) % 1000, (i * 13 + 5) % 1000};
+  });
+  auto [scanned, total] = parlay::scan(s, m);
+  Affine r{1, 0};
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(scanned[i], r);
+    r = compose(r, s[i]);
+  }
+  ASSERT_EQ(total, r);
+}
+
 TEST(TestPrimitives, TestPack) {
   auto s = parlay::tabulate(100000, [](int i) { return i; });
   auto b = parlay::tabulate(100000, [](int i) -> bool { return i % 2 == 0; });
@@ -256,6 +301,55 @@ TEST(TestPrimitives, TestFilterInto) {
   }
 }
 
+TEST(TestPrimitives, TestPartition) {
+  for (size_t n : {0, 1, 1000, 100000, 1000000}) {
+    for (int d : {1, 2, 3, 1000}) {
+      auto s = parlay::tabulate(n, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+      auto pred = [d](long x) { return x % d == 0; };
+      auto a = s;
+      size_t m = parlay::partition(a, pred);
+      ASSERT_EQ(m, parlay::count_if(s, pred));
+      ASSERT_TRUE(parlay::is_partitioned(a, pred));
+      ASSERT_EQ(parlay::sort(a), parlay::sort(s));
+    }
+  }
+}
+
+TEST(TestPrimitives, TestStablePartition) {
+  for (size_t n : {0, 1, 1000, 100000, 1000000}) {
+    for (int d : {1, 2, 3, 1000}) {
+      auto s = parlay::tabulate(n, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+      auto pred = [d](long x) { return x % d == 0; };
+      auto a = s;
+      size_t m = parlay::stable_partition(a, pred);
+      auto expected = s;
+      std::stable_partition(expected.begin(), expected.end(), pred);
+      ASSERT_EQ(m, parlay::count_if(s, pred));
+      ASSERT_EQ(a, expected);
+    }
+  }
+}
+
+TEST(TestPrimitives, TestPartition3) {
+  auto s = parlay::tabulate(1000000, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+  auto f = [](long x) { return x < 300000 ? 0 : (x < 300010 ? 1 : 2); };
+  auto a = s;
+  auto [m1, m2] = parlay::partition3(a, f);
+  ASSERT_EQ(m1, parlay::count_if(s, [&](long x) { return f(x) == 0; }));
+  ASSERT_EQ(m2 - m1, parlay::count_if(s, [&](long x) { return f(x) == 1; }));
+  for (size_t i = 0; i < a.size(); i++) {
+    ASSERT_EQ(f(a[i]), i < m1 ? 0 : (i < m2 ? 1 : 2));
+  }
+  ASSERT_EQ(parlay::sort(a), parlay::sort(s));
+
+  auto b = s;
+  auto [n1, n2] = parlay::stable_partition3(b, f);
+  ASSERT_EQ(n1, m1);
+  ASSERT_EQ(n2, m2);
+  auto expected = parlay::stable_sort(s, [&](long x, long y) { return f(x) < f(y); });
+  ASSERT_EQ(b, expected);
+}
+
 TEST(TestPrimitives, TestMerge) {
   auto s1 = parlay::tabulate(50000, [](int i) { return 2*i; });
   auto s2 = parlay::tabulate(50000, [](int i) { return 2*i + 1; });
@@ -276,6 +370,108 @@ TEST(TestPrimitives, TestMergeCustomPredicate) {
   }
 }
 
+TEST(TestPrimitives, TestMultiwayMerge) {
+  for (size_t k : {0, 1, 2, 3, 7, 16, 100}) {
+    auto rs = parlay::tabulate(k, [&](size_t j) {
+      return parlay::tabulate(100000 / (k + 1) + j, [&](size_t i) { return k * i + j; });
+    });
+    auto s = parlay::multiway_merge(rs);
+    auto expected = parlay::sort(parlay::flatten(rs));
+    ASSERT_EQ(s, expected);
+  }
+}
+
+TEST(TestPrimitives, TestMultiwayMergeEmptyRanges) {
+  auto rs = parlay::tabulate(50, [&](size_t j) {
+    return parlay::tabulate(j % 3 == 0 ? 0 : 5000 * j, [&](size_t i) { return (i * j) % 1000; });
+  });
+  for (auto& r : rs) std::sort(r.begin(), r.end());
+  auto s = parlay::multiway_merge(rs);
+  auto expected = parlay::sort(parlay::flatten(rs));
+  ASSERT_EQ(s, expected);
+}
+
+TEST(TestPrimitives, TestMultiwayMergeCustomPredicate) {
+  auto rs = parlay::tabulate(10, [&](size_t j) {
+    return parlay::tabulate(100000, [&](size_t i) { return 10 * (100000 - i) + j; });
+  });
+  auto s = parlay::multiway_merge(rs, std::greater<>());
+  auto expected = parlay::sort(parlay::flatten(rs), std::greater<>());
+  ASSERT_EQ(s, expected);
+}
+
+TEST(TestPrimitives, TestMultiwayMergeStable) {
+  // Many duplicate keys, whose order must be that of the range they come from
+  auto rs = parlay::tabulate(20, [&](size_t j) {
+    return parlay::tabulate(50000, [&](size_t i) { return std::make_pair((i + j) / 100, j); });
+  });
+  auto s = parlay::multiway_merge(rs, [](const auto& a, const auto& b) { return a.first < b.first; });
+  auto expected = parlay::sort(parlay::flatten(rs));
+  ASSERT_EQ(s, expected);
+}
+
+// Sorted sequences of sizes n1 and n2 with keys in [0, range),
+// which have many duplicates when range is small
+static auto sorted_set_inputs(size_t n1, size_t n2, long range) {
+  auto s1 = parlay::sort(parlay::tabulate(n1, [&](size_t i) { return (long) (parlay::hash64(i) % range); }));
+  auto s2 = parlay::sort(parlay::tabulate(n2, [&](size_t i) { return (long) (parlay::hash64(n1 + i) % range); }));
+  return std::make_pair(std::move(s1), std::move(s2));
+}
+
+TEST(TestPrimitives, TestSetOperations) {
+  for (auto [n1, n2, range] : {std::make_tuple(100000, 100000, 200000L), std::make_tuple(100000, 50000, 1000L),
+                               std::make_tuple(1000, 200000, 1000000L), std::make_tuple(200000, 1000, 1000000L),
+                               std::make_tuple(100000, 100000, 1L), std::make_tuple(0, 1000, 1000L),
+                               std::make_tuple(100, 20, 100L)}) {
+    auto [s1, s2] = sorted_set_inputs(n1, n2, range);
+    parlay::sequence<long> expected;
+    std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    ASSERT_EQ(parlay::set_intersection(s1, s2), expected);
+    ASSERT_EQ(parlay::set_intersection_size(s1, s2), expected.size());
+    expected.clear();
+    std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    ASSERT_EQ(parlay::set_union(s1, s2), expected);
+    expected.clear();
+    std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected));
+    ASSERT_EQ(parlay::set_difference(s1, s2), expected);
+    expected.clear();
+    std::set_difference(s2.begin(), s2.end(), s1.begin(), s1.end(), std::back_inserter(expected));
+    ASSERT_EQ(parlay::set_difference(s2, s1), expected);
+  }
+}
+
+TEST(TestPrimitives, TestSetOperationsCustomPredicate) {
+  auto [s1, s2] = sorted_set_inputs(100000, 30000, 50000);
+  std::reverse(s1.begin(), s1.end());
+  std::reverse(s2.begin(), s2.end());
+  parlay::sequence<long> expected;
+  std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected), std::greater<>());
+  ASSERT_EQ(parlay::set_intersection(s1, s2, std::greater<>()), expected);
+  ASSERT_EQ(parlay::set_intersection_size(s1, s2, std::greater<>()), expected.size());
+  expected.clear();
+  std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected), std::greater<>());
+  ASSERT_EQ(parlay::set_union(s1, s2, std::greater<>()), expected);
+  expected.clear();
+  std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected), std::greater<>());
+  ASSERT_EQ(parlay::set_difference(s1, s2, std::greater<>()), expected);
+}
+
+TEST(TestPrimitives, TestSetOperationsTakeFromFirst) {
+  // Equal elements are compared by key only, and are taken from the first range
+  auto s1 = parlay::tabulate(50000, [](int i) { return std::make_pair(i / 2, 1); });
+  auto s2 = parlay::tabulate(50000, [](int i) { return std::make_pair(i, 2); });
+  auto less = [](const auto& a, const auto& b) { return a.first < b.first; };
+  auto u = parlay::set_union(s1, s2, less);
+  parlay::sequence<std::pair<int, int>> expected;
+  std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(), std::back_inserter(expected), less);
+  ASSERT_EQ(u, expected);
+  auto in = parlay::set_intersection(s1, s2, less);
+  ASSERT_EQ(in.size(), 25000);
+  for (size_t i = 0; i < in.size(); i++) {
+    ASSERT_EQ(in[i], std::make_pair((int) i, 1));
+  }
+}
+
 TEST(TestPrimitives, TestForEach) {
   parlay::sequence<int> a(100000);
   parlay::for_each(parlay::iota(100000), [&](auto&& i) {
@@ -875,4 +1071,91 @@ TEST(TestPrimitives, TestKthSmallestAllDuplicates) {
   auto result = parlay::kth_smallest(a, k);
   ASSERT_NE(result, a.end());
   ASSERT_EQ(*result, 1);
-}
\ No newline at end of file
+}
+TEST(TestPrimitives, TestTopK) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {0, 1, 10, 1000, 30000, 200000, 500000, 600000}) {
+    auto top = parlay::top_k(s, k);
+    ASSERT_EQ(top.size(), std::min<size_t>(k, s.size()));
+    for (size_t i = 0; i < top.size(); i++) {
+      ASSERT_EQ(top[i], sorted[i]);
+    }
+  }
+}
+
+TEST(TestPrimitives, TestTopKLargest) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (double) (parlay::hash64(i) % 1000000); });
+  auto sorted = parlay::sort(s, std::greater<>());
+  auto top = parlay::top_k(s, 1000, std::greater<>());
+  ASSERT_EQ(top, parlay::to_sequence(sorted.cut(0, 1000)));
+}
+
+TEST(TestPrimitives, TestTopKStableDuplicates) {
+  // Few distinct keys, so that the pivot has very many copies,
+  // which must be the first ones in the input
+  auto s = parlay::tabulate(500000, [](int i) { return std::make_pair((int) (parlay::hash64(i) % 5), i); });
+  auto less = [](const auto& a, const auto& b) { return a.first < b.first; };
+  auto sorted = parlay::stable_sort(s, less);
+  for (size_t k : {1, 100, 10000}) {
+    ASSERT_EQ(parlay::top_k(s, k, less), parlay::to_sequence(sorted.cut(0, k)));
+  }
+}
+
+TEST(TestPrimitives, TestPartialSort) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {0, 1, 10, 1000, 30000, 200000, 500000}) {
+    auto a = s;
+    parlay::partial_sort(a, k);
+    for (size_t i = 0; i < k; i++) {
+      ASSERT_EQ(a[i], sorted[i]);
+    }
+    ASSERT_EQ(parlay::sort(a), sorted);
+  }
+}
+
+TEST(TestPrimitives, TestPartialSortDuplicates) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (int) (parlay::hash64(i) % 3); });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {1, 1000, 20000}) {
+    auto a = s;
+    parlay::partial_sort(a, k, std::less<>());
+    ASSERT_EQ(parlay::to_sequence(a.cut(0, k)), parlay::to_sequence(sorted.cut(0, k)));
+    ASSERT_EQ(parlay::sort(a), sorted);
+  }
+}
+
+TEST(TestPrimitives, TestMultiSelect) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (long) (parlay::hash64(i) % 1000000); });
+  auto sorted = parlay::sort(s);
+  auto ranks = parlay::sequence<size_t>{499999, 0, 250000, 1, 12345, 12345, 400000};
+  auto selected = parlay::multi_select(s, ranks);
+  ASSERT_EQ(selected.size(), ranks.size());
+  for (size_t i = 0; i < ranks.size(); i++) {
+    ASSERT_EQ(selected[i], sorted[ranks[i]]);
+  }
+
+  // Every hundredth rank, i.e., percentiles
+  auto percentiles = parlay::tabulate(100, [](size_t i) { return i * 5000; });
+  auto p = parlay::multi_select(s, percentiles, std::greater<>());
+  for (size_t i = 0; i < 100; i++) {
+    ASSERT_EQ(p[i], sorted[s.size() - 1 - i * 5000]);
+  }
+}
+
+TEST(TestPrimitives, TestMultiSelectDuplicates) {
+  auto s = parlay::tabulate(500000, [](size_t i) { return (int) (parlay::hash64(i) % 10); });
+  auto sorted = parlay::sort(s);
+  auto ranks = parlay::tabulate(100, [](size_t i) { return i * 4999; });
+  auto selected = parlay::multi_select(s, ranks);
+  for (size_t i = 0; i < ranks.size(); i++) {
+    ASSERT_EQ(selected[i], sorted[ranks[i]]);
+  }
+}
+
+TEST(TestPrimitives, TestMultiSelectSmall) {
+  auto s = parlay::sequence<int>{5, 3, 9, 1, 7};
+  ASSERT_EQ(parlay::multi_select(s, parlay::sequence<int>{0, 4, 2}), (parlay::sequence<int>{1, 9, 5}));
+  ASSERT_EQ(parlay::multi_select(s, parlay::sequence<int>{}).size(), 0);
+}
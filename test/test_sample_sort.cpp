@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <deque>
 #include <numeric>
+#include <string>
 
 #include <parlay/primitives.h>
 #include <parlay/sequence.h>
@@ -128,3 +129,60 @@ TEST(TestSampleSort, TestSortInplaceNonContiguous) {
   ASSERT_EQ(s, s2);
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
+
+TEST(TestSampleSort, TestSortInplaceLowMemory) {
+  for (size_t n : {0, 1, 1000, 20000, 100000, 1000000}) {
+    auto uniform = parlay::tabulate(n, [](size_t i) -> long long { return static_cast<long long>(parlay::hash64(i)); });
+    auto few = parlay::tabulate(n, [](size_t i) -> long long { return static_cast<long long>(parlay::hash64(i) % 3); });
+    auto equal = parlay::sequence<long long>(n, 42);
+    auto sorted = parlay::tabulate(n, [](size_t i) -> long long { return static_cast<long long>(i); });
+    auto reversed = parlay::tabulate(n, [n](size_t i) -> long long { return static_cast<long long>(n - i); });
+    // Mostly unique keys, and a few keys that make up most of the input
+    auto skewed = parlay::tabulate(n, [](size_t i) -> long long {
+      return static_cast<long long>(i % 4 == 0 ? parlay::hash64(i) : parlay::hash64(i) % 10);
+    });
+    for (auto s : {uniform, few, equal, sorted, reversed, skewed}) {
+      auto s2 = s;
+      std::sort(std::begin(s2), std::end(s2));
+      parlay::sort_inplace(s, parlay::sort_mode::low_memory);
+      ASSERT_EQ(s, s2);
+    }
+  }
+}
+
+TEST(TestSampleSort, TestSortInplaceLowMemoryCustomCompare) {
+  auto s = parlay::tabulate(300000, [](long long i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto s2 = s;
+  parlay::sort_inplace(s, std::greater<long long>(), parlay::sort_mode::low_memory);
+  std::sort(std::rbegin(s2), std::rend(s2));
+  ASSERT_EQ(s, s2);
+
+  // Elements that are not trivially relocatable
+  auto strings = parlay::tabulate(200000, [](size_t i) { return std::to_string(parlay::hash64(i) % 50000); });
+  auto strings2 = strings;
+  parlay::sort_inplace(strings, parlay::sort_mode::low_memory);
+  std::sort(std::begin(strings2), std::end(strings2));
+  ASSERT_EQ(strings, strings2);
+}
+
+TEST(TestSampleSort, TestSortInplaceLowMemoryNonContiguous) {
+  auto ss = parlay::tabulate(100000, [](long long i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto s = std::deque<long long>(ss.begin(), ss.end());
+  auto s2 = s;
+  parlay::sort_inplace(s, parlay::sort_mode::low_memory);
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestSampleSort, TestSortInplaceLowMemoryUncopyable) {
+  // Uncopyable elements fall back to the standard algorithm
+  auto s = parlay::tabulate(100000, [](int i) -> UncopyableThing {
+    return UncopyableThing((50021 * i + 61) % (1 << 20));
+  });
+  parlay::sort_inplace(s, parlay::sort_mode::low_memory);
+  ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
+}
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <cmath>
+
+#include <parlay/monoid.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Offsets of segments whose lengths are drawn from a power-law
+// distribution, including many empty segments
+parlay::sequence<size_t> power_law_offsets(size_t n, size_t seed) {
+  parlay::sequence<size_t> offsets = {0};
+  for (size_t i = 0; offsets.back() < n; i++) {
+    double u = (parlay::hash64(seed * 1000003 + i) % 1000000 + 1) / 1000000.0;
+    size_t len = static_cast<size_t>(1.0 / std::pow(u, 1.0 / 0.8)) - 1;
+    offsets.push_back((std::min)(n, offsets.back() + len));
+  }
+  return offsets;
+}
+
+template<typename T, typename Offsets, typename Monoid>
+void check_offsets(const parlay::sequence<T>& s, const Offsets& offsets, Monoid m) {
+  auto reduced = parlay::segmented_reduce(s, offsets, m);
+  auto scanned = parlay::segmented_scan(s, offsets, m);
+  auto inclusive = parlay::segmented_scan_inclusive(s, offsets, m);
+  ASSERT_EQ(reduced.size(), offsets.size() - 1);
+  ASSERT_EQ(scanned.size(), s.size());
+  ASSERT_EQ(inclusive.size(), s.size());
+  for (size_t k = 0; k + 1 < offsets.size(); k++) {
+    T r = m.identity;
+    for (size_t i = offsets[k]; i < offsets[k + 1]; i++) {
+      ASSERT_EQ(scanned[i], r);
+      r = m(r, s[i]);
+      ASSERT_EQ(inclusive[i], r);
+    }
+    ASSERT_EQ(reduced[k], r);
+  }
+}
+
+template<typename T, typename Monoid>
+void check_flags(const parlay::sequence<T>& s, const parlay::sequence<bool>& flags, Monoid m) {
+  auto reduced = parlay::segmented_reduce(s, flags, m);
+  auto scanned = parlay::segmented_scan(s, flags, m);
+  auto inclusive = parlay::segmented_scan_inclusive(s, flags, m);
+  ASSERT_EQ(scanned.size(), s.size());
+  ASSERT_EQ(inclusive.size(), s.size());
+  size_t k = 0;
+  T r = m.identity;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (i > 0 && flags[i]) {
+      ASSERT_LT(k, reduced.size());
+      ASSERT_EQ(reduced[k++], r);
+      r = m.identity;
+    }
+    ASSERT_EQ(scanned[i], r);
+    r = m(r, s[i]);
+    ASSERT_EQ(inclusive[i], r);
+  }
+  if (!s.empty()) {
+    ASSERT_EQ(reduced[k++], r);
+  }
+  ASSERT_EQ(reduced.size(), k);
+}
+
+TEST(TestSegmentedOps, TestOffsets) {
+  for (size_t n : {1, 10, 1000, 100000, 1000000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> long { return static_cast<long>(parlay::hash64(i) % 100); });
+    check_offsets(s, power_law_offsets(n, n), parlay::plus<long>());
+    check_offsets(s, power_law_offsets(n, n), parlay::maximum<long>());
+  }
+}
+
+TEST(TestSegmentedOps, TestOffsetsExtremes) {
+  size_t n = 300000;
+  auto s = parlay::tabulate(n, [](size_t i) -> long { return static_cast<long>(parlay::hash64(i) % 100); });
+  // A single segment
+  check_offsets(s, parlay::sequence<size_t>{0, n}, parlay::plus<long>());
+  // Segments of length one
+  check_offsets(s, parlay::iota<size_t>(n + 1), parlay::plus<long>());
+  // Empty segments at both ends and around one huge segment
+  check_offsets(s, parlay::sequence<size_t>{0, 0, 0, 1, 1, 2, n - 1, n - 1, n, n}, parlay::plus<long>());
+  // Offsets of a different integer type
+  auto offsets = parlay::tabulate(n / 1000 + 1, [](size_t i) -> int { return static_cast<int>(i * 1000); });
+  auto reduced = parlay::segmented_reduce(s, offsets);
+  for (size_t k = 0; k < reduced.size(); k++) {
+    ASSERT_EQ(reduced[k], parlay::reduce(s.cut(offsets[k], offsets[k + 1])));
+  }
+}
+
+TEST(TestSegmentedOps, TestFlags) {
+  for (size_t n : {1, 10, 1000, 100000, 1000000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> long { return static_cast<long>(parlay::hash64(i) % 100); });
+    auto offsets = power_law_offsets(n, n + 1);
+    parlay::sequence<bool> flags(n, false);
+    for (size_t k = 0; k + 1 < offsets.size(); k++) {
+      if (offsets[k] < n) flags[offsets[k]] = true;
+    }
+    check_flags(s, flags, parlay::plus<long>());
+    check_flags(s, flags, parlay::minimum<long>());
+    // Position 0 always starts a segment
+    flags[0] = false;
+    check_flags(s, flags, parlay::plus<long>());
+    check_flags(s, parlay::sequence<bool>(n, false), parlay::plus<long>());
+    check_flags(s, parlay::sequence<bool>(n, true), parlay::plus<long>());
+  }
+}
+
+// The composition of affine functions x -> a*x + b (mod p), which is not commutative
+struct Affine {
+  long long a, b;
+  bool operator==(const Affine& other) const { return a == other.a && b == other.b; }
+};
+
+TEST(TestSegmentedOps, TestNonCommutative) {
+  const long long p = 1000000007;
+  auto compose = [p](const Affine& f, const Affine& g) {   // Apply f, then g
+    return Affine{f.a * g.a % p, (f.b * g.a + g.b) % p};
+  };
+  auto m = parlay::make_monoid(compose, Affine{1, 0});
+  size_t n = 500000;
+  auto s = parlay::tabulate(n, [](size_t i) -> Affine {
+    return Affine{static_cast<long long>((i * 7 + 3) % 1000), static_cast<long long>((i * 13 + 5) % 1000)};
+  });
+  auto offsets = power_law_offsets(n, 42);
+  check_offsets(s, offsets, m);
+  parlay::sequence<bool> flags(n, false);
+  for (size_t k = 0; k + 1 < offsets.size(); k++) {
+    if (offsets[k] < n) flags[offsets[k]] = true;
+  }
+  check_flags(s, flags, m);
+}
+
+TEST(TestSegmentedOps, TestEmpty) {
+  parlay::sequence<long> s;
+  ASSERT_EQ(parlay::segmented_reduce(s, parlay::sequence<size_t>{0}).size(), 0);
+  ASSERT_EQ(parlay::segmented_reduce(s, parlay::sequence<size_t>{0, 0, 0}), parlay::sequence<long>(2, 0));
+  ASSERT_EQ(parlay::segmented_reduce(s, parlay::sequence<bool>{}).size(), 0);
+  ASSERT_EQ(parlay::segmented_scan(s, parlay::sequence<size_t>{0, 0}).size(), 0);
+  ASSERT_EQ(parlay::segmented_scan_inclusive(s, parlay::sequence<bool>{}).size(), 0);
+}
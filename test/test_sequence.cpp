@@ -1,4 +1,5 @@
 #include <atomic>
+#include <cmath>
 #include <list>
 #include <memory>
 #include <vector>
@@ -51,6 +52,40 @@ TEST(TestSequence, TestFillConstruct) {
   }
 }
 
+// Sequences of zeros larger than the largest allocator pool are created from
+// fresh zero pages, which should not need to be touched, so the memory used
+// is only virtual. Only check on Linux, where this is guaranteed.
+#if defined(__linux__)
+TEST(TestSequence, TestHugeZeroConstruct) {
+  size_t n = 2 * parlay::internal::default_allocator_max_pool_size / sizeof(int64_t) + 1;
+  auto s = parlay::sequence<int64_t>(n);
+  ASSERT_EQ(s.size(), n);
+  ASSERT_EQ(s[0], 0);
+  ASSERT_EQ(s[n / 2], 0);
+  ASSERT_EQ(s[n - 1], 0);
+  s[n - 1] = 1;
+  ASSERT_EQ(s[n - 1], 1);
+
+  auto d = parlay::sequence<double>(n, 0.0);
+  ASSERT_EQ(d[n - 1], 0.0);
+
+  parlay::sequence<int64_t> r;
+  r.resize(n);
+  ASSERT_EQ(r.size(), n);
+  ASSERT_EQ(r[n - 1], 0);
+}
+#endif
+
+TEST(TestSequence, TestZeroFillConstruct) {
+  auto s = parlay::sequence<double>(100000, 0.0);
+  auto t = parlay::sequence<double>(100000, -0.0);
+  ASSERT_EQ(s.size(), 100000);
+  for (size_t i = 0; i < 100000; i++) {
+    ASSERT_EQ(s[i], 0.0);
+    ASSERT_TRUE(std::signbit(t[i]));
+  }
+}
+
 TEST(TestSequence, TestInitializerListConstruct) {
   auto s = parlay::sequence<int>{1,2,3,4,5,6,7,8,9,10};
   ASSERT_EQ(s.size(), 10);
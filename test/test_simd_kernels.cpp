@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include <parlay/monoid.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+#include <parlay/internal/simd_kernels.h>
+
+// Small integer values, so that floating point sums are exact regardless
+// of the order in which they are added
+template<typename T>
+parlay::sequence<T> make_input(size_t n) {
+  return parlay::tabulate(n, [](size_t i) -> T {
+    if constexpr (std::is_signed_v<T>) return static_cast<T>(static_cast<int>(parlay::hash64(i) % 7) - 3);
+    else return static_cast<T>(parlay::hash64(i) % 7);
+  });
+}
+
+template<typename T, typename F>
+T serial_reduce(const parlay::sequence<T>& s, size_t start, size_t end, F f) {
+  T r = s[start];
+  for (size_t i = start + 1; i < end; i++) r = f(r, s[i]);
+  return r;
+}
+
+#if defined(PARLAY_SIMD_KERNELS)
+
+// Runs f with each instruction set that the CPU supports
+template<typename F>
+void for_each_simd_level(F f) {
+  auto level = parlay::internal::detect_simd_level();
+  if (level == parlay::internal::simd_level::avx512) f(parlay::internal::simd_level::avx512);
+  if (level != parlay::internal::simd_level::none) f(parlay::internal::simd_level::avx2);
+}
+
+template<typename T>
+void check_kernels() {
+  using parlay::internal::simd_op;
+  using parlay::internal::simd_level;
+  auto s = make_input<T>(1000);
+  for_each_simd_level([&](simd_level level) {
+    auto reduce = [&](auto op, size_t start, size_t n) {
+      constexpr simd_op Op = decltype(op)::value;
+      return level == simd_level::avx512 ? parlay::internal::simd_reduce_avx512<Op>(s.data() + start, n)
+                                         : parlay::internal::simd_reduce_avx2<Op>(s.data() + start, n);
+    };
+    // Every alignment, and enough sizes to exercise every loop of the kernels
+    for (size_t start = 0; start < 17; start++) {
+      for (size_t n = 64; n < 200; n++) {
+        ASSERT_EQ(reduce(std::integral_constant<simd_op, simd_op::add>{}, start, n),
+                  serial_reduce(s, start, start + n, std::plus<>{}));
+        if constexpr (std::is_signed_v<T>) {
+          ASSERT_EQ(reduce(std::integral_constant<simd_op, simd_op::min>{}, start, n),
+                    serial_reduce(s, start, start + n, [](T a, T b) { return (std::min)(a, b); }));
+          ASSERT_EQ(reduce(std::integral_constant<simd_op, simd_op::max>{}, start, n),
+                    serial_reduce(s, start, start + n, [](T a, T b) { return (std::max)(a, b); }));
+        }
+      }
+    }
+
+    for (bool inclusive : {false, true}) {
+      for (size_t start = 0; start < 17; start++) {
+        for (size_t n = 0; n < 100; n++) {
+          parlay::sequence<T> out(n + 2, T(42));
+          T offset = T(5);
+          T total = level == simd_level::avx512
+              ? parlay::internal::simd_scan_add_avx512(s.data() + start, out.data() + 1, n, offset, inclusive)
+              : parlay::internal::simd_scan_add_avx2(s.data() + start, out.data() + 1, n, offset, inclusive);
+          T r = offset;
+          for (size_t i = 0; i < n; i++) {
+            if (inclusive) r = r + s[start + i];
+            ASSERT_EQ(out[i + 1], r);
+            if (!inclusive) r = r + s[start + i];
+          }
+          ASSERT_EQ(total, r);
+          ASSERT_EQ(out[0], T(42));
+          ASSERT_EQ(out[n + 1], T(42));
+        }
+      }
+    }
+  });
+}
+
+TEST(TestSimdKernels, TestKernelsInt) {
+  check_kernels<int32_t>();
+  check_kernels<uint32_t>();
+}
+
+TEST(TestSimdKernels, TestKernelsLong) {
+  check_kernels<int64_t>();
+  check_kernels<uint64_t>();
+}
+
+TEST(TestSimdKernels, TestKernelsFloat) {
+  check_kernels<float>();
+  check_kernels<double>();
+}
+
+#endif  // defined(PARLAY_SIMD_KERNELS)
+
+template<typename T>
+void check_primitives() {
+  auto s = make_input<T>(100000);
+  T sum = serial_reduce(s, 0, s.size(), std::plus<>{});
+  ASSERT_EQ(parlay::reduce(s), sum);
+  ASSERT_EQ(parlay::reduce(s, parlay::addm<T>()), sum);
+  ASSERT_EQ(parlay::reduce(s.cut(3, 99000)), serial_reduce(s, 3, 99000, std::plus<>{}));
+  ASSERT_EQ(parlay::reduce(s, parlay::maximum<T>()), *std::max_element(s.begin(), s.end()));
+  ASSERT_EQ(parlay::reduce(s, parlay::minm<T>()), *std::min_element(s.begin(), s.end()));
+
+  auto [scanned, total] = parlay::scan(s);
+  ASSERT_EQ(total, sum);
+  auto inclusive = parlay::scan_inclusive(s);
+  T r = 0;
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(scanned[i], r);
+    r = r + s[i];
+    ASSERT_EQ(inclusive[i], r);
+  }
+
+  auto t = s;
+  ASSERT_EQ(parlay::scan_inplace(t), sum);
+  ASSERT_EQ(t, scanned);
+}
+
+TEST(TestSimdKernels, TestPrimitives) {
+  check_primitives<int>();
+  check_primitives<unsigned int>();
+  check_primitives<long>();
+  check_primitives<unsigned long long>();
+  check_primitives<float>();
+  check_primitives<double>();
+}
+
+TEST(TestSimdKernels, TestOverflow) {
+  // Wraps around in the same way as the generic loops
+  auto s = parlay::sequence<unsigned int>(100000, std::numeric_limits<unsigned int>::max());
+  ASSERT_EQ(parlay::reduce(s), static_cast<unsigned int>(100000u * std::numeric_limits<unsigned int>::max()));
+  auto m = parlay::tabulate(100000, [](size_t i) -> long {
+    return (i % 2 == 0) ? std::numeric_limits<long>::max() - static_cast<long>(i) : std::numeric_limits<long>::lowest() + static_cast<long>(i);
+  });
+  ASSERT_EQ(parlay::reduce(m, parlay::maximum<long>()), std::numeric_limits<long>::max());
+  ASSERT_EQ(parlay::reduce(m, parlay::minimum<long>()), std::numeric_limits<long>::lowest() + 1);
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <parlay/primitives.h>
+#include <parlay/range.h>
+#include <parlay/sequence.h>
+#include <parlay/soa_sequence.h>
+
+static_assert(parlay::is_random_access_range_v<parlay::soa_sequence<int, double>>);
+static_assert(parlay::is_random_access_range_v<const parlay::soa_sequence<int, double>>);
+
+TEST(TestSoaSequence, TestConstruct) {
+  parlay::soa_sequence<int, double> empty;
+  ASSERT_TRUE(empty.empty());
+  ASSERT_EQ(empty.begin(), empty.end());
+
+  parlay::soa_sequence<int, double> s(100, {1, 2.5});
+  ASSERT_EQ(s.size(), 100);
+  ASSERT_EQ(s.end() - s.begin(), 100);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(std::get<0>(s[i]), 1);
+    ASSERT_EQ(std::get<1>(s[i]), 2.5);
+  }
+
+  parlay::soa_sequence<int, std::string> t(parlay::sequence<int>{1, 2, 3},
+                                          parlay::sequence<std::string>{"a", "b", "c"});
+  ASSERT_EQ(t.size(), 3);
+  t.push_back({4, "d"});
+  ASSERT_EQ(t.size(), 4);
+  ASSERT_EQ(t.column<0>(), (parlay::sequence<int>{1, 2, 3, 4}));
+  ASSERT_EQ(t.column<1>(), (parlay::sequence<std::string>{"a", "b", "c", "d"}));
+}
+
+TEST(TestSoaSequence, TestTuples) {
+  auto pairs = parlay::tabulate(100000, [](size_t i) { return std::make_pair(static_cast<int>(i), 2.0 * i); });
+  auto s = parlay::soa_sequence<int, double>::from_tuples(pairs);
+  ASSERT_EQ(s.size(), pairs.size());
+  ASSERT_EQ(s.column<0>(), parlay::map(pairs, [](auto p) { return p.first; }));
+  ASSERT_EQ(s.column<1>(), parlay::map(pairs, [](auto p) { return p.second; }));
+  auto t = s.to_tuples();
+  for (size_t i = 0; i < pairs.size(); i++) {
+    ASSERT_EQ(t[i], std::make_tuple(pairs[i].first, pairs[i].second));
+  }
+}
+
+TEST(TestSoaSequence, TestReferences) {
+  parlay::soa_sequence<int, long> s(1000);
+  auto [a, b] = s[10];
+  a = 5;
+  b = 7;
+  ASSERT_EQ(s.column<0>()[10], 5);
+  ASSERT_EQ(s.column<1>()[10], 7);
+
+  parlay::parallel_for(0, s.size(), [&](size_t i) {
+    auto [x, y] = s[i];
+    x = static_cast<int>(i);
+    y = 2 * static_cast<long>(i);
+  });
+  long i = 0;
+  for (auto [x, y] : s) {
+    ASSERT_EQ(x, i);
+    ASSERT_EQ(y, 2 * i);
+    i++;
+  }
+}
+
+TEST(TestSoaSequence, TestPrimitives) {
+  size_t n = 100000;
+  parlay::soa_sequence<int, long> s(parlay::tabulate(n, [](size_t i) { return static_cast<int>(i); }),
+                                    parlay::tabulate(n, [](size_t i) { return static_cast<long>(3 * i); }));
+
+  ASSERT_EQ(parlay::reduce(s.column<1>()), static_cast<long>(3 * (n * (n - 1) / 2)));
+  auto sums = parlay::map(s, [](auto t) { return std::get<0>(t) + std::get<1>(t); });
+  ASSERT_EQ(sums, parlay::tabulate(n, [](size_t i) { return static_cast<long>(4 * i); }));
+  auto firsts = parlay::map(s, [](auto t) { return std::get<0>(t); });
+  ASSERT_EQ(firsts, s.column<0>());
+}
+
+TEST(TestSoaSequence, TestSortBy) {
+  size_t n = 100000;
+  auto keys = parlay::tabulate(n, [](size_t i) { return static_cast<int>(parlay::hash64(i) % 1000); });
+  auto values = parlay::tabulate(n, [](size_t i) { return std::to_string(i); });
+  auto expected = parlay::stable_sort(parlay::zip(keys, values),
+                                      [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
+  parlay::soa_sequence<int, std::string> s(keys, values);
+  s.sort_by<0>();
+  ASSERT_EQ(s.to_tuples(), expected);
+
+  s.sort_by<0>(std::greater<>());
+  ASSERT_TRUE(std::is_sorted(s.column<0>().begin(), s.column<0>().end(), std::greater<>()));
+}
+
+TEST(TestSoaSequence, TestPermute) {
+  size_t n = 1000;
+  parlay::soa_sequence<int, std::string> s(parlay::tabulate(n, [](size_t i) { return static_cast<int>(i); }),
+                                           parlay::tabulate(n, [](size_t i) { return std::to_string(i); }));
+  auto idx = parlay::tabulate(n, [&](size_t i) { return n - i - 1; });
+  s.permute(idx);
+  for (size_t i = 0; i < n; i++) {
+    ASSERT_EQ(s[i], std::make_tuple(static_cast<int>(n - i - 1), std::to_string(n - i - 1)));
+  }
+}
@@ -1,8 +1,12 @@
 #include "gtest/gtest.h"
 
+#include <cstdint>
+
 #include <algorithm>
 #include <deque>
+#include <limits>
 #include <numeric>
+#include <string>
 #include <tuple>
 #include <utility>
 
@@ -169,6 +173,196 @@ TEST(TestSortingPrimitives, TestStableSortInplaceNonContiguous) {
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
 
+TEST(TestSortingPrimitives, TestSortSignedIntegers) {
+  for (size_t n : {10, 1000, 100000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> int {
+      return static_cast<int>(parlay::hash64(i) % 2000001) - 1000000;
+    });
+    s[0] = std::numeric_limits<int>::lowest();
+    s[n - 1] = (std::numeric_limits<int>::max)();
+    auto sorted = parlay::sort(s);
+    std::sort(std::begin(s), std::end(s));
+    ASSERT_EQ(s, sorted);
+  }
+  auto c = parlay::tabulate(100000, [](size_t i) -> signed char {
+    return static_cast<signed char>(parlay::hash64(i) % 256 - 128);
+  });
+  auto c_sorted = parlay::sort(c, std::less<signed char>());
+  std::sort(std::begin(c), std::end(c));
+  ASSERT_EQ(c, c_sorted);
+}
+
+TEST(TestSortingPrimitives, TestSortFloatingPoint) {
+  auto special = {0.0, -0.0, 1e-310, -1e-310, std::numeric_limits<double>::infinity(),
+                  -std::numeric_limits<double>::infinity(), (std::numeric_limits<double>::max)(),
+                  std::numeric_limits<double>::lowest()};
+  for (size_t n : {10, 1000, 100000}) {
+    auto s = parlay::tabulate(n, [&](size_t i) -> double {
+      if (i % 100 < special.size()) return special.begin()[i % 100];
+      return (static_cast<double>(parlay::hash64(i) % 1000000) - 500000.0) / 1000.0;
+    });
+    auto sorted = parlay::sort(s);
+    ASSERT_TRUE(std::is_sorted(std::begin(sorted), std::end(sorted)));
+    std::sort(std::begin(s), std::end(s));
+    ASSERT_EQ(s, sorted);
+  }
+  auto f = parlay::tabulate(100000, [](size_t i) -> float {
+    return static_cast<float>(static_cast<int>(parlay::hash64(i) % 20001) - 10000) / 3.0f;
+  });
+  auto f_sorted = parlay::sort(f);
+  std::sort(std::begin(f), std::end(f));
+  ASSERT_EQ(f, f_sorted);
+}
+
+TEST(TestSortingPrimitives, TestSortPairsAndTuples) {
+  auto p = parlay::tabulate(100000, [](size_t i) -> std::pair<int, int> {
+    return {static_cast<int>(parlay::hash64(i) % 1000) - 500, static_cast<int>(parlay::hash64(i + 1) % 2001) - 1000};
+  });
+  auto p_sorted = parlay::sort(p);
+  std::sort(std::begin(p), std::end(p));
+  ASSERT_EQ(p, p_sorted);
+
+  auto t = parlay::tabulate(100000, [](size_t i) -> std::tuple<short, float, unsigned char> {
+    return {static_cast<short>(parlay::hash64(i) % 100 - 50), static_cast<float>(parlay::hash64(i + 1) % 10) - 5.0f,
+            static_cast<unsigned char>(parlay::hash64(i + 2))};
+  });
+  auto t_sorted = parlay::sort(t);
+  std::sort(std::begin(t), std::end(t));
+  ASSERT_EQ(t, t_sorted);
+}
+
+TEST(TestSortingPrimitives, TestSortInplaceRadixKeys) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> double {
+    return (static_cast<double>(parlay::hash64(i) % 1000000) - 500000.0) / 7.0;
+  });
+  auto expected = s;
+  std::sort(std::begin(expected), std::end(expected));
+  for (auto mode : {parlay::sort_mode::standard, parlay::sort_mode::low_memory}) {
+    auto s2 = s;
+    parlay::sort_inplace(s2, mode);
+    ASSERT_EQ(s2, expected);
+  }
+  auto d = std::deque<double>(s.begin(), s.end());
+  parlay::sort_inplace(d);
+  ASSERT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
+}
+
+TEST(TestSortingPrimitives, TestRadixKey) {
+  static_assert(parlay::has_radix_key_v<int>);
+  static_assert(parlay::has_radix_key_v<const double&>);
+  static_assert(parlay::has_radix_key_v<std::pair<int, float>>);
+  static_assert(parlay::has_radix_key_v<std::tuple<short, short, int>>);
+  static_assert(!parlay::has_radix_key_v<bool>);
+  static_assert(!parlay::has_radix_key_v<std::pair<long, int>>);
+  static_assert(!parlay::has_radix_key_v<std::string>);
+  static_assert(std::is_same_v<parlay::radix_key_type_t<std::pair<int, short>>, uint64_t>);
+  static_assert(std::is_same_v<parlay::radix_key_type_t<float>, uint32_t>);
+
+  auto s = parlay::tabulate(100000, [](size_t i) -> std::pair<float, int> {
+    return {static_cast<float>(parlay::hash64(i) % 1000) - 500.0f, static_cast<int>(i)};
+  });
+  // Radix keys can also be used directly as the keys of an integer sort
+  auto sorted = parlay::stable_integer_sort(s, parlay::radix_key{});
+  std::stable_sort(std::begin(s), std::end(s));
+  ASSERT_EQ(s, sorted);
+}
+
+// -0.0 and 0.0 compare equal, so they must not decide the order of pairs
+TEST(TestSortingPrimitives, TestSortSignedZeros) {
+  auto s = parlay::tabulate(10000, [](size_t i) -> std::pair<float, float> {
+    return {(parlay::hash64(i) % 2 == 0) ? -0.0f : 0.0f, static_cast<float>(parlay::hash64(2 * i) % 1000)};
+  });
+  auto sorted = parlay::sort(s);
+  ASSERT_TRUE(std::is_sorted(std::begin(sorted), std::end(sorted)));
+  auto t = parlay::map(s, [](const auto& p) { return std::make_tuple(p.first, p.second); });
+  parlay::sort_inplace(s);
+  ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
+  parlay::sort_inplace(t);
+  ASSERT_TRUE(std::is_sorted(std::begin(t), std::end(t)));
+}
+
+#ifdef __SIZEOF_INT128__
+// Integers wider than 64 bits have no radix keys, so they are sorted by comparisons
+TEST(TestSortingPrimitives, TestSortInt128) {
+  static_assert(!parlay::has_radix_key_v<__int128>);
+  static_assert(!parlay::has_radix_key_v<unsigned __int128>);
+  auto s = parlay::tabulate(10000, [](size_t i) -> __int128 {
+    return (static_cast<__int128>(parlay::hash64(i) % 1000) << 64) - static_cast<__int128>(parlay::hash64(2 * i));
+  });
+  auto expected = s;
+  std::sort(std::begin(expected), std::end(expected));
+  auto sorted = parlay::sort(s);
+  ASSERT_TRUE(sorted == expected);
+  parlay::sort_inplace(s);
+  ASSERT_TRUE(s == expected);
+}
+#endif
+
+// Strings over a small alphabet with long shared prefixes and many duplicates
+static std::string make_test_string(size_t i) {
+  std::string s = (parlay::hash64(i) % 4 == 0) ? "http://www.example.com/" : "";
+  size_t len = parlay::hash64(2 * i + 1) % 12;
+  for (size_t j = 0; j < len; j++) {
+    s.push_back("ab\0\xff"[parlay::hash64(i * 31 + j) % 4]);
+  }
+  return s;
+}
+
+TEST(TestSortingPrimitives, TestStringSort) {
+  for (size_t n : {0, 1, 10, 1000, 100000}) {
+    auto s = parlay::tabulate(n, make_test_string);
+    auto sorted = parlay::string_sort(s);
+    std::sort(std::begin(s), std::end(s));
+    ASSERT_EQ(s, sorted);
+  }
+}
+
+TEST(TestSortingPrimitives, TestStringSortDelayed) {
+  auto s = parlay::delayed_tabulate(100000, make_test_string);
+  auto sorted = parlay::string_sort(s);
+  auto expected = parlay::to_sequence(s);
+  std::sort(std::begin(expected), std::end(expected));
+  ASSERT_EQ(expected, sorted);
+}
+
+TEST(TestSortingPrimitives, TestStringSortEqual) {
+  auto s = parlay::sequence<std::string>(100000, std::string(100, 'x'));
+  s[500] = std::string(99, 'x');
+  auto sorted = parlay::string_sort(s);
+  std::sort(std::begin(s), std::end(s));
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestSortingPrimitives, TestStringSortWithLcp) {
+  auto s = parlay::tabulate(100000, [](size_t i) {
+    auto str = make_test_string(i);
+    return parlay::chars(str.begin(), str.end());
+  });
+  auto [sorted, lcp] = parlay::string_sort_with_lcp(s);
+  ASSERT_EQ(sorted.size(), s.size());
+  ASSERT_EQ(lcp.size(), s.size());
+  ASSERT_EQ(lcp[0], 0);
+  for (size_t i = 1; i < sorted.size(); i++) {
+    auto a = std::string(sorted[i - 1].begin(), sorted[i - 1].end());
+    auto b = std::string(sorted[i].begin(), sorted[i].end());
+    ASSERT_LE(a, b);
+    size_t l = std::mismatch(a.begin(), a.begin() + (std::min)(a.size(), b.size()), b.begin()).first - a.begin();
+    ASSERT_EQ(lcp[i], l);
+  }
+}
+
+TEST(TestSortingPrimitives, TestStringSortInplace) {
+  auto s = parlay::tabulate(100000, make_test_string);
+  auto expected = s;
+  std::sort(std::begin(expected), std::end(expected));
+  parlay::string_sort_inplace(s);
+  ASSERT_EQ(s, expected);
+
+  auto d = std::deque<std::string>(expected.rbegin(), expected.rend());
+  parlay::string_sort_inplace(d);
+  ASSERT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
+}
+
 TEST(TestSortingPrimitives, TestIntegerSort) {
   auto s = parlay::tabulate(100000, [](unsigned long long i) -> unsigned long long {
     return (50021 * i + 61) % (1 << 20);
@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <parlay/primitives.h>
+#include <parlay/relocation.h>
+#include <parlay/sequence.h>
+
+#include <parlay/internal/streaming_store.h>
+
+// These tests are compiled with PARLAY_STREAMING_THRESHOLD=0 so that
+// streaming stores are used regardless of the size of the output
+
+TEST(TestStreamingStore, TestMemcpyAlignments) {
+  auto src = parlay::tabulate(1000, [](size_t i) -> unsigned char { return static_cast<unsigned char>(i * 7); });
+  for (size_t dest_offset = 0; dest_offset < 70; dest_offset += 3) {
+    for (size_t n : {0, 1, 15, 16, 31, 32, 33, 64, 100, 500}) {
+      parlay::sequence<unsigned char> dest(600, 0);
+      parlay::internal::streaming_memcpy(dest.data() + dest_offset, src.data() + 1, n);
+      ASSERT_EQ(std::memcmp(dest.data() + dest_offset, src.data() + 1, n), 0);
+      for (size_t i = 0; i < dest_offset; i++) ASSERT_EQ(dest[i], 0);
+      for (size_t i = dest_offset + n; i < dest.size(); i++) ASSERT_EQ(dest[i], 0);
+    }
+  }
+}
+
+TEST(TestStreamingStore, TestCopy) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long { return parlay::hash64(i); });
+  parlay::sequence<long> t(s.size());
+  parlay::copy(s, t);
+  ASSERT_EQ(s, t);
+
+  parlay::sequence<long> u(s.size() + 3);
+  parlay::copy(s.cut(5, s.size()), u.cut(3, u.size() - 5));
+  ASSERT_TRUE(std::equal(s.begin() + 5, s.end(), u.begin() + 3));
+}
+
+TEST(TestStreamingStore, TestRelocate) {
+  auto s = parlay::tabulate(100001, [](size_t i) -> int { return static_cast<int>(i); });
+  auto expected = s;
+  s.reserve(s.capacity() * 2);   // Relocates the elements into a new buffer
+  ASSERT_EQ(s, expected);
+}
+
+TEST(TestStreamingStore, TestSorts) {
+  // Enough elements, in enough buckets, to use the parallel bucket transpose
+  auto s = parlay::tabulate(2000000, [](size_t i) -> unsigned int { return parlay::hash64(i) % 1000000; });
+  auto sorted = parlay::integer_sort(s);
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+  ASSERT_EQ(parlay::sort(s), sorted);
+
+  auto values = parlay::tabulate(1000000, [](size_t i) -> uint64_t { return parlay::hash64(i); });
+  auto key = [](uint64_t x) -> uint64_t { return x % 256; };
+  auto by_key = parlay::stable_sort(values, [&](auto a, auto b) { return key(a) < key(b); });
+  ASSERT_EQ(parlay::integer_sort(values, key), by_key);
+  ASSERT_EQ(parlay::counting_sort(values, 256, key).first, by_key);
+}